@@ -6,8 +6,71 @@
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "core.h"
 
 GLuint LoadShaders(const char* vertex_file_path, const char* fragment_file_path);
+
+// Same as above, but injects the given #define lines right after the #version
+// directive of both stages so one source file can produce several variants.
+GLuint LoadShaders(const char* vertex_file_path, const char* fragment_file_path, const std::string& defines);
+
+// Compile-time feature set of one shader variant. Each field becomes a #define
+// and the whole set packs into a bitmask used as the program cache key.
+struct ShaderPermutation {
+    bool skinning = false;        // GPU_SKINNING
+    bool dualQuaternion = false;  // DUAL_QUATERNION
+    bool rigidSkinning = false;   // RIGID_SKINNING
+    bool instancedBones = false;  // INSTANCED_BONES
+    int maxInfluences = 4;        // MAX_INFLUENCES, 1-4
+    int pointLightCount = 1;      // POINT_LIGHT_COUNT, 0-7
+
+    // bit 0 skinning, bit 1 dual quaternion, bit 2 rigid,
+    // bits 3-4 maxInfluences - 1, bits 5-7 point light count, bit 8 instanced bones.
+    unsigned int key() const;
+    std::string defines() const;
+};
+
+// Lazily compiles shader permutations of one vertex/fragment pair and keeps
+// them keyed by permutation bitmask. Linked programs are written to disk with
+// glGetProgramBinary and reloaded on later launches when the driver and
+// sources are unchanged.
+class ShaderLibrary {
+public:
+    static ShaderLibrary& getInstance();
+
+    void initialize(const std::string& vertexPath, const std::string& fragmentPath,
+        const std::string& cacheDirectory = "shader_cache");
+
+    // Returns the program for the permutation, compiling it on first use.
+    GLuint getProgram(const ShaderPermutation& permutation);
+
+    // Delete all programs so they are rebuilt from source on next use.
+    void invalidate();
+    // Rebuild after the sources changed: the base permutation is compiled
+    // first and only if it builds are the cached programs invalidated. Returns
+    // the new base program, or 0 with the old programs kept.
+    GLuint reload();
+    void cleanup();
+
+    size_t getProgramCount() const { return programs.size(); }
+    int getBinaryCacheHits() const { return binaryCacheHits; }
+
+private:
+    std::string vertexPath, fragmentPath, cacheDirectory;
+    std::unordered_map<unsigned int, GLuint> programs;
+    int binaryCacheHits = 0;
+
+    bool binarySupported() const;
+    unsigned long long sourceHash(const std::string& defines) const;
+    std::string binaryPath(unsigned int key) const;
+    GLuint loadBinary(unsigned int key, unsigned long long hash) const;
+    void saveBinary(unsigned int key, unsigned long long hash, GLuint program) const;
+};
+
+// Normal matrix for a model matrix; computed once per draw instead of per vertex.
+inline glm::mat3 computeNormalMatrix(const glm::mat4& model) {
+    return glm::transpose(glm::inverse(glm::mat3(model)));
+}
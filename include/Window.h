@@ -9,6 +9,8 @@
 #include <string>
 #include "../src/ImGuiController.h"
 #include "../src/ClothManager.h"
+#include "../src/AssetLoader.h"
+#include "../src/HotReloader.h"
 
 class Window {
 public:
@@ -22,24 +24,43 @@ public:
     static std::unique_ptr<SkeletonManager> skeletonManager;
     static std::unique_ptr<ClothManager> clothManager;
 
+    // Assets parsing in the background since beginLoadingAssets()
+    static std::unique_ptr<AssetLoader> assetLoader;
+    static std::future<std::unique_ptr<Skeleton>> pendingSkeleton;
+    static std::future<std::unique_ptr<Skin>> pendingSkin;
+    static std::future<std::unique_ptr<AnimationClip>> pendingAnim;
+
+    // Watches the loaded assets and the shaders once startHotReload() is called
+    static std::unique_ptr<HotReloader> hotReloader;
+
     // ImGui
     //static std::unique_ptr<ImGuiController> ImGuiController::instance;
     //static std::once_flag ImGuiController::initFlag;
 
 
-    // Shader Program
+    // Shader Program: base permutation; renderers fetch other variants from ShaderLibrary
     static GLuint shaderProgram;
 
     // Act as Constructors and desctructors
     static bool initializeProgram();
     static bool initializeObjects();
+    // Start parsing the skeleton assets on worker threads, so they load while
+    // the window and shaders are created; initializeSkeletonSystem collects them.
+    static void beginLoadingAssets(const std::string& skel_file, const std::string& skin_file, const std::string& anim_file);
     static bool initializeSkeletonSystem(std::string skel_file);
     static bool initializeSkeletonSystem(std::string skel_file, std::string skin_file, std::string anim_file);
     static bool initializeImGui(GLFWwindow*);
-    static bool initializeClothSystem();
+    // meshFile: optional .skin whose triangles become the cloth, with the
+    // listed vertices pinned; a rectangular cloth otherwise.
+    static bool initializeClothSystem(const std::string& meshFile = "", const std::vector<int>& pinned = {});
 
     static void cleanUp();
 
+    // Start watching the assets loaded so far and the shader sources; edited
+    // files are re-parsed in the background and swapped in by applyHotReloads.
+    static bool startHotReload();
+    static void applyHotReloads();
+
     // for the Window
     static GLFWwindow* createWindow(int width, int height);
     static void resizeCallback(GLFWwindow* window, int width, int height);
@@ -48,7 +69,7 @@ public:
     static void idleCallback();
     static void displayCallback(GLFWwindow*);
 
-    // fixed update for physical engine
+    // physics update, once per frame with the frame time
     static void fixedCallback(float dt);
 
     // helper to reset the camera
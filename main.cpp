@@ -1,6 +1,13 @@
 #include "Window.h"
 #include "core.h"
+#include "src/Benchmarks.h"
+#include "src/AnimationClip.h"
+#include "src/StreamingClip.h"
 #include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <chrono>
+#include <cstdio>
 
 #define ENABLE_SKELETON_SYSTEM true
 
@@ -47,15 +54,67 @@ void print_versions() {
 }
 
 int main(int argc, char** argv) {
+    // Headless benchmarks run without a window or GL context.
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "-bench") {
+            std::string name = i + 1 < argc ? argv[i + 1] : "all";
+            exit(Benchmarks::run(name) ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+        // Convert a clip for streaming playback: -convertanim in.anim out.sclip [window seconds]
+        if (std::string(argv[i]) == "-convertanim" && i + 2 < argc) {
+            AnimationClip clip;
+            float window = i + 3 < argc ? (float)std::atof(argv[i + 3]) : 1.0f;
+            bool converted = clip.Load(argv[i + 1]) && StreamingClip::convert(clip, argv[i + 2], window);
+            if (converted) std::cout << "Wrote " << argv[i + 2] << std::endl;
+            exit(converted ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+    }
+
+    // Skeleton assets parse on worker threads while the window is created
+    // and the shaders compile; initializeSkeletonSystem waits for them.
+    auto startupBegin = std::chrono::steady_clock::now();
+    if (ENABLE_SKELETON_SYSTEM) {
+        std::string skel_file = "test.skel", skin_file, anim_file;
+        for (int i = 1; i + 1 < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "-skel") skel_file = argv[++i];
+            else if (arg == "-skin") skin_file = argv[++i];
+            else if (arg == "-anim") anim_file = argv[++i];
+        }
+        Window::beginLoadingAssets(skel_file, skin_file, anim_file);
+    }
+
     // Create the GLFW window.
     GLFWwindow* window = Window::createWindow(1200, 1000);
     if (!window) exit(EXIT_FAILURE);
 
+    // Initialize the shader program; exit if initialization fails.
+    auto shaderBegin = std::chrono::steady_clock::now();
+    if (!Window::initializeProgram()) exit(EXIT_FAILURE);
+    double shaderMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - shaderBegin).count();
+
+    // Optional cloth mesh: -clothmesh file.skin [-pin 0,12,40]
+    std::string cloth_mesh_filename;
+    std::vector<int> cloth_pinned;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::string(argv[i]) == "-clothmesh") {
+            cloth_mesh_filename = argv[++i];
+        }
+        else if (std::string(argv[i]) == "-pin") {
+            std::stringstream list(argv[++i]);
+            std::string index;
+            while (std::getline(list, index, ',')) {
+                if (!index.empty()) cloth_pinned.push_back(std::atoi(index.c_str()));
+            }
+        }
+    }
+
     if (ENABLE_SKELETON_SYSTEM) {
         std::string skel_filename, skin_filename, anim_filename;
         bool skel_provided = false;
         bool skin_provided = false;
         bool anim_provided = false;
+        bool cloth_requested = false;
 
         for (int i = 1; i < argc; ++i) {
             if (std::string(argv[i]) == "-skel" && i + 1 < argc) {
@@ -73,6 +132,9 @@ int main(int argc, char** argv) {
                 anim_provided = true;
                 ++i;
             }
+            if (std::string(argv[i]) == "-cloth" || std::string(argv[i]) == "-clothmesh") {
+                cloth_requested = true;
+            }
 
         }
 
@@ -92,9 +154,14 @@ int main(int argc, char** argv) {
 
         std::cout << "Loaded file: " << skel_filename << std::endl;
 
+        // Optional cloth that collides with the skinned character.
+        if (cloth_requested && !Window::initializeClothSystem(cloth_mesh_filename, cloth_pinned)) {
+            exit(EXIT_FAILURE);
+        }
+
     }
     else {
-        if (!Window::initializeClothSystem()) {
+        if (!Window::initializeClothSystem(cloth_mesh_filename, cloth_pinned)) {
             exit(EXIT_FAILURE);
         }
     }
@@ -109,14 +176,23 @@ int main(int argc, char** argv) {
     // Setup OpenGL settings.
     setup_opengl_settings();
 
-    // Initialize the shader program; exit if initialization fails.
-    if (!Window::initializeProgram()) exit(EXIT_FAILURE);
     // Initialize objects/pointers for rendering; exit if initialization fails.
     if (!Window::initializeObjects()) exit(EXIT_FAILURE);
 
-    // Add fixed delta time for fixed update loop
-    float fixedDeltaTime = 0.004f; // Fixed update timestep (~240 updates per second)
-    float accumulator = 0.0f;
+    printf("Startup took %.1f ms (shaders %.1f ms)\n",
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startupBegin).count(), shaderMs);
+
+    // Edited assets and shaders are reloaded while running unless -nohotreload.
+    bool hotReload = true;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "-nohotreload") hotReload = false;
+    }
+    if (hotReload && !Window::startHotReload()) {
+        std::cerr << "Warning: hot reload could not start; edited assets and shaders will not be reloaded" << std::endl;
+    }
+
+    // Physics advances by the frame time once per frame; the cloth step
+    // controller picks the substeps from the cloth's stiffness and a CPU budget.
     float lastTime = glfwGetTime();
 
     // Loop while GLFW window should stay open.
@@ -125,12 +201,8 @@ int main(int argc, char** argv) {
         float currentTime = glfwGetTime();
         float deltaTime = currentTime - lastTime;
         lastTime = currentTime;
-        accumulator += deltaTime;
 
-        while (accumulator >= fixedDeltaTime) {
-            Window::fixedCallback(fixedDeltaTime);
-            accumulator -= fixedDeltaTime;
-        }
+        Window::fixedCallback(deltaTime);
 
         // Main render display callback. Rendering of objects is done here.
         Window::displayCallback(window);
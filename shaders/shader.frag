@@ -21,7 +21,13 @@ struct PointLight {
     float intensity;
 };
 
-uniform PointLight pointLight;
+#ifndef POINT_LIGHT_COUNT
+#define POINT_LIGHT_COUNT 1
+#endif
+
+#if POINT_LIGHT_COUNT > 0
+uniform PointLight pointLights[POINT_LIGHT_COUNT];
+#endif
 uniform Material material;
 uniform DirectionalLight dirLight;
 uniform vec3 CameraPos; // ۲λ
@@ -63,22 +69,29 @@ void main()
     // ==============================
     // Point Light 
     // ==============================
-    vec3 pointLightDir = normalize(pointLight.position - fragPosition);
-    float r = length(pointLight.position - fragPosition);
-    float r2 = r * r;
-    // 
-    float pointDiff = max(dot(norm, pointLightDir), 0.0);
-    vec3 pointDiffuse = pointDiff * pointLight.color * material.diffuse * pointLight.intensity / r2;
-
-    // ߹ (Blinn-Phong)
-    vec3 pointHalfDir = normalize(viewDir + pointLightDir);
-    float pointSpec = pow(max(dot(norm, pointHalfDir), 0.0), material.shininess);
-    vec3 pointSpecular = pointSpec * material.specular * pointLight.color * pointLight.intensity / r2;
-
-    vec3 pointLightColor = pointDiffuse;
-    if (pointDiff > 0) {
-        pointLightColor += pointSpecular;
+    vec3 pointLightColor = vec3(0.0);
+#if POINT_LIGHT_COUNT > 0
+    for (int i = 0; i < POINT_LIGHT_COUNT; ++i) {
+        PointLight pointLight = pointLights[i];
+        vec3 pointLightDir = normalize(pointLight.position - fragPosition);
+        float r = length(pointLight.position - fragPosition);
+        float r2 = r * r;
+        // 
+        float pointDiff = max(dot(norm, pointLightDir), 0.0);
+        vec3 pointDiffuse = pointDiff * pointLight.color * material.diffuse * pointLight.intensity / r2;
+
+        // ߹ (Blinn-Phong)
+        vec3 pointHalfDir = normalize(viewDir + pointLightDir);
+        float pointSpec = pow(max(dot(norm, pointHalfDir), 0.0), material.shininess);
+        vec3 pointSpecular = pointSpec * material.specular * pointLight.color * pointLight.intensity / r2;
+
+        if (pointDiff > 0) {
+            pointLightColor += pointDiffuse + pointSpecular;
+        } else {
+            pointLightColor += pointDiffuse;
+        }
     }
+#endif
 
     // ==============================
     // ϲ (Directional + Point)
@@ -2,53 +2,143 @@
 
 layout(location = 0) in vec3 position;
 layout(location = 1) in vec3 normal;
-layout(location = 2) in ivec4 jointIndices; // ʹ4int8
+#ifdef GPU_SKINNING
+layout(location = 2) in ivec4 jointIndices; // 16-bit indices, 0xFFFF = unused
 layout(location = 3) in vec3 weights;       // Զ׼[0,1]
+#endif
+#ifdef INSTANCED_BONES
+// Per-instance joint box and world matrix; the mesh is a unit cube in [0,1]^3.
+layout(location = 4) in vec3 instanceBoxMin;
+layout(location = 5) in vec3 instanceBoxMax;
+layout(location = 6) in mat4 instanceModel;
+#endif
 
 uniform mat4 viewProj;
 uniform mat4 model;
+uniform mat3 normalMatrix; // transpose(inverse(mat3(model))), computed per draw on the CPU
 
 out vec3 fragNormal;
 out vec3 fragPosition;
 
-uniform mat4 jointMatrices[150]; 
+#ifdef GPU_SKINNING
+// Skinning palette in a texture buffer shared by all skinned meshes:
+// 4 RGBA32F texels per joint matrix, or 2 (real, dual) with DUAL_QUATERNION.
+uniform samplerBuffer jointPalette;
+uniform int paletteOffset;
+uniform int jointCount;
 
-uniform bool useGPUSkinning;     
+// Permutation defines: DUAL_QUATERNION, RIGID_SKINNING (skin matrices are
+// rotation + translation only) and MAX_INFLUENCES (joints read per vertex).
+#ifndef MAX_INFLUENCES
+#define MAX_INFLUENCES 4
+#endif
 
-void main() {
-    if(useGPUSkinning) {
-        mat4 skinMatrix = mat4(0.0);
-        float totalWeight = 0.0;
-    
-        for(int i = 0; i < 4; ++i) {
-            if(jointIndices[i] == 0xFF || 
-               jointIndices[i] >= 150) 
-                break;
-        
-            float weight = (i == 3) ? 
-                (1.0 - (weights.x + weights.y + weights.z)) : 
-                weights[i];
-            
-            skinMatrix += jointMatrices[jointIndices[i]] * weight;
-            totalWeight += weight;
-        }
-    
-        if(totalWeight > 0.0) {
-            skinMatrix /= totalWeight;
-        }
-
-        vec4 skinnedPos = skinMatrix * vec4(position, 1.0);
-        vec3 skinnedNormal = mat3(transpose(inverse(skinMatrix))) * normal;
-
-        vec4 worldPos = model * skinnedPos;
-        gl_Position = viewProj * worldPos;
-    
-        fragPosition = vec3(worldPos);
-        fragNormal = normalize(mat3(transpose(inverse(model))) * skinnedNormal);
+float influenceWeight(int i) {
+    return (i == 3) ? (1.0 - (weights.x + weights.y + weights.z)) : weights[i];
+}
+
+bool validInfluence(int i) {
+    return jointIndices[i] != 0xFFFF && jointIndices[i] < jointCount;
+}
+
+#ifdef DUAL_QUATERNION
+vec3 quatRotate(vec4 q, vec3 v) {
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+// Dual quaternion skinning: blend, normalize, then a rigid transform.
+// No matrix inverse is needed since the blended transform is a rotation.
+void skinVertex(out vec3 skinnedPos, out vec3 skinnedNormal) {
+    vec4 real = vec4(0.0);
+    vec4 dual = vec4(0.0);
+    vec4 pivot = vec4(0.0, 0.0, 0.0, 1.0);
+
+    for(int i = 0; i < MAX_INFLUENCES; ++i) {
+        if(!validInfluence(i)) 
+            break;
+
+        int base = paletteOffset + jointIndices[i] * 2;
+        vec4 r = texelFetch(jointPalette, base);
+        vec4 d = texelFetch(jointPalette, base + 1);
+        if(i == 0) pivot = r;
+
+        float weight = influenceWeight(i);
+        if(dot(r, pivot) < 0.0) weight = -weight;
+        real += r * weight;
+        dual += d * weight;
+    }
+
+    float len = length(real);
+    if(len > 0.0) {
+        real /= len;
+        dual /= len;
     } else {
-        vec4 worldPos = model * vec4(position, 1.0);
-        gl_Position = viewProj * worldPos;
-        fragPosition = vec3(worldPos);
-        fragNormal = normalize(mat3(transpose(inverse(model))) * normal);
+        real = vec4(0.0, 0.0, 0.0, 1.0);
     }
+
+    vec3 t = 2.0 * (real.w * dual.xyz - dual.w * real.xyz + cross(real.xyz, dual.xyz));
+    skinnedPos = quatRotate(real, position) + t;
+    skinnedNormal = quatRotate(real, normal);
+}
+#else
+mat4 fetchJointMatrix(int joint) {
+    int base = paletteOffset + joint * 4;
+    return mat4(texelFetch(jointPalette, base),
+                texelFetch(jointPalette, base + 1),
+                texelFetch(jointPalette, base + 2),
+                texelFetch(jointPalette, base + 3));
+}
+
+// Linear blend skinning: blend matrices, then transform position and normal.
+void skinVertex(out vec3 skinnedPos, out vec3 skinnedNormal) {
+    mat4 skinMatrix = mat4(0.0);
+    float totalWeight = 0.0;
+
+    for(int i = 0; i < MAX_INFLUENCES; ++i) {
+        if(!validInfluence(i)) 
+            break;
+        
+        float weight = influenceWeight(i);
+        skinMatrix += fetchJointMatrix(jointIndices[i]) * weight;
+        totalWeight += weight;
+    }
+
+    if(totalWeight > 0.0) {
+        skinMatrix /= totalWeight;
+    }
+
+    skinnedPos = vec3(skinMatrix * vec4(position, 1.0));
+#ifdef RIGID_SKINNING
+    // With rigid joints the blended matrix is close to a rotation; the final
+    // normalize absorbs its scale, so the per-vertex inverse is skipped.
+    skinnedNormal = mat3(skinMatrix) * normal;
+#else
+    skinnedNormal = mat3(transpose(inverse(skinMatrix))) * normal;
+#endif
+}
+#endif
+#endif
+
+void main() {
+#ifdef GPU_SKINNING
+    vec3 skinnedPos;
+    vec3 skinnedNormal;
+    skinVertex(skinnedPos, skinnedNormal);
+
+    vec4 worldPos = model * vec4(skinnedPos, 1.0);
+    gl_Position = viewProj * worldPos;
+    fragPosition = vec3(worldPos);
+    fragNormal = normalize(normalMatrix * skinnedNormal);
+#elif defined(INSTANCED_BONES)
+    vec3 localPos = mix(instanceBoxMin, instanceBoxMax, position);
+    vec4 worldPos = model * instanceModel * vec4(localPos, 1.0);
+    gl_Position = viewProj * worldPos;
+    fragPosition = vec3(worldPos);
+    fragNormal = normalize(normalMatrix * mat3(instanceModel) * normal);
+#else
+    vec4 worldPos = model * vec4(position, 1.0);
+    gl_Position = viewProj * worldPos;
+    fragPosition = vec3(worldPos);
+    fragNormal = normalize(normalMatrix * normal);
+#endif
 }
@@ -0,0 +1,68 @@
+// AllocationCounter.cpp
+#include "AllocationCounter.h"
+
+#ifdef BENCHMARK_ALLOCATION_COUNTING
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<size_t> allocationCount{ 0 };
+
+namespace {
+    void* allocateAligned(size_t size, std::align_val_t alignment) {
+        const size_t align = static_cast<size_t>(alignment);
+#ifdef _WIN32
+        return _aligned_malloc(size ? size : 1, align);
+#else
+        // aligned_alloc wants a multiple of the alignment.
+        return std::aligned_alloc(align, ((size ? size : 1) + align - 1) / align * align);
+#endif
+    }
+
+    void freeAligned(void* p) {
+#ifdef _WIN32
+        _aligned_free(p);
+#else
+        std::free(p);
+#endif
+    }
+}
+
+// operator new[] and the nothrow forms call these, so they are counted too.
+void* operator new(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = allocateAligned(size, alignment)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    freeAligned(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept {
+    freeAligned(p);
+}
+
+bool AllocationCounter::isEnabled() { return true; }
+size_t AllocationCounter::getCount() { return allocationCount.load(std::memory_order_relaxed); }
+
+#else
+
+bool AllocationCounter::isEnabled() { return false; }
+size_t AllocationCounter::getCount() { return 0; }
+
+#endif
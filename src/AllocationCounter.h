@@ -0,0 +1,14 @@
+// AllocationCounter.h
+#pragma once
+
+#include <cstddef>
+
+// Heap allocations made anywhere in the program, for benchmarks that check a
+// steady-state loop does not allocate. Counting replaces the global operator
+// new, so it is only compiled in when AllocationCounter.cpp is built with
+// BENCHMARK_ALLOCATION_COUNTING (a benchmark build); in the shipped program
+// isEnabled() is false and the count stays 0.
+namespace AllocationCounter {
+    bool isEnabled();
+    size_t getCount();
+}
@@ -0,0 +1,178 @@
+// AnimationBlender.cpp
+#include "AnimationBlender.h"
+#include <algorithm>
+#include <cmath>
+
+void PosePool::reset(size_t joints, size_t capacity) {
+    jointCount = joints;
+    growCount = 0;
+    storage.clear();
+    available.clear();
+    storage.reserve(capacity);
+    available.reserve(capacity);
+    for (size_t i = 0; i < capacity; ++i) {
+        storage.push_back(std::make_unique<AnimationPose>());
+        storage.back()->rotations.resize(jointCount);
+        available.push_back(storage.back().get());
+    }
+}
+
+AnimationPose* PosePool::acquire() {
+    if (available.empty()) {
+        ++growCount;
+        storage.push_back(std::make_unique<AnimationPose>());
+        storage.back()->rotations.resize(jointCount);
+        available.reserve(storage.capacity());
+        return storage.back().get();
+    }
+    AnimationPose* pose = available.back();
+    available.pop_back();
+    return pose;
+}
+
+void PosePool::release(AnimationPose* pose) {
+    if (pose) available.push_back(pose);
+}
+
+BlendEntry* AnimationLayer::findOrAdd(const AnimationClip* clip) {
+    for (BlendEntry& entry : entries) {
+        if (entry.clip == clip) return &entry;
+    }
+    if (entries.size() == MAX_ENTRIES) {
+        // Make room by dropping the faintest entry.
+        auto faintest = std::min_element(entries.begin(), entries.end(),
+            [](const BlendEntry& a, const BlendEntry& b) { return a.weight < b.weight; });
+        entries.erase(faintest);
+    }
+    BlendEntry entry;
+    entry.clip = clip;
+    entry.time = clip ? clip->rangeStart : 0.0f;
+    entries.push_back(entry);
+    return &entries.back();
+}
+
+void AnimationLayer::crossfade(const AnimationClip* clip, float duration, float speed) {
+    float rate = duration > 0.0f ? 1.0f / duration : 0.0f;
+    for (BlendEntry& entry : entries) {
+        entry.targetWeight = 0.0f;
+        entry.fadeRate = rate;
+    }
+    BlendEntry* entry = findOrAdd(clip);
+    entry->targetWeight = 1.0f;
+    entry->fadeRate = rate;
+    entry->speed = speed;
+    if (entries.size() == 1) entry->weight = 1.0f;  // nothing to fade from
+}
+
+void AnimationLayer::setClipWeight(const AnimationClip* clip, float clipWeight, float duration) {
+    BlendEntry* entry = findOrAdd(clip);
+    entry->targetWeight = clipWeight;
+    entry->fadeRate = duration > 0.0f ? std::abs(clipWeight - entry->weight) / duration : 0.0f;
+}
+
+void AnimationLayer::setMask(Skeleton& skeleton, const Joint* joint, float jointWeight) {
+    const auto& joints = skeleton.getJointList();
+    if (mask.size() != joints.size()) mask.assign(joints.size(), 1.0f);
+    for (size_t i = 0; i < joints.size(); ++i) {
+        for (const Joint* j = joints[i].get(); j; j = j->parent) {
+            if (j == joint) {
+                mask[i] = jointWeight;
+                break;
+            }
+        }
+    }
+}
+
+void AnimationLayer::update(float dt) {
+    for (BlendEntry& entry : entries) {
+        if (entry.fadeRate <= 0.0f) {
+            entry.weight = entry.targetWeight;
+        }
+        else if (entry.weight < entry.targetWeight) {
+            entry.weight = std::min(entry.weight + entry.fadeRate * dt, entry.targetWeight);
+        }
+        else {
+            entry.weight = std::max(entry.weight - entry.fadeRate * dt, entry.targetWeight);
+        }
+
+        if (!entry.clip) continue;
+        entry.time += entry.speed * dt;
+        float period = entry.clip->rangeEnd - entry.clip->rangeStart;
+        if (entry.time > entry.clip->rangeEnd) {
+            entry.time = period > 0.0f ? entry.clip->rangeStart + std::fmod(entry.time - entry.clip->rangeStart, period)
+                                       : entry.clip->rangeStart;
+        }
+    }
+    // Faded-out clips leave the tree; erase keeps the reserved capacity.
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+        [](const BlendEntry& entry) { return entry.weight <= 0.0f && entry.targetWeight <= 0.0f; }), entries.end());
+}
+
+void AnimationBlender::initialize(Skeleton& skeleton, size_t layerCount) {
+    const auto& joints = skeleton.getJointList();
+    restPose.rootTranslation = glm::vec3(0.0f);
+    restPose.rotations.resize(joints.size());
+    for (size_t i = 0; i < joints.size(); ++i) restPose.rotations[i] = glm::quat(joints[i]->orginalPos);
+
+    // Result, one pose per layer and one clip sample at a time.
+    pool.reset(joints.size(), layerCount + 2);
+    result = nullptr;
+    layers.assign(layerCount, AnimationLayer());
+    for (AnimationLayer& layer : layers) layer.entries.reserve(AnimationLayer::MAX_ENTRIES);
+}
+
+void AnimationBlender::update(float dt) {
+    for (AnimationLayer& layer : layers) layer.update(dt);
+}
+
+void AnimationBlender::blendInto(AnimationPose& from, const AnimationPose& to, float t, const std::vector<float>* mask, bool translation) {
+    const size_t count = from.rotations.size();
+    for (size_t j = 0; j < count; ++j) {
+        float w = mask ? t * (*mask)[j] : t;
+        if (w <= 0.0f) continue;
+        from.rotations[j] = w >= 1.0f ? to.rotations[j] : glm::slerp(from.rotations[j], to.rotations[j], w);
+    }
+    if (translation) from.rootTranslation = glm::mix(from.rootTranslation, to.rootTranslation, t);
+}
+
+const AnimationPose& AnimationBlender::evaluate() {
+    if (!result) result = pool.acquire();
+    result->rootTranslation = restPose.rootTranslation;
+    std::copy(restPose.rotations.begin(), restPose.rotations.end(), result->rotations.begin());
+
+    AnimationPose* layerPose = pool.acquire();
+    AnimationPose* sample = pool.acquire();
+    for (AnimationLayer& layer : layers) {
+        // Normalized weighted blend of the entries, done as running slerps:
+        // each entry pulls the blend by its share of the weight so far.
+        float total = 0.0f;
+        for (const BlendEntry& entry : layer.entries) {
+            if (entry.weight <= 0.0f || !entry.clip) continue;
+            total += entry.weight;
+            if (total == entry.weight) {
+                entry.clip->Evaluate(entry.time, *layerPose);
+            }
+            else {
+                entry.clip->Evaluate(entry.time, *sample);
+                blendInto(*layerPose, *sample, entry.weight / total, nullptr, true);
+            }
+        }
+        if (total <= 0.0f || layer.weight <= 0.0f) continue;
+
+        const bool masked = layer.mask.size() == result->rotations.size();
+        blendInto(*result, *layerPose, layer.weight * std::min(total, 1.0f), masked ? &layer.mask : nullptr, layer.rootMotion);
+    }
+    pool.release(sample);
+    pool.release(layerPose);
+    return *result;
+}
+
+void AnimationBlender::apply(std::vector<std::shared_ptr<Joint>>& joints) {
+    const AnimationPose& pose = evaluate();
+    if (joints.size() != pose.rotations.size()) return;
+    for (size_t j = 0; j < joints.size(); ++j) {
+        joints[j]->pose = nearestEuler(pose.rotations[j], joints[j]->pose);
+        joints[j]->clampPose();
+    }
+    joints[0]->offset = joints[0]->originOffset + pose.rootTranslation;
+}
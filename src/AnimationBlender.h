@@ -0,0 +1,101 @@
+// AnimationBlender.h
+#pragma once
+
+#include "AnimationPose.h"
+#include "AnimationClip.h"
+#include "Skeleton.h"
+#include <memory>
+#include <vector>
+
+// Fixed set of pose buffers for one skeleton. Buffers are handed out and
+// returned every frame; new ones are allocated only when all are in use,
+// which is counted so steady-state code can check it never happens.
+class PosePool {
+private:
+    std::vector<std::unique_ptr<AnimationPose>> storage;
+    std::vector<AnimationPose*> available;
+    size_t jointCount = 0;
+    size_t growCount = 0;
+
+public:
+    void reset(size_t jointCount, size_t capacity);
+
+    AnimationPose* acquire();
+    void release(AnimationPose* pose);
+
+    size_t getCapacity() const { return storage.size(); }
+    size_t getInUse() const { return storage.size() - available.size(); }
+    size_t getGrowCount() const { return growCount; }  // acquires that had to allocate
+};
+
+// One clip of a layer's blend tree. Its weight moves toward targetWeight at
+// fadeRate per second, which is how crossfades and blend parameter changes
+// are smoothed.
+struct BlendEntry {
+    const AnimationClip* clip = nullptr;
+    float time = 0.0f;
+    float speed = 1.0f;
+    float weight = 0.0f;
+    float targetWeight = 0.0f;
+    float fadeRate = 0.0f;  // 0 jumps straight to the target
+};
+
+// A layer blends its entries by normalized weight, then goes on top of the
+// layers below it with 'weight' scaled per joint by 'mask'. A layer is in
+// one state at a time: crossfade() is the transition to the next.
+class AnimationLayer {
+public:
+    static const size_t MAX_ENTRIES = 8;
+
+    float weight = 1.0f;
+    std::vector<float> mask;  // per joint; empty means 1 for every joint
+    bool rootMotion = true;   // whether the root translation is blended in
+    std::vector<BlendEntry> entries;
+
+    AnimationLayer() { entries.reserve(MAX_ENTRIES); }
+
+    // Fade 'clip' in and every other entry out over 'duration' seconds.
+    void crossfade(const AnimationClip* clip, float duration, float speed = 1.0f);
+    // Blend tree parameter: the weight 'clip' fades to (adding it if needed).
+    void setClipWeight(const AnimationClip* clip, float weight, float duration = 0.0f);
+    // Mask weight of 'joint' and everything below it (the mask is sized to
+    // the skeleton's joint list, other joints keeping their weight or 1).
+    void setMask(Skeleton& skeleton, const Joint* joint, float jointWeight);
+
+    void update(float dt);
+
+private:
+    BlendEntry* findOrAdd(const AnimationClip* clip);
+};
+
+// Layered animation blending. Clips are sampled into pooled pose buffers and
+// slerp-blended there; the joints are written once, by apply(). After the
+// first frames, update/evaluate/apply do not allocate.
+class AnimationBlender {
+private:
+    PosePool pool;
+    AnimationPose restPose;
+    AnimationPose* result = nullptr;
+    std::vector<AnimationLayer> layers;
+
+    // Blend 'from' toward 'to' by weight t per joint (times mask when given).
+    static void blendInto(AnimationPose& from, const AnimationPose& to, float t, const std::vector<float>* mask, bool translation);
+
+public:
+    // Pose buffers for the skeleton's joint list; rest pose from the .skel file.
+    void initialize(Skeleton& skeleton, size_t layerCount = 1);
+
+    size_t getLayerCount() const { return layers.size(); }
+    AnimationLayer& getLayer(size_t index) { return layers[index]; }
+
+    // Advance clip times and fades.
+    void update(float dt);
+
+    // Blend every layer into the result pose, without touching any joint.
+    const AnimationPose& evaluate();
+
+    // evaluate(), then write the result into the joints, within their limits.
+    void apply(std::vector<std::shared_ptr<Joint>>& joints);
+
+    const PosePool& getPool() const { return pool; }
+};
@@ -119,5 +119,21 @@ void AnimationClip::Evaluate(float time, std::vector<std::shared_ptr<Joint>>& jo
 
         // Update the joint's pose. (Here, 'pose' holds Euler angles.)
         joints[j]->pose = glm::vec3(rx, ry, rz);
+        joints[j]->clampPose();
+    }
+}
+
+void AnimationClip::Evaluate(float time, AnimationPose& pose) const {
+    const size_t channelsPerJoint = 3;
+    time *= 2;
+    assert(channels.size() == (pose.rotations.size() + 1) * channelsPerJoint &&
+        "AnimationClip::Evaluate: Insufficient channels for joints.");
+
+    pose.rootTranslation = glm::vec3(channels[0].Evaluate(time), channels[1].Evaluate(time), channels[2].Evaluate(time));
+    for (size_t j = 0; j < pose.rotations.size(); j++) {
+        size_t baseChannel = (j + 1) * channelsPerJoint;
+        glm::vec3 angles(channels[baseChannel].Evaluate(time), channels[baseChannel + 1].Evaluate(time),
+            channels[baseChannel + 2].Evaluate(time));
+        pose.rotations[j] = glm::quat(angles);
     }
 }
@@ -4,6 +4,7 @@
 #include <vector>
 #include "Skeleton.h"
 #include "Channel.h"  // our channel definition below
+#include "AnimationPose.h"
 
 class AnimationClip {
 public:
@@ -14,5 +15,7 @@ public:
     std::vector<Channel> channels;
 
     void Evaluate(float time, std::vector<std::shared_ptr<Joint>>& joints);
+    // Same sampling into a pose buffer (sized to the joint count) instead of the joints.
+    void Evaluate(float time, AnimationPose& pose) const;
     bool Load(const char* filename);
 };
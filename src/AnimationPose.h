@@ -0,0 +1,14 @@
+// AnimationPose.h
+#pragma once
+
+#include "core.h"
+#include "glm/gtx/quaternion.hpp"
+#include <vector>
+
+// A skeleton pose kept apart from the Joint objects, so clips can be sampled
+// and blended without touching the skeleton until the final write. Joints
+// are in Skeleton::getJointList() order, the order of the clip channels.
+struct AnimationPose {
+    glm::vec3 rootTranslation = glm::vec3(0.0f);  // added to the root's originOffset
+    std::vector<glm::quat> rotations;              // local rotation of every joint
+};
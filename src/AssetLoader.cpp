@@ -0,0 +1,75 @@
+// AssetLoader.cpp
+#include "AssetLoader.h"
+#include "SkeletonParser.h"
+#include "SkinParser.h"
+#include <cstdio>
+
+AssetLoader::AssetLoader()
+    : created(std::chrono::steady_clock::now()) {}
+
+void AssetLoader::record(const std::string& file, std::chrono::steady_clock::time_point begin, bool loaded) {
+    Timing timing;
+    timing.file = file;
+    timing.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    timing.loaded = loaded;
+    std::lock_guard<std::mutex> lock(mutex);
+    timings.push_back(timing);
+}
+
+std::future<std::unique_ptr<Skeleton>> AssetLoader::loadSkeleton(const std::string& path) {
+    return std::async(std::launch::async, [this, path]() {
+        auto begin = std::chrono::steady_clock::now();
+        SkeletonParser parser;
+        std::unique_ptr<Skeleton> skeleton;
+        if (parser.parseSkeletonFile(path)) {
+            skeleton = std::make_unique<Skeleton>(parser.getSkeleton());
+            skeleton->buildJointList();
+        }
+        record(path, begin, skeleton != nullptr);
+        return skeleton;
+    });
+}
+
+std::future<std::unique_ptr<Skin>> AssetLoader::loadSkin(const std::string& path) {
+    return std::async(std::launch::async, [this, path]() {
+        auto begin = std::chrono::steady_clock::now();
+        auto skin = std::make_unique<Skin>();
+        SkinParser parser;
+        if (parser.parseSkinFile(path, *skin)) {
+            skin->computeNormals();
+        }
+        else {
+            skin.reset();
+        }
+        record(path, begin, skin != nullptr);
+        return skin;
+    });
+}
+
+std::future<std::unique_ptr<AnimationClip>> AssetLoader::loadAnimation(const std::string& path) {
+    return std::async(std::launch::async, [this, path]() {
+        auto begin = std::chrono::steady_clock::now();
+        auto clip = std::make_unique<AnimationClip>();
+        if (!clip->Load(path.c_str())) clip.reset();
+        record(path, begin, clip != nullptr);
+        return clip;
+    });
+}
+
+std::vector<AssetLoader::Timing> AssetLoader::getTimings() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return timings;
+}
+
+double AssetLoader::getElapsedMilliseconds() const {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - created).count();
+}
+
+void AssetLoader::printReport() const {
+    double sum = 0.0;
+    for (const Timing& timing : getTimings()) {
+        printf("  %-40s %9.1f ms%s\n", timing.file.c_str(), timing.milliseconds, timing.loaded ? "" : "  (failed)");
+        sum += timing.milliseconds;
+    }
+    printf("  assets ready after %.1f ms (%.1f ms of parsing)\n", getElapsedMilliseconds(), sum);
+}
@@ -0,0 +1,46 @@
+// AssetLoader.h
+#pragma once
+
+#include "Skeleton.h"
+#include "Skin.h"
+#include "AnimationClip.h"
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Parses .skel, .skin and .anim files concurrently, each on its own thread,
+// and hands the results back as futures. Parsing only fills CPU-side data;
+// GL objects are created by the caller on the main thread once a future is
+// ready. A failed load yields a null pointer (the parser has already said
+// why on stderr). The loader must outlive the futures it returns.
+class AssetLoader {
+public:
+    struct Timing {
+        std::string file;
+        double milliseconds = 0.0;  // on the loading thread
+        bool loaded = false;
+    };
+
+    AssetLoader();
+
+    std::future<std::unique_ptr<Skeleton>> loadSkeleton(const std::string& path);
+    std::future<std::unique_ptr<Skin>> loadSkin(const std::string& path);  // normals computed too
+    std::future<std::unique_ptr<AnimationClip>> loadAnimation(const std::string& path);
+
+    // Assets finished so far, in completion order.
+    std::vector<Timing> getTimings() const;
+    // Wall time since the loader was created.
+    double getElapsedMilliseconds() const;
+    // Per-asset times, then the wall time against the sum of the parse times.
+    void printReport() const;
+
+private:
+    mutable std::mutex mutex;
+    std::vector<Timing> timings;
+    std::chrono::steady_clock::time_point created;
+
+    void record(const std::string& file, std::chrono::steady_clock::time_point begin, bool loaded);
+};
@@ -0,0 +1,87 @@
+// BVH.cpp
+#include "BVH.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <cfloat>
+
+void DynamicBVH::build(const std::vector<glm::vec3>& positions, const std::vector<glm::ivec3>& tris, int leafSize) {
+    triangles = tris;
+    nodes.clear();
+    levels.clear();
+    primitives.resize(triangles.size());
+    if (triangles.empty()) return;
+
+    std::vector<glm::vec3> centroids(triangles.size());
+    for (size_t i = 0; i < triangles.size(); ++i) {
+        const glm::ivec3& t = triangles[i];
+        centroids[i] = (positions[t.x] + positions[t.y] + positions[t.z]) / 3.0f;
+        primitives[i] = static_cast<int>(i);
+    }
+
+    nodes.reserve(2 * triangles.size() / std::max(leafSize, 1) + 1);
+    buildRecursive(centroids, 0, static_cast<int>(triangles.size()), 0, std::max(leafSize, 1));
+    refit(positions);
+}
+
+int DynamicBVH::buildRecursive(const std::vector<glm::vec3>& centroids, int first, int count, int depth, int leafSize) {
+    int index = static_cast<int>(nodes.size());
+    nodes.emplace_back();
+    if ((int)levels.size() <= depth) levels.resize(depth + 1);
+    levels[depth].push_back(index);
+
+    // Keep the depth within the fixed query stack.
+    if (count <= leafSize || depth >= 48) {
+        nodes[index].first = first;
+        nodes[index].count = count;
+        return index;
+    }
+
+    // Median split along the longest axis of the centroid bounds.
+    glm::vec3 cMin(FLT_MAX), cMax(-FLT_MAX);
+    for (int i = first; i < first + count; ++i) {
+        cMin = glm::min(cMin, centroids[primitives[i]]);
+        cMax = glm::max(cMax, centroids[primitives[i]]);
+    }
+    glm::vec3 extent = cMax - cMin;
+    int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+
+    int half = count / 2;
+    std::nth_element(primitives.begin() + first, primitives.begin() + first + half, primitives.begin() + first + count,
+        [&](int a, int b) { return centroids[a][axis] < centroids[b][axis]; });
+
+    int left = buildRecursive(centroids, first, half, depth + 1, leafSize);
+    int right = buildRecursive(centroids, first + half, count - half, depth + 1, leafSize);
+    nodes[index].left = left;
+    nodes[index].right = right;
+    return index;
+}
+
+void DynamicBVH::fitNode(Node& node, const std::vector<glm::vec3>& positions) const {
+    if (node.left >= 0) {
+        node.boxMin = glm::min(nodes[node.left].boxMin, nodes[node.right].boxMin);
+        node.boxMax = glm::max(nodes[node.left].boxMax, nodes[node.right].boxMax);
+        return;
+    }
+
+    glm::vec3 boxMin(FLT_MAX), boxMax(-FLT_MAX);
+    for (int i = node.first; i < node.first + node.count; ++i) {
+        const glm::ivec3& t = triangles[primitives[i]];
+        boxMin = glm::min(boxMin, glm::min(positions[t.x], glm::min(positions[t.y], positions[t.z])));
+        boxMax = glm::max(boxMax, glm::max(positions[t.x], glm::max(positions[t.y], positions[t.z])));
+    }
+    node.boxMin = boxMin;
+    node.boxMax = boxMax;
+}
+
+void DynamicBVH::refit(const std::vector<glm::vec3>& positions) {
+    // Children are always one level deeper, so finishing a level before the
+    // next one up is all the ordering a parallel refit needs.
+    for (int depth = static_cast<int>(levels.size()) - 1; depth >= 0; --depth) {
+        const std::vector<int>& level = levels[depth];
+        JobSystem::getInstance().parallelFor(level.size(), 256, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                fitNode(nodes[level[i]], positions);
+            }
+        });
+    }
+}
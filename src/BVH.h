@@ -0,0 +1,58 @@
+// BVH.h
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+
+// Bounding volume hierarchy over a deforming triangle mesh. The tree is built
+// once from the rest shape; afterwards refit() only recomputes the boxes from
+// the current vertex positions, which keeps the topology and is O(N). Nodes
+// are grouped by depth so each level can be refitted in parallel, deepest first.
+class DynamicBVH {
+public:
+    struct Node {
+        glm::vec3 boxMin, boxMax;
+        int left = -1, right = -1;  // children, -1 for a leaf
+        int first = 0, count = 0;   // leaf range in primitive order
+    };
+
+    // Build over triangles (vertex index triples) at the given positions.
+    void build(const std::vector<glm::vec3>& positions, const std::vector<glm::ivec3>& triangles, int leafSize = 4);
+
+    // Recompute every box from new positions of the same vertices.
+    void refit(const std::vector<glm::vec3>& positions);
+
+    // Call visit(triangleIndex) for every triangle whose leaf box overlaps [boxMin, boxMax].
+    template <typename Visitor>
+    void query(const glm::vec3& boxMin, const glm::vec3& boxMax, Visitor&& visit) const {
+        if (nodes.empty()) return;
+        int stack[64];
+        int top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const Node& node = nodes[stack[--top]];
+            if (glm::any(glm::lessThan(node.boxMax, boxMin)) || glm::any(glm::greaterThan(node.boxMin, boxMax))) continue;
+            if (node.left < 0) {
+                for (int i = node.first; i < node.first + node.count; ++i) visit(primitives[i]);
+            }
+            else {
+                stack[top++] = node.left;
+                stack[top++] = node.right;
+            }
+        }
+    }
+
+    bool empty() const { return nodes.empty(); }
+    size_t getNodeCount() const { return nodes.size(); }
+    size_t getTriangleCount() const { return triangles.size(); }
+    const glm::ivec3& getTriangle(int i) const { return triangles[i]; }
+
+private:
+    std::vector<Node> nodes;
+    std::vector<int> primitives;          // triangle indices in leaf order
+    std::vector<glm::ivec3> triangles;
+    std::vector<std::vector<int>> levels; // node indices by depth
+
+    int buildRecursive(const std::vector<glm::vec3>& centroids, int first, int count, int depth, int leafSize);
+    void fitNode(Node& node, const std::vector<glm::vec3>& positions) const;
+};
@@ -0,0 +1,2081 @@
+// Benchmarks.cpp
+#include "Benchmarks.h"
+#include "Cloth.h"
+#include "JobSystem.h"
+#include "SkeletonParser.h"
+#include "Shader.h"
+#include "BoneInstance.h"
+#include "JointColliders.h"
+#include "ClothStepController.h"
+#include "ClothTopology.h"
+#include "IKSystem.h"
+#include "Retargeter.h"
+#include "AnimationClip.h"
+#include "AnimationBlender.h"
+#include "StreamingClip.h"
+#include "AssetLoader.h"
+#include "AllocationCounter.h"
+#include "SkinParser.h"
+#include "HotReloader.h"
+#include <thread>
+#include <chrono>
+#include <random>
+#include <memory>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <algorithm>
+#include <fstream>
+#include <filesystem>
+
+namespace Benchmarks {
+
+namespace {
+    // A file of the skeleton resource folder, as seen from the build or repo
+    // directory; empty if it is in neither.
+    std::string findSkeletonResource(const std::string& file) {
+        const std::string paths[] = { resourceStorePath + file, "../resources/skeletons/" + file, "resources/skeletons/" + file };
+        for (const std::string& path : paths) {
+            if (std::ifstream(path).good()) return path;
+        }
+        return "";
+    }
+
+    bool loadDragon(SkeletonParser& parser) {
+        std::string path = findSkeletonResource("dragon.skel");
+        return !path.empty() && parser.parseSkeletonFile(path);
+    }
+
+    // Random joint angles inside the limits, with open limits folded to a half turn.
+    glm::vec3 randomPose(const Joint* joint, std::mt19937& rng) {
+        auto pick = [&](glm::vec2 limit) {
+            float low = std::max(limit.x, -glm::pi<float>()), high = std::min(limit.y, glm::pi<float>());
+            return low >= high ? low : std::uniform_real_distribution<float>(low, high)(rng);
+        };
+        return glm::vec3(pick(joint->rotXLimit), pick(joint->rotYLimit), pick(joint->rotZLimit));
+    }
+}
+
+bool run(const std::string& name) {
+    printf("Running benchmark '%s' on %zu threads\n", name.c_str(), JobSystem::getInstance().getThreadCount());
+
+    if (name == "normals") return normalMatrices();
+    if (name == "bones") return boneInstances();
+    if (name == "selfcollision") return selfCollision();
+    if (name == "jointcolliders") return jointColliders();
+    if (name == "multicloth") return multiCloth();
+    if (name == "sleep") return sleeping();
+    if (name == "triangles") return trianglePass();
+    if (name == "backends") return solverBackends();
+    if (name == "timestep") return timestepControl();
+    if (name == "tethers") return tethers();
+    if (name == "meshtopology") return meshTopology();
+    if (name == "ik") return inverseKinematics();
+    if (name == "ikcrowd") return ikCrowd();
+    if (name == "retarget") return retargeting();
+    if (name == "blend") return blending();
+    if (name == "posepipeline") return posePipeline();
+    if (name == "dirtyupdate") return dirtyUpdate();
+    if (name == "streaming") return streamingClip();
+    if (name == "assetload") return assetLoading();
+    if (name == "skinparse") return skinParsing();
+    if (name == "hotreload") return hotReload();
+    if (name == "all") {
+        bool ok = true;
+        ok = normalMatrices() && ok;
+        ok = boneInstances() && ok;
+        ok = selfCollision() && ok;
+        ok = jointColliders() && ok;
+        ok = multiCloth() && ok;
+        ok = sleeping() && ok;
+        ok = trianglePass() && ok;
+        ok = solverBackends() && ok;
+        ok = timestepControl() && ok;
+        ok = tethers() && ok;
+        ok = meshTopology() && ok;
+        ok = inverseKinematics() && ok;
+        ok = ikCrowd() && ok;
+        ok = retargeting() && ok;
+        ok = blending() && ok;
+        ok = posePipeline() && ok;
+        ok = dirtyUpdate() && ok;
+        ok = streamingClip() && ok;
+        ok = assetLoading() && ok;
+        ok = skinParsing() && ok;
+        ok = hotReload() && ok;
+        return ok;
+    }
+
+    printf("Unknown benchmark '%s'. Available: all, normals, bones, selfcollision, jointcolliders, multicloth, sleep, triangles, backends, timestep, tethers, meshtopology, ik, ikcrowd, retarget, blend, posepipeline, dirtyupdate, streaming, assetload, skinparse, hotreload\n", name.c_str());
+    return false;
+}
+
+bool normalMatrices() {
+    using Clock = std::chrono::high_resolution_clock;
+    SkeletonParser parser;
+    if (!loadDragon(parser)) {
+        printf("\n[normals] dragon.skel not found, skipping\n");
+        return true;
+    }
+    Skeleton& skeleton = parser.getSkeleton();
+    skeleton.buildJointList();
+    auto& joints = skeleton.getJointList();
+    bool ok = true;
+
+    // Bind at the rest pose, then skin against a random pose scaled down to
+    // what animation does between neighbouring joints.
+    skeleton.update();
+    std::vector<glm::mat4> inverseBind(joints.size());
+    for (size_t j = 0; j < joints.size(); ++j) inverseBind[j] = glm::inverse(joints[j]->worldMatrix);
+    std::mt19937 rng(28);
+    for (size_t j = 1; j < joints.size(); ++j) joints[j]->pose = 0.3f * randomPose(joints[j].get(), rng);
+    skeleton.update();
+    std::vector<glm::mat4> skinMatrices(joints.size());
+    for (size_t j = 0; j < joints.size(); ++j) skinMatrices[j] = joints[j]->worldMatrix * inverseBind[j];
+
+    // The .skel loader flags its skeletons rigid; the joint matrices have to agree.
+    float worstScale = 0.0f;
+    for (const auto& joint : joints) {
+        glm::mat3 r(joint->worldMatrix);
+        glm::mat3 shouldBeIdentity = glm::transpose(r) * r;
+        for (int c = 0; c < 3; ++c) {
+            for (int row = 0; row < 3; ++row) {
+                worstScale = std::max(worstScale, std::abs(shouldBeIdentity[c][row] - (c == row ? 1.0f : 0.0f)));
+            }
+        }
+    }
+    if (!skeleton.hasRigidJoints() || worstScale > 1e-3f) {
+        printf("\n[normals] FAILED: dragon.skel %s rigid, joint scale error %.2e\n",
+            skeleton.hasRigidJoints() ? "flagged" : "not flagged", worstScale);
+        ok = false;
+    }
+
+    // A large skin: each vertex bound to a joint and up to three of its
+    // ancestors, as a real skin blends neighbouring joints; a quarter of the
+    // vertices are bound to one joint only.
+    std::vector<int> parentOf(joints.size(), -1);
+    for (size_t j = 1; j < joints.size(); ++j) {
+        for (size_t p = 0; p < j; ++p) {
+            if (joints[p].get() == joints[j]->parent) parentOf[j] = (int)p;
+        }
+    }
+    const size_t vertexCount = 200000;
+    struct Influence { int joint[4]; float weight[4]; };
+    std::vector<glm::vec3> positions(vertexCount), normals(vertexCount);
+    std::vector<Influence> influences(vertexCount);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f), share(0.1f, 1.0f);
+    std::uniform_int_distribution<int> anyJoint(0, (int)joints.size() - 1);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        positions[v] = glm::vec3(unit(rng), unit(rng), unit(rng));
+        normals[v] = glm::normalize(glm::vec3(unit(rng), unit(rng), unit(rng)) + glm::vec3(0.0f, 0.0f, 1e-3f));
+        Influence& in = influences[v];
+        float total = 0.0f;
+        for (int k = 0, j = anyJoint(rng); k < 4; ++k) {
+            in.joint[k] = j;
+            in.weight[k] = (v % 4 == 0 && k > 0) ? 0.0f : share(rng);
+            total += in.weight[k];
+            if (parentOf[j] >= 0) j = parentOf[j];
+        }
+        for (int k = 0; k < 4; ++k) in.weight[k] /= total;
+    }
+    // Non-uniform scale, so the normal matrix is not just the rotation.
+    const glm::mat4 model = glm::translate(glm::vec3(1, 2, 3)) * glm::rotate(0.7f, glm::vec3(0, 1, 0)) * glm::scale(glm::vec3(1.0f, 2.0f, 0.5f));
+
+    std::vector<glm::vec3> outPositions(vertexCount);
+    auto blend = [&](const Influence& in) {
+        glm::mat4 m(0.0f);
+        for (int k = 0; k < 4; ++k) m += skinMatrices[in.joint[k]] * in.weight[k];
+        return m;
+    };
+    // One run of the vertex stage: skinned position and world normal of every
+    // vertex, after the per-draw setup.
+    auto timePass = [&](std::vector<glm::vec3>& out, const std::function<void(glm::mat3&)>& perDraw,
+        const std::function<glm::vec3(size_t, const glm::mat3&)>& normal) {
+        const int rounds = 5;
+        out.resize(vertexCount);
+        auto begin = Clock::now();
+        for (int r = 0; r < rounds; ++r) {
+            glm::mat3 normalMatrix;
+            perDraw(normalMatrix);
+            for (size_t v = 0; v < vertexCount; ++v) {
+                outPositions[v] = glm::vec3(model * blend(influences[v]) * glm::vec4(positions[v], 1.0f));
+                out[v] = normal(v, normalMatrix);
+            }
+        }
+        return std::chrono::duration<double, std::nano>(Clock::now() - begin).count() / rounds / vertexCount;
+    };
+    auto noSetup = [](glm::mat3&) {};
+    auto uniformSetup = [&](glm::mat3& normalMatrix) { normalMatrix = computeNormalMatrix(model); };
+
+    // GPU skinning shader. Before: the skin matrix and the model matrix were
+    // inverted per vertex. Now the normal matrix is a per-draw uniform, and
+    // rigid joints use the blended skin matrix's upper 3x3.
+    std::vector<glm::vec3> shaderBefore, shaderUniform, shaderRigid;
+    double shaderBeforeNs = timePass(shaderBefore, noSetup, [&](size_t v, const glm::mat3&) {
+        glm::vec3 n = glm::mat3(glm::transpose(glm::inverse(blend(influences[v])))) * normals[v];
+        return glm::normalize(glm::mat3(glm::transpose(glm::inverse(model))) * n);
+    });
+    double shaderUniformNs = timePass(shaderUniform, uniformSetup, [&](size_t v, const glm::mat3& normalMatrix) {
+        return glm::normalize(normalMatrix * (glm::mat3(glm::transpose(glm::inverse(blend(influences[v])))) * normals[v]));
+    });
+    double shaderRigidNs = timePass(shaderRigid, uniformSetup, [&](size_t v, const glm::mat3& normalMatrix) {
+        return glm::normalize(normalMatrix * (glm::mat3(blend(influences[v])) * normals[v]));
+    });
+
+    // CPU skinning. Before: an inverse-transpose per influence per vertex.
+    // Now a per-joint palette built once per draw, or none for rigid joints.
+    std::vector<glm::mat3> palette(joints.size());
+    auto paletteSetup = [&](glm::mat3& normalMatrix) {
+        normalMatrix = computeNormalMatrix(model);
+        for (size_t j = 0; j < joints.size(); ++j) palette[j] = glm::transpose(glm::inverse(glm::mat3(skinMatrices[j])));
+    };
+    auto cpuNormal = [&](size_t v, const glm::mat3& normalMatrix, const std::function<glm::mat3(int)>& jointNormal) {
+        const Influence& in = influences[v];
+        glm::vec3 n(0.0f);
+        for (int k = 0; k < 4; ++k) n += jointNormal(in.joint[k]) * normals[v] * in.weight[k];
+        return glm::normalize(normalMatrix * n);
+    };
+    std::vector<glm::vec3> cpuBefore, cpuPalette, cpuRigid;
+    double cpuBeforeNs = timePass(cpuBefore, uniformSetup, [&](size_t v, const glm::mat3& normalMatrix) {
+        return cpuNormal(v, normalMatrix, [&](int j) { return glm::transpose(glm::inverse(glm::mat3(skinMatrices[j]))); });
+    });
+    double cpuPaletteNs = timePass(cpuPalette, paletteSetup, [&](size_t v, const glm::mat3& normalMatrix) {
+        return cpuNormal(v, normalMatrix, [&](int j) { return palette[j]; });
+    });
+    double cpuRigidNs = timePass(cpuRigid, uniformSetup, [&](size_t v, const glm::mat3& normalMatrix) {
+        return cpuNormal(v, normalMatrix, [&](int j) { return glm::mat3(skinMatrices[j]); });
+    });
+
+    // The uniform and the palette are the same math reordered, and rigid joint
+    // matrices are their own inverse-transpose. Only the shader's rigid path
+    // approximates: the blend of rotations is not quite a rotation.
+    float uniformError = 0.0f, paletteError = 0.0f, cpuRigidError = 0.0f, rigidSingleError = 0.0f;
+    std::vector<float> rigidBlendDegrees;
+    for (size_t v = 0; v < vertexCount; ++v) {
+        uniformError = std::max(uniformError, glm::length(shaderUniform[v] - shaderBefore[v]));
+        paletteError = std::max(paletteError, glm::length(cpuPalette[v] - cpuBefore[v]));
+        cpuRigidError = std::max(cpuRigidError, glm::length(cpuRigid[v] - cpuBefore[v]));
+        if (v % 4 == 0) rigidSingleError = std::max(rigidSingleError, glm::length(shaderRigid[v] - shaderBefore[v]));
+        else rigidBlendDegrees.push_back(glm::degrees(std::acos(std::clamp(glm::dot(shaderRigid[v], shaderBefore[v]), -1.0f, 1.0f))));
+    }
+    std::sort(rigidBlendDegrees.begin(), rigidBlendDegrees.end());
+
+    printf("\n[normals] dragon.skel, %zu joints, %zu vertices with up to 4 influences, scaled model\n", joints.size(), vertexCount);
+    printf("%-40s %10s %10s\n", "", "ns/vertex", "speedup");
+    printf("%-40s %10.1f %9.2fx\n", "shader: inverses per vertex (before)", shaderBeforeNs, 1.0);
+    printf("%-40s %10.1f %9.2fx\n", "shader: normalMatrix uniform", shaderUniformNs, shaderBeforeNs / shaderUniformNs);
+    printf("%-40s %10.1f %9.2fx\n", "shader: uniform + rigid joints", shaderRigidNs, shaderBeforeNs / shaderRigidNs);
+    printf("%-40s %10.1f %9.2fx\n", "CPU: inverse per influence (before)", cpuBeforeNs, 1.0);
+    printf("%-40s %10.1f %9.2fx\n", "CPU: inverse-transpose palette", cpuPaletteNs, cpuBeforeNs / cpuPaletteNs);
+    printf("%-40s %10.1f %9.2fx\n", "CPU: rigid joints", cpuRigidNs, cpuBeforeNs / cpuRigidNs);
+    printf("largest difference: uniform %.1e, palette %.1e, CPU rigid %.1e, shader rigid %.1e (one joint)\n",
+        uniformError, paletteError, cpuRigidError, rigidSingleError);
+    printf("shader rigid on blended joints: median %.1f deg, worst %.1f deg off the inverse-transpose\n",
+        rigidBlendDegrees[rigidBlendDegrees.size() / 2], rigidBlendDegrees.back());
+    if (uniformError > 1e-4f || paletteError > 1e-4f || cpuRigidError > 1e-4f || rigidSingleError > 1e-4f) {
+        printf("FAILED: precomputed normal matrices disagree with the per-vertex inverse-transposes\n");
+        ok = false;
+    }
+    if (shaderRigidNs >= shaderBeforeNs || cpuPaletteNs >= cpuBeforeNs) {
+        printf("FAILED: precomputed normal matrices are not cheaper than per-vertex inverses\n");
+        ok = false;
+    }
+    return ok;
+}
+
+bool boneInstances() {
+    using Clock = std::chrono::high_resolution_clock;
+    SkeletonParser parser;
+    if (!loadDragon(parser)) {
+        printf("\n[bones] dragon.skel not found, skipping\n");
+        return true;
+    }
+    Skeleton& skeleton = parser.getSkeleton();
+    skeleton.buildJointList();
+    auto& joints = skeleton.getJointList();
+    bool ok = true;
+
+    // The GL attribute pointers walk the instance buffer with these offsets.
+    if (sizeof(BoneInstance) != 22 * sizeof(float) || offsetof(BoneInstance, boxMax) != 3 * sizeof(float) ||
+        offsetof(BoneInstance, world) != 6 * sizeof(float)) {
+        printf("\n[bones] FAILED: BoneInstance is %zu bytes, expected %zu floats tightly packed\n",
+            sizeof(BoneInstance), (size_t)22);
+        ok = false;
+    }
+
+    // Several poses into the same vector, as the renderer reuses it per frame.
+    std::mt19937 rng(47);
+    std::vector<BoneInstance> instances;
+    size_t mismatches = 0;
+    for (int pose = 0; pose < 20; ++pose) {
+        for (size_t i = 1; i < joints.size(); ++i) joints[i]->pose = randomPose(joints[i].get(), rng);
+        skeleton.update();
+        packBoneInstances(joints, instances);
+        if (instances.size() != joints.size()) {
+            printf("\n[bones] FAILED: %zu instances for %zu joints\n", instances.size(), joints.size());
+            return false;
+        }
+        for (size_t i = 0; i < joints.size(); ++i) {
+            if (instances[i].boxMin != joints[i]->boxMin || instances[i].boxMax != joints[i]->boxMax ||
+                instances[i].world != joints[i]->worldMatrix) {
+                if (mismatches++ == 0) printf("\n[bones] FAILED: instance %zu does not match its joint\n", i);
+            }
+        }
+    }
+
+    const int rounds = 100000;
+    auto begin = Clock::now();
+    for (int r = 0; r < rounds; ++r) packBoneInstances(joints, instances);
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - begin).count() / rounds / joints.size();
+
+    printf("\n[bones] dragon.skel: %zu joints, 20 poses packed, %zu mismatched instances, %.2f ns/joint\n",
+        joints.size(), mismatches, ns);
+    if (mismatches > 0) ok = false;
+    return ok;
+}
+
+bool selfCollision() {
+    const int particleCounts[] = { 10000, 50000, 200000 };
+    const int iterations = 10;
+    const float spacing = 0.01f;
+
+    printf("\n[selfcollision] cloth folded onto itself, %d steps each (contacts from step 1)\n", iterations);
+    printf("%10s %10s %10s %10s %10s %10s %12s\n",
+        "particles", "grid ms", "detect ms", "resolve ms", "contacts", "candidates", "ns/particle");
+
+    for (int target : particleCounts) {
+        int side = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(target))));
+
+        Cloth cloth;
+        cloth.initializeRectangularCloth(side, side, spacing, glm::vec3(0.0f), 3000.0f, 10.0f, 1.0f);
+        cloth.selfCollision = true;
+        cloth.collisionThickness = 0.4f * spacing;
+
+        // Fold the far half back over the near half, half a thickness above it,
+        // so every folded particle is in contact.
+        const int fold = side / 2;
+        for (int j = fold + 1; j < side; ++j) {
+            for (int i = 0; i < side; ++i) {
+                Particle& p = cloth.particles[j * side + i];
+                p.position.z = -(2 * fold - j) * spacing;
+                p.position.y += 0.5f * cloth.collisionThickness;
+            }
+        }
+
+        SelfCollisionStats total;
+        for (int it = 0; it < iterations; ++it) {
+            cloth.handleSelfCollisions();
+            total.gridMs += cloth.selfCollisionStats.gridMs;
+            total.detectMs += cloth.selfCollisionStats.detectMs;
+            total.resolveMs += cloth.selfCollisionStats.resolveMs;
+            if (it == 0) {
+                // The first step sees the fold before any contact is resolved.
+                total.contacts = cloth.selfCollisionStats.contacts;
+                total.candidates = cloth.selfCollisionStats.candidates;
+            }
+        }
+
+        const float stepMs = (total.gridMs + total.detectMs + total.resolveMs) / iterations;
+        const size_t count = cloth.particles.size();
+        printf("%10zu %10.3f %10.3f %10.3f %10d %10d %12.1f\n",
+            count,
+            total.gridMs / iterations,
+            total.detectMs / iterations,
+            total.resolveMs / iterations,
+            total.contacts,
+            total.candidates,
+            stepMs * 1.0e6f / count);
+    }
+    return true;
+}
+
+bool jointColliders() {
+    const int particleCount = 100000;
+    const int primitiveCount = 40;
+    const int iterations = 20;
+
+    // A character-sized cloud of primitives and particles scattered through it.
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> size(0.05f, 0.2f);
+
+    JointColliderSet reference;
+    for (int i = 0; i < primitiveCount; ++i) {
+        glm::vec3 center(unit(rng), unit(rng), unit(rng));
+        glm::vec3 dir = glm::normalize(glm::vec3(unit(rng), unit(rng), unit(rng)) + glm::vec3(0.0f, 0.0f, 1e-3f));
+
+        JointCapsule capsule;
+        capsule.a = center - dir * size(rng);
+        capsule.b = center + dir * size(rng);
+        capsule.radius = size(rng);
+        reference.capsules.push_back(capsule);
+
+        JointBox box;
+        box.center = center;
+        box.axis[0] = dir;
+        box.axis[1] = glm::normalize(glm::cross(dir, glm::abs(dir.x) < 0.9f ? glm::vec3(1, 0, 0) : glm::vec3(0, 1, 0)));
+        box.axis[2] = glm::cross(box.axis[0], box.axis[1]);
+        box.halfExtent = glm::vec3(size(rng), size(rng), size(rng));
+        reference.boxes.push_back(box);
+    }
+
+    std::vector<Particle> start;
+    start.reserve(particleCount);
+    for (int i = 0; i < particleCount; ++i) {
+        start.emplace_back(glm::vec3(unit(rng), unit(rng), unit(rng)) * 1.2f, 1.0f, i % 97 == 0);
+        start.back().velocity = glm::vec3(unit(rng), unit(rng), unit(rng));
+    }
+
+    printf("\n[jointcolliders] %d particles vs %d capsules + %d boxes, %d passes\n",
+        particleCount, primitiveCount, primitiveCount, iterations);
+
+    double msPerPass[2] = { 0.0, 0.0 };
+    std::vector<Particle> results[2];
+    int contacts[2] = { 0, 0 };
+    bool scratchReused = true;
+    size_t collideAllocations = 0;
+    for (int simd = 0; simd < 2; ++simd) {
+        JointColliderSet colliders = reference;
+        colliders.useSIMD = simd == 1;
+
+        double totalMs = 0.0;
+        ColliderScratch scratch;
+        for (int it = 0; it < iterations; ++it) {
+            std::vector<Particle> particles = start;
+            const float* lanes = scratch.x.data();
+            size_t allocationsBefore = AllocationCounter::getCount();
+            auto begin = std::chrono::high_resolution_clock::now();
+            int passContacts = colliders.collide(particles, 0.01f, scratch);
+            auto end = std::chrono::high_resolution_clock::now();
+            totalMs += std::chrono::duration<double, std::milli>(end - begin).count();
+            if (it > 0) {
+                scratchReused = scratchReused && scratch.x.data() == lanes;
+                collideAllocations += AllocationCounter::getCount() - allocationsBefore;
+            }
+            if (it == 0) {
+                results[simd] = particles;
+                contacts[simd] = passContacts;
+            }
+        }
+        msPerPass[simd] = totalMs / iterations;
+    }
+
+    float maxError = 0.0f;
+    for (int i = 0; i < particleCount; ++i) {
+        maxError = glm::max(maxError, glm::length(results[0][i].position - results[1][i].position));
+        maxError = glm::max(maxError, glm::length(results[0][i].velocity - results[1][i].velocity));
+    }
+
+#ifdef JOINT_COLLIDERS_SSE
+    const char* simdName = "SSE";
+#else
+    const char* simdName = "scalar (no SSE)";
+#endif
+    printf("%-18s %8.3f ms/pass %8d contacts\n", "scalar", msPerPass[0], contacts[0]);
+    printf("%-18s %8.3f ms/pass %8d contacts\n", simdName, msPerPass[1], contacts[1]);
+    printf("speedup %.2fx, max difference %g\n", msPerPass[0] / msPerPass[1], maxError);
+    printf("scratch lanes reused across passes: %s", scratchReused ? "yes" : "no");
+    if (AllocationCounter::isEnabled()) printf(", %zu heap allocations after the first pass\n", collideAllocations);
+    else printf("\n");
+
+    bool ok = maxError < 1e-4f && contacts[0] == contacts[1];
+    if (!ok) printf("FAILED: SIMD and scalar joint collision disagree\n");
+    if (!scratchReused || collideAllocations != 0) {
+        printf("FAILED: joint collision reallocates its particle lanes\n");
+        ok = false;
+    }
+    return ok;
+}
+
+bool multiCloth() {
+    const int clothCount = 32;
+    const int steps = 100;
+    const float dt = 0.004f;
+
+    // A scene of flags and banners: mostly small cloths with a few large ones.
+    auto makeScene = [&](std::vector<std::unique_ptr<Cloth>>& cloths) {
+        cloths.clear();
+        for (int i = 0; i < clothCount; ++i) {
+            int side = (i % 8 == 0) ? 64 : 24;
+            cloths.push_back(std::make_unique<Cloth>());
+            cloths.back()->initializeRectangularCloth(side, side, 0.05f, glm::vec3(i * 4.0f, 2.0f, 0.0f), 3000.0f, 10.0f, 1.0f);
+            cloths.back()->selfCollision = true;
+            cloths.back()->setGround(-10.0f);
+        }
+    };
+
+    printf("\n[multicloth] %d cloths, %d steps of %.3f s\n", clothCount, steps, dt);
+
+    double wallMs[2] = { 0.0, 0.0 };
+    std::vector<double> instanceMs(clothCount, 0.0);
+    for (int concurrent = 0; concurrent < 2; ++concurrent) {
+        std::vector<std::unique_ptr<Cloth>> cloths;
+        makeScene(cloths);
+        std::vector<Cloth*> pointers;
+        for (auto& cloth : cloths) pointers.push_back(cloth.get());
+
+        auto begin = std::chrono::high_resolution_clock::now();
+        for (int step = 0; step < steps; ++step) {
+            if (concurrent) {
+                stepCloths(pointers, dt);
+            }
+            else {
+                for (Cloth* cloth : pointers) cloth->update(dt);
+            }
+            if (concurrent) {
+                for (int i = 0; i < clothCount; ++i) instanceMs[i] += pointers[i]->lastStepMs;
+            }
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        wallMs[concurrent] = std::chrono::duration<double, std::milli>(end - begin).count() / steps;
+    }
+
+    printf("%-12s %10s\n", "cloth", "ms/step");
+    for (int i = 0; i < clothCount; i += 8) {
+        printf("#%-11d %10.3f  (%s)\n", i, instanceMs[i] / steps, i % 8 == 0 ? "64x64" : "24x24");
+        if (i + 1 < clothCount) printf("#%-11d %10.3f  (24x24)\n", i + 1, instanceMs[i + 1] / steps);
+    }
+    printf("one by one   %8.3f ms/step\n", wallMs[0]);
+    printf("concurrent   %8.3f ms/step  (%.2fx, %llu steals)\n", wallMs[1], wallMs[0] / wallMs[1],
+        (unsigned long long)JobSystem::getInstance().getStealCount());
+    return true;
+}
+
+bool sleeping() {
+    const int clothCount = 12;
+    const float dt = 0.004f;
+    const int settleSteps = 4000;  // 16 s of simulated time
+    const int sampleSteps = 250;
+
+    std::vector<std::unique_ptr<Cloth>> cloths;
+    std::vector<Cloth*> pointers;
+    for (int i = 0; i < clothCount; ++i) {
+        cloths.push_back(std::make_unique<Cloth>());
+        cloths.back()->initializeRectangularCloth(24, 24, 0.05f, glm::vec3(i * 3.0f, 2.0f, 0.0f), 3000.0f, 10.0f, 1.0f);
+        cloths.back()->selfCollision = true;
+        cloths.back()->setGround(-10.0f);
+        cloths.back()->ambientDrag = 1.0f;  // still air: swinging dies out within the run
+        pointers.push_back(cloths.back().get());
+    }
+
+    auto activePercent = [&]() {
+        float total = 0.0f;
+        for (Cloth* cloth : pointers) total += cloth->getActivePercent();
+        return total / clothCount;
+    };
+    auto timeSteps = [&](int steps) {
+        auto begin = std::chrono::high_resolution_clock::now();
+        for (int step = 0; step < steps; ++step) stepCloths(pointers, dt);
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::milli>(end - begin).count() / steps;
+    };
+
+    printf("\n[sleep] %d hanging 24x24 cloths, %.1f s to settle\n", clothCount, settleSteps * dt);
+
+    double awakeMs = timeSteps(sampleSteps);
+    printf("%-22s %8.3f ms/step  %5.1f%% active\n", "first steps", awakeMs, activePercent());
+
+    timeSteps(settleSteps - 2 * sampleSteps);
+    double settledMs = timeSteps(sampleSteps);
+    float settledActive = activePercent();
+    printf("%-22s %8.3f ms/step  %5.1f%% active\n", "after settling", settledMs, settledActive);
+
+    for (Cloth* cloth : pointers) cloth->setWind(cloth->wind + glm::vec3(1.0f, 0.0f, 0.0f));
+    stepCloths(pointers, dt);
+    float wokenActive = activePercent();
+    printf("%-22s %8s           %5.1f%% active\n", "after wind change", "", wokenActive);
+
+    bool ok = wokenActive == 100.0f && settledActive < 100.0f;
+    if (wokenActive != 100.0f) printf("FAILED: a wind change did not wake every cloth\n");
+    if (settledActive >= 100.0f) printf("FAILED: no region fell asleep after %.1f s\n", settleSteps * dt);
+    return ok;
+}
+
+bool trianglePass() {
+    const int gridSize = 256;
+    const int iterations = 20;
+
+    Cloth cloth;
+    cloth.initializeRectangularCloth(gridSize, gridSize, 0.01f, glm::vec3(0.0f), 3000.0f, 10.0f, 1.0f);
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> jitter(-0.004f, 0.004f);
+    for (auto& p : cloth.particles) {
+        p.position += glm::vec3(jitter(rng), jitter(rng), jitter(rng));
+    }
+
+    const size_t triangleCount = cloth.triangles.size();
+    const size_t vertexCount = cloth.particles.size();
+    printf("\n[triangles] %zu triangles, %zu vertices, %d passes\n", triangleCount, vertexCount, iterations);
+
+    // What each consumer used to do on its own: aero and the triangle normals
+    // both normalize the cross product, the renderer does it once more and
+    // scatters into the vertices.
+    std::vector<float> areas(triangleCount);
+    std::vector<glm::vec3> triNormals(triangleCount);
+    std::vector<glm::vec3> reference;
+    auto separate = [&]() {
+        for (size_t t = 0; t < triangleCount; ++t) {
+            const ClothTriangle& tri = cloth.triangles[t];
+            glm::vec3 n = glm::cross(tri.p2->position - tri.p1->position, tri.p3->position - tri.p1->position);
+            areas[t] = 0.5f * glm::length(n);
+        }
+        for (auto& tri : cloth.triangles) {
+            tri.computeNormal();
+        }
+        const Particle* base = cloth.particles.data();
+        reference.assign(vertexCount, glm::vec3(0.0f));
+        for (const auto& tri : cloth.triangles) {
+            glm::vec3 n = glm::normalize(glm::cross(tri.p2->position - tri.p1->position, tri.p3->position - tri.p1->position));
+            reference[tri.p1 - base] += n;
+            reference[tri.p2 - base] += n;
+            reference[tri.p3 - base] += n;
+        }
+        for (auto& n : reference) n = glm::normalize(n);
+    };
+
+    ClothGeometry geometry;
+    geometry.build(cloth.particles, cloth.triangles);
+    std::vector<glm::vec3> fused;
+    auto fusedPass = [&]() {
+        geometry.update(cloth.particles);
+        geometry.computeVertexNormals(fused);
+    };
+
+    auto timePass = [&](const std::function<void()>& pass) {
+        pass();
+        auto begin = std::chrono::high_resolution_clock::now();
+        for (int it = 0; it < iterations; ++it) pass();
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::milli>(end - begin).count() / iterations;
+    };
+
+    double separateMs = timePass(separate);
+    geometry.useSIMD = false;
+    double scalarMs = timePass(fusedPass);
+    std::vector<glm::vec3> scalarNormals = fused;
+    geometry.useSIMD = true;
+    double simdMs = timePass(fusedPass);
+
+    float maxError = 0.0f;
+    for (size_t v = 0; v < vertexCount; ++v) {
+        maxError = glm::max(maxError, glm::length(fused[v] - reference[v]));
+        maxError = glm::max(maxError, glm::length(scalarNormals[v] - reference[v]));
+    }
+    for (size_t t = 0; t < triangleCount; ++t) {
+        maxError = glm::max(maxError, std::abs(geometry.area[t] - areas[t]));
+        maxError = glm::max(maxError, glm::length(geometry.getNormal(t) - cloth.triangles[t].normal));
+    }
+
+#ifdef CLOTH_GEOMETRY_SSE
+    const char* simdName = "fused SSE";
+#else
+    const char* simdName = "fused (no SSE)";
+#endif
+    printf("%-18s %8.3f ms/pass\n", "three passes", separateMs);
+    printf("%-18s %8.3f ms/pass\n", "fused scalar", scalarMs);
+    printf("%-18s %8.3f ms/pass\n", simdName, simdMs);
+    printf("speedup %.2fx, max difference %g\n", separateMs / simdMs, maxError);
+
+    bool ok = maxError < 1e-4f;
+    if (!ok) printf("FAILED: fused triangle pass disagrees with the separate passes\n");
+    return ok;
+}
+
+bool solverBackends() {
+    const int gridSize = 96;
+    const int steps = 300;
+    const float dt = 0.002f;
+    const ClothBackendType types[] = { ClothBackendType::Scalar, ClothBackendType::SIMD };
+    const int typeCount = sizeof(types) / sizeof(types[0]);
+
+    printf("\n[backends] %dx%d cloth in wind, %d steps, compared to %s\n",
+        gridSize, gridSize, steps, ClothSolverBackend::getTypeName(types[0]));
+
+    std::vector<glm::vec3> reference;
+    bool ok = true;
+    for (int i = 0; i < typeCount; ++i) {
+        Cloth cloth;
+        cloth.initializeRectangularCloth(gridSize, gridSize, 0.02f, glm::vec3(0.0f, 2.0f, 0.0f), 3000.0f, 10.0f, 1.0f);
+        cloth.setGround(-1.0f);
+        cloth.setWind(glm::vec3(1.0f, 0.0f, 2.0f));
+        cloth.setBackend(types[i]);
+        cloth.selfCollision = false;  // same code for every backend, keep it out of the timing
+
+        auto begin = std::chrono::high_resolution_clock::now();
+        for (int step = 0; step < steps; ++step) cloth.update(dt);
+        auto end = std::chrono::high_resolution_clock::now();
+        double msPerStep = std::chrono::duration<double, std::milli>(end - begin).count() / steps;
+
+        float maxError = 0.0f;
+        if (i == 0) {
+            for (const auto& p : cloth.particles) reference.push_back(p.position);
+        }
+        else {
+            for (size_t k = 0; k < reference.size(); ++k) {
+                maxError = glm::max(maxError, glm::length(cloth.particles[k].position - reference[k]));
+            }
+        }
+        bool finite = true;
+        for (const auto& p : cloth.particles) finite = finite && glm::all(glm::equal(p.position, p.position));
+
+        printf("%-22s %8.3f ms/step  max difference %g\n", ClothSolverBackend::getTypeName(types[i]), msPerStep, maxError);
+        if (!finite || maxError > 1e-3f) {
+            printf("FAILED: %s diverges from the reference\n", ClothSolverBackend::getTypeName(types[i]));
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+bool timestepControl() {
+    const float frameDt = 1.0f / 60.0f;
+    const int frames = 120;
+    const float fixedDt = 0.004f;  // the old main loop
+
+    struct Scene { const char* name; float stiffness, damper, spacing; };
+    const Scene scenes[] = {
+        { "stiff (k=30000)", 30000.0f, 10.0f, 0.02f },
+        { "soft (k=300)", 300.0f, 2.0f, 0.05f },
+    };
+
+    printf("\n[timestep] 32x32 cloth, %d frames at 60 Hz\n", frames);
+    printf("%-16s %-9s %10s %10s %12s %12s\n", "scene", "stepping", "steps", "dt ms", "max speed", "ms/frame");
+
+    bool ok = true;
+    int steps[2][2] = {};
+    bool stable[2][2] = {};
+    for (int s = 0; s < 2; ++s) {
+        for (int adaptive = 0; adaptive < 2; ++adaptive) {
+            Cloth cloth;
+            cloth.initializeRectangularCloth(32, 32, scenes[s].spacing, glm::vec3(0.0f, 2.0f, 0.0f),
+                scenes[s].stiffness, scenes[s].damper, 1.0f);
+            cloth.setGround(-10.0f);
+            cloth.setWind(glm::vec3(2.0f, 0.0f, 1.0f));
+            // An exploding cloth would spread over an enormous self-collision grid.
+            cloth.selfCollision = false;
+            std::vector<Cloth*> cloths = { &cloth };
+
+            ClothStepController controller;
+            controller.budgetMs = 1000.0f;  // measure the step choice, not this machine
+            float accumulator = 0.0f;
+            float simulated = 0.0f;
+            float maxSpeed = 0.0f;
+            auto begin = std::chrono::high_resolution_clock::now();
+            for (int frame = 0; frame < frames; ++frame) {
+                if (adaptive) {
+                    controller.advance(cloths, frameDt);
+                    steps[s][adaptive] += controller.stats.substeps;
+                    simulated += controller.stats.simulatedTime;
+                }
+                else {
+                    for (accumulator += frameDt; accumulator >= fixedDt; accumulator -= fixedDt) {
+                        cloth.update(fixedDt);
+                        ++steps[s][adaptive];
+                        simulated += fixedDt;
+                    }
+                }
+                maxSpeed = std::max(maxSpeed, cloth.maxSpeed);
+                if (!std::isfinite(cloth.kineticEnergy) || maxSpeed >= 50.0f) break;
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            double msPerFrame = std::chrono::duration<double, std::milli>(end - begin).count() / frames;
+
+            // A hanging cloth in a light breeze never moves faster than a few m/s.
+            stable[s][adaptive] = std::isfinite(cloth.kineticEnergy) && maxSpeed < 50.0f;
+            float meanDt = steps[s][adaptive] > 0 ? simulated / steps[s][adaptive] : 0.0f;
+            printf("%-16s %-9s %10d %10.3f %12s %12.3f\n", scenes[s].name, adaptive ? "adaptive" : "fixed",
+                steps[s][adaptive], meanDt * 1000.0f,
+                stable[s][adaptive] ? std::to_string(maxSpeed).substr(0, 8).c_str() : "unstable", msPerFrame);
+        }
+    }
+
+    if (!stable[0][1] || !stable[1][1]) {
+        printf("FAILED: adaptive stepping went unstable\n");
+        ok = false;
+    }
+    if (steps[1][1] >= steps[1][0]) {
+        printf("FAILED: adaptive stepping took no fewer steps than fixed stepping on the soft cloth\n");
+        ok = false;
+    }
+    return ok;
+}
+
+bool tethers() {
+    using Clock = std::chrono::high_resolution_clock;
+    bool ok = true;
+
+    printf("\n[tethers] topology builder, bending springs + tethers\n");
+    printf("%10s %12s %12s %14s\n", "particles", "bending ms", "tethers ms", "ns/particle");
+    const int gridSizes[] = { 128, 512, 1024 };
+    double firstNs = 0.0, lastNs = 0.0;
+    for (int n : gridSizes) {
+        Cloth cloth;
+        cloth.initializeRectangularCloth(n, n, 0.01f, glm::vec3(0.0f), 3000.0f, 10.0f, 1.0f);
+
+        auto begin = Clock::now();
+        ClothTopology::addGridBendingSprings(cloth, n, n, 600.0f, 2.0f);
+        auto middle = Clock::now();
+        ClothTopology::buildTethers(cloth);
+        auto end = Clock::now();
+
+        double bendingMs = std::chrono::duration<double, std::milli>(middle - begin).count();
+        double tethersMs = std::chrono::duration<double, std::milli>(end - middle).count();
+        double nsPerParticle = (bendingMs + tethersMs) * 1e6 / cloth.particles.size();
+        if (firstNs == 0.0) firstNs = nsPerParticle;
+        lastNs = nsPerParticle;
+        printf("%10zu %12.3f %12.3f %14.1f\n", cloth.particles.size(), bendingMs, tethersMs, nsPerParticle);
+
+        if (cloth.tethers.size() != cloth.particles.size() - cloth.fixedParticles.size()) {
+            printf("FAILED: expected a tether for every free particle\n");
+            ok = false;
+        }
+    }
+    // Linear time means a flat cost per particle; allow cache effects.
+    if (lastNs > 4.0 * firstNs) {
+        printf("FAILED: builder cost per particle grows with size\n");
+        ok = false;
+    }
+
+    struct Setup { const char* name; float stiffness; bool bending, tethers; };
+    const Setup setups[] = {
+        { "k=3000", 3000.0f, false, false },
+        { "k=3000 + bending", 3000.0f, true, false },
+        { "k=3000 + tethers", 3000.0f, false, true },
+        { "k=30000", 30000.0f, false, false },
+    };
+    const int frames = 180;
+    const float frameDt = 1.0f / 60.0f;
+
+    printf("\n[tethers] 48x48 cloth hanging from two corners, %d frames at 60 Hz\n", frames);
+    printf("%-18s %10s %10s %12s %12s\n", "setup", "substeps", "dt ms", "max strain", "mean strain");
+    float strain[4] = {};
+    for (int s = 0; s < 4; ++s) {
+        Cloth cloth;
+        cloth.bendingSprings = setups[s].bending;
+        cloth.useTethers = setups[s].tethers;
+        cloth.initializeRectangularCloth(48, 48, 0.05f, glm::vec3(0.0f, 2.0f, 0.0f), setups[s].stiffness, 10.0f, 1.0f);
+        cloth.setGround(-10.0f);
+        cloth.selfCollision = false;
+        cloth.ambientDrag = 1.0f;
+        std::vector<Cloth*> cloths = { &cloth };
+
+        ClothStepController controller;
+        controller.budgetMs = 1000.0f;
+        int substeps = 0;
+        for (int frame = 0; frame < frames; ++frame) {
+            controller.advance(cloths, frameDt);
+            substeps += controller.stats.substeps;
+        }
+
+        float maxStrain = 0.0f, sumStrain = 0.0f;
+        for (const auto& spring : cloth.springs) {
+            float value = glm::length(spring.p1->position - spring.p2->position) / spring.restLength - 1.0f;
+            maxStrain = std::max(maxStrain, value);
+            sumStrain += value;
+        }
+        strain[s] = maxStrain;
+        printf("%-18s %10d %10.3f %11.1f%% %11.1f%%\n", setups[s].name, substeps,
+            frames * frameDt / substeps * 1000.0f, maxStrain * 100.0f, sumStrain / cloth.springs.size() * 100.0f);
+    }
+
+    if (!(strain[2] < strain[0])) {
+        printf("FAILED: tethers did not reduce stretching\n");
+        ok = false;
+    }
+    return ok;
+}
+
+bool meshTopology() {
+    using Clock = std::chrono::high_resolution_clock;
+    bool ok = true;
+
+    // Closed tetrahedron: six edges, and every pair of opposite vertices is
+    // itself an edge, so no bending springs.
+    {
+        std::vector<glm::vec3> positions = { glm::vec3(0, 0, 0), glm::vec3(1, 0, 0), glm::vec3(0, 1, 0), glm::vec3(0, 0, 1) };
+        std::vector<Triangle> triangles = { Triangle(0, 2, 1), Triangle(0, 1, 3), Triangle(0, 3, 2), Triangle(1, 2, 3) };
+        Cloth cloth;
+        cloth.bendingSprings = true;
+        if (!cloth.initializeFromMesh(positions, triangles, { 0 }, 3000.0f, 10.0f, 1.0f) ||
+            cloth.springs.size() != 6 || cloth.fixedParticles.size() != 1) {
+            printf("FAILED: tetrahedron should give 6 springs and 1 fixed particle, got %zu\n", cloth.springs.size());
+            ok = false;
+        }
+        triangles.emplace_back(0, 1, 4);
+        if (cloth.initializeFromMesh(positions, triangles, {}, 3000.0f, 10.0f, 1.0f) || cloth.springs.size() != 6) {
+            printf("FAILED: out of range vertex index was accepted\n");
+            ok = false;
+        }
+    }
+
+    // Triangulated n x n grids with the triangles shuffled, as an exported
+    // mesh would list them. A disk has E = V + F - 1 edges.
+    printf("\n[meshtopology] unique edges of a shuffled grid mesh: hash map vs sorting edge keys\n");
+    printf("%10s %10s %12s %12s %12s %10s %14s\n", "triangles", "edges", "hash ms", "sort ms", "init ms", "bending", "hash ns/tri");
+    const int gridSizes[] = { 64, 256, 708 };
+    double firstNs = 0.0, lastNs = 0.0;
+    std::mt19937 rng(7);
+    for (int n : gridSizes) {
+        std::vector<glm::vec3> positions;
+        positions.reserve((size_t)n * n);
+        for (int j = 0; j < n; ++j) {
+            for (int i = 0; i < n; ++i) positions.emplace_back(i * 0.01f, 0.0f, -j * 0.01f);
+        }
+        std::vector<Triangle> triangles;
+        triangles.reserve(2 * (size_t)(n - 1) * (n - 1));
+        for (int j = 0; j < n - 1; ++j) {
+            for (int i = 0; i < n - 1; ++i) {
+                int index = j * n + i;
+                triangles.emplace_back(index, index + n, index + n + 1);
+                triangles.emplace_back(index, index + n + 1, index + 1);
+            }
+        }
+        std::shuffle(triangles.begin(), triangles.end(), rng);
+
+        std::vector<MeshEdge> edges;
+        auto begin = Clock::now();
+        int nonManifold = ClothTopology::findMeshEdges(triangles, edges);
+        auto end = Clock::now();
+        double hashMs = std::chrono::duration<double, std::milli>(end - begin).count();
+
+        // O(T log T) reference: sort every half-edge key and count runs.
+        begin = Clock::now();
+        std::vector<uint64_t> keys;
+        keys.reserve(triangles.size() * 3);
+        for (const Triangle& tri : triangles) {
+            const uint32_t v[3] = { (uint32_t)tri.v0, (uint32_t)tri.v1, (uint32_t)tri.v2 };
+            for (int k = 0; k < 3; ++k) {
+                uint32_t a = std::min(v[k], v[(k + 1) % 3]), b = std::max(v[k], v[(k + 1) % 3]);
+                keys.push_back(((uint64_t)a << 32) | b);
+            }
+        }
+        std::sort(keys.begin(), keys.end());
+        size_t sortedEdges = std::unique(keys.begin(), keys.end()) - keys.begin();
+        end = Clock::now();
+        double sortMs = std::chrono::duration<double, std::milli>(end - begin).count();
+
+        Cloth cloth;
+        cloth.bendingSprings = true;
+        begin = Clock::now();
+        cloth.initializeFromMesh(positions, triangles, { 0, n - 1 }, 3000.0f, 10.0f, 1.0f);
+        end = Clock::now();
+        double initMs = std::chrono::duration<double, std::milli>(end - begin).count();
+        size_t bending = cloth.springs.size() - edges.size();
+
+        double nsPerTriangle = hashMs * 1e6 / triangles.size();
+        if (firstNs == 0.0) firstNs = nsPerTriangle;
+        lastNs = nsPerTriangle;
+        printf("%10zu %10zu %12.3f %12.3f %12.3f %10zu %14.1f\n", triangles.size(), edges.size(), hashMs, sortMs, initMs, bending, nsPerTriangle);
+
+        size_t expectedEdges = positions.size() + triangles.size() - 1;
+        size_t borderEdges = 4 * (size_t)(n - 1);
+        if (edges.size() != expectedEdges || sortedEdges != expectedEdges || nonManifold != 0) {
+            printf("FAILED: expected %zu edges, hash map found %zu, sort found %zu, %d non-manifold\n",
+                expectedEdges, edges.size(), sortedEdges, nonManifold);
+            ok = false;
+        }
+        if (bending == 0 || bending > edges.size() - borderEdges || cloth.tethers.empty()) {
+            printf("FAILED: %zu bending springs for %zu interior edges\n", bending, edges.size() - borderEdges);
+            ok = false;
+        }
+    }
+    // Expected O(T): a flat cost per triangle, allowing for cache misses.
+    if (lastNs > 4.0 * firstNs) {
+        printf("FAILED: edge hashing cost per triangle grows with size\n");
+        ok = false;
+    }
+    return ok;
+}
+
+namespace {
+    // Targets the chain can reach: its effector positions in a random pose.
+    std::vector<glm::vec3> reachableTargets(IKChain& chain, std::mt19937& rng) {
+        std::vector<glm::vec3> rest(chain.size());
+        for (size_t i = 0; i < chain.size(); ++i) {
+            Joint* joint = chain.getJoint(i);
+            rest[i] = joint->pose;
+            if (i > 0) joint->pose = randomPose(joint, rng);  // the root stays put
+        }
+        chain.readPose();
+        std::vector<glm::vec3> targets(chain.getEffectorCount());
+        for (size_t e = 0; e < targets.size(); ++e) targets[e] = chain.getEffectorPosition(e);
+        for (size_t i = 0; i < chain.size(); ++i) chain.getJoint(i)->pose = rest[i];
+        chain.readPose();
+        return targets;
+    }
+
+    struct IKRunStats {
+        int solves = 0, converged = 0, iterations = 0;
+        double seconds = 0.0, error = 0.0;
+    };
+
+    IKRunStats runIK(const IKSystem& ik, IKChain& chain, const std::vector<std::vector<glm::vec3>>& targetSets) {
+        using Clock = std::chrono::high_resolution_clock;
+        IKRunStats stats;
+        for (const auto& targets : targetSets) {
+            chain.readPose();
+            auto begin = Clock::now();
+            IKResult result = ik.solve(chain, targets);
+            stats.seconds += std::chrono::duration<double>(Clock::now() - begin).count();
+            ++stats.solves;
+            stats.converged += result.converged ? 1 : 0;
+            stats.iterations += result.iterations;
+            stats.error += result.error;
+        }
+        return stats;
+    }
+}
+
+bool inverseKinematics() {
+    bool ok = true;
+    std::mt19937 rng(11);
+
+    // The chain must turn Euler poses into rotations exactly like Joint does.
+    for (int i = 0; i < 1000; ++i) {
+        glm::vec3 angles = glm::vec3(std::uniform_real_distribution<float>(-1.5f, 1.5f)(rng),
+            std::uniform_real_distribution<float>(-1.4f, 1.4f)(rng), std::uniform_real_distribution<float>(-1.5f, 1.5f)(rng));
+        glm::quat q = glm::quat(angles);
+        if (std::abs(glm::dot(q, glm::quat(glm::eulerAngles(q)))) < 0.99999f) {
+            printf("FAILED: Euler round trip of (%f, %f, %f)\n", angles.x, angles.y, angles.z);
+            ok = false;
+            break;
+        }
+    }
+
+    // Convergence: an unlimited 8-bone chain must reach every reachable target
+    // within maxIterations.
+    {
+        auto root = std::make_shared<Joint>("root");
+        root->rotXLimit = root->rotYLimit = root->rotZLimit = glm::vec2(-100000.0f, 100000.0f);
+        std::shared_ptr<Joint> tip = root;
+        for (int i = 0; i < 8; ++i) {
+            auto joint = std::make_shared<Joint>("bone" + std::to_string(i));
+            joint->offset = glm::vec3(0.0f, 1.0f, 0.0f);
+            joint->rotXLimit = joint->rotYLimit = joint->rotZLimit = glm::vec2(-100000.0f, 100000.0f);
+            joint->parent = tip.get();
+            tip->addChild(joint);
+            tip = joint;
+        }
+        root->update(glm::mat4(1.0f));
+        Skeleton skeleton(root);
+
+        IKChain chain;
+        chain.build(skeleton, { tip.get() });
+        std::vector<std::vector<glm::vec3>> targetSets;
+        for (int i = 0; i < 500; ++i) targetSets.push_back(reachableTargets(chain, rng));
+
+        printf("\n[ik] unlimited 8-bone chain, %zu reachable targets, tolerance 1e-3 of a bone\n", targetSets.size());
+        printf("%-8s %12s %12s %12s\n", "solver", "converged", "mean iters", "solves/s");
+        const IKSolverType solvers[] = { IKSolverType::CCD, IKSolverType::FABRIK, IKSolverType::JacobianTranspose, IKSolverType::DLS };
+        const int limits[] = { 256, 64, 1024, 64 };
+        for (int s = 0; s < 4; ++s) {
+            IKSystem ik;
+            ik.solver = solvers[s];
+            ik.maxIterations = limits[s];
+            IKRunStats stats = runIK(ik, chain, targetSets);
+            printf("%-8s %11.1f%% %12.1f %12.0f\n", IKSystem::getSolverName(solvers[s]), 100.0 * stats.converged / stats.solves,
+                (double)stats.iterations / stats.solves, stats.solves / stats.seconds);
+            if (stats.converged != stats.solves) {
+                printf("FAILED: %s missed %d targets within %d iterations\n", IKSystem::getSolverName(solvers[s]),
+                    stats.solves - stats.converged, limits[s]);
+                ok = false;
+            }
+        }
+    }
+
+    // dragon.skel with the joint limits of the file: one chain per leaf, and
+    // one multi-effector chain for the limb ends (wrists, tail tip, head).
+    SkeletonParser parser;
+    if (!loadDragon(parser)) {
+        printf("\n[ik] dragon.skel not found, skipping the skeleton chains\n");
+        return ok;
+    }
+    Skeleton& skeleton = parser.getSkeleton();
+    skeleton.buildJointList();
+    std::vector<Joint*> leaves, limbEnds;
+    for (const auto& joint : skeleton.getJointList()) {
+        if (joint->children.empty()) leaves.push_back(joint.get());
+        if (joint->name.rfind("wrist", 0) == 0 || joint->name == "tail_12" || joint->name == "head") limbEnds.push_back(joint.get());
+    }
+
+    std::vector<IKChain> chains(leaves.size() + 1);
+    size_t longest = 0;
+    for (size_t i = 0; i < leaves.size(); ++i) {
+        chains[i].build(skeleton, { leaves[i] });
+        longest = std::max(longest, chains[i].size());
+    }
+    if (limbEnds.empty() || !chains.back().build(skeleton, limbEnds)) {
+        printf("FAILED: no limb ends in dragon.skel\n");
+        return false;
+    }
+
+    printf("\n[ik] dragon.skel: %zu single-effector chains (up to %zu joints) and one %zu-joint chain with %zu limb ends\n",
+        leaves.size(), longest, chains.back().size(), limbEnds.size());
+    printf("%-8s %-10s %12s %12s %12s %12s\n", "solver", "chains", "converged", "mean iters", "mean error", "solves/s");
+    for (IKSolverType type : { IKSolverType::CCD, IKSolverType::FABRIK, IKSolverType::JacobianTranspose, IKSolverType::DLS }) {
+        IKSystem ik;
+        ik.solver = type;
+        for (int multi = 0; multi < 2; ++multi) {
+            IKRunStats total;
+            size_t first = multi ? chains.size() - 1 : 0, last = multi ? chains.size() : chains.size() - 1;
+            for (size_t c = first; c < last; ++c) {
+                std::mt19937 targetRng(100 + (unsigned)c);
+                std::vector<std::vector<glm::vec3>> targetSets;
+                for (int i = 0; i < 200; ++i) targetSets.push_back(reachableTargets(chains[c], targetRng));
+                IKRunStats stats = runIK(ik, chains[c], targetSets);
+                total.solves += stats.solves;
+                total.converged += stats.converged;
+                total.iterations += stats.iterations;
+                total.seconds += stats.seconds;
+                total.error += stats.error;
+            }
+            printf("%-8s %-10s %11.1f%% %12.1f %12.4f %12.0f\n", IKSystem::getSolverName(type), multi ? "limb ends" : "per leaf",
+                100.0 * total.converged / total.solves, (double)total.iterations / total.solves, total.error / total.solves, total.solves / total.seconds);
+        }
+    }
+    return ok;
+}
+
+bool ikCrowd() {
+    using Clock = std::chrono::high_resolution_clock;
+    SkeletonParser parser;
+    if (!loadDragon(parser)) {
+        printf("\n[ikcrowd] dragon.skel not found, skipping\n");
+        return true;
+    }
+    Skeleton& skeleton = parser.getSkeleton();
+    skeleton.buildJointList();
+    std::vector<Joint*> feet;
+    for (const auto& joint : skeleton.getJointList()) {
+        if (joint->name.rfind("wrist", 0) == 0) feet.push_back(joint.get());
+    }
+    IKChain prototype;
+    if (feet.empty() || !prototype.build(skeleton, feet)) {
+        printf("FAILED: no wrists to plant in dragon.skel\n");
+        return false;
+    }
+
+    // Every character plants its feet on its own patch of uneven ground:
+    // foot positions of a pose within 0.25 rad of rest, so all are reachable.
+    const int crowd = 1024;
+    std::vector<IKChain> chains(crowd, prototype);
+    std::vector<IKChain*> pointers;
+    std::vector<std::vector<glm::vec3>> targets(crowd);
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> nudge(-0.25f, 0.25f);
+    for (int c = 0; c < crowd; ++c) {
+        pointers.push_back(&chains[c]);
+        for (size_t i = 1; i < prototype.size(); ++i) {
+            Joint* joint = prototype.getJoint(i);
+            joint->pose = glm::clamp(prototype.getPose(i) + glm::vec3(nudge(rng), nudge(rng), nudge(rng)),
+                glm::vec3(joint->rotXLimit.x, joint->rotYLimit.x, joint->rotZLimit.x),
+                glm::vec3(joint->rotXLimit.y, joint->rotYLimit.y, joint->rotZLimit.y));
+        }
+        chains[c].readPose();
+        for (size_t f = 0; f < feet.size(); ++f) targets[c].push_back(chains[c].getEffectorPosition(f));
+        prototype.writePose();
+        chains[c].readPose();
+    }
+
+    IKSystem ik;
+    ik.solver = IKSolverType::DLS;
+    ik.maxIterations = 64;
+
+    std::vector<IKResult> serial(crowd), batch;
+    auto begin = Clock::now();
+    for (int c = 0; c < crowd; ++c) serial[c] = ik.solve(chains[c], targets[c]);
+    double serialMs = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+
+    std::vector<glm::vec3> serialPoses;
+    for (const IKChain& chain : chains) {
+        for (size_t i = 0; i < chain.size(); ++i) serialPoses.push_back(chain.getPose(i));
+    }
+    for (IKChain& chain : chains) chain.readPose();
+
+    begin = Clock::now();
+    ik.solveBatch(pointers, targets, batch);
+    double batchMs = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+
+    bool ok = true;
+    size_t poseIndex = 0;
+    for (const IKChain& chain : chains) {
+        for (size_t i = 0; i < chain.size(); ++i) {
+            if (chain.getPose(i) != serialPoses[poseIndex++]) ok = false;
+        }
+    }
+    if (!ok) printf("FAILED: batch solve differs from solving one by one\n");
+
+    int converged = 0, iterations = 0;
+    float meanResidual = 0.0f, maxResidual = 0.0f, solveMs = 0.0f;
+    for (const IKResult& result : batch) {
+        converged += result.converged ? 1 : 0;
+        iterations += result.iterations;
+        meanResidual += result.error / crowd;
+        maxResidual = std::max(maxResidual, result.error);
+        solveMs += result.milliseconds;
+    }
+
+    printf("\n[ikcrowd] %d dragons planting %zu feet, DLS on a %zu-joint chain with %zu degrees of freedom\n",
+        crowd, feet.size(), prototype.size(), prototype.getDegreesOfFreedom());
+    printf("converged %.1f%%, mean iterations %.1f, residual mean %.5f max %.5f, %.1f us per solve\n",
+        100.0f * converged / crowd, (double)iterations / crowd, meanResidual, maxResidual, 1000.0f * solveMs / crowd);
+    printf("one by one %.2f ms, batch on %zu threads %.2f ms (%.2fx)\n", serialMs,
+        JobSystem::getInstance().getThreadCount(), batchMs, serialMs / batchMs);
+    if (converged < crowd * 9 / 10) {
+        printf("FAILED: fewer than 90%% of the feet plants converged\n");
+        ok = false;
+    }
+    return ok;
+}
+
+namespace {
+    // World rotation of every joint for the given Euler poses.
+    void worldRotations(const std::vector<std::shared_ptr<Joint>>& joints, const std::vector<glm::vec3>& pose,
+        std::vector<glm::quat>& world) {
+        world.resize(joints.size());
+        for (size_t i = 0; i < joints.size(); ++i) {
+            glm::quat local = glm::quat(pose[i]);
+            size_t parent = 0;
+            while (parent < i && joints[parent].get() != joints[i]->parent) ++parent;
+            world[i] = parent < i ? world[parent] * local : local;
+        }
+    }
+}
+
+bool retargeting() {
+    using Clock = std::chrono::high_resolution_clock;
+    bool ok = true;
+
+    if (Retargeter::normalizeName("L_Hip01") != Retargeter::normalizeName("hip_1_left") ||
+        Retargeter::normalizeName("knee_02_r") == Retargeter::normalizeName("knee_02_l")) {
+        printf("FAILED: joint name normalization\n");
+        ok = false;
+    }
+
+    // Euler triples written back must stay next to the pose they replace:
+    // across +-pi, and when glm::eulerAngles returns the other triple.
+    const glm::vec3 eulerCases[] = { glm::vec3(glm::pi<float>() + 0.02f, 0.1f, -0.1f), glm::vec3(0.5f, 1.8f, -0.4f) };
+    for (const glm::vec3& angles : eulerCases) {
+        glm::vec3 reference = angles - glm::vec3(0.04f, 0.0f, 0.0f);
+        float error = glm::length(nearestEuler(glm::quat(angles), reference) - angles);
+        if (error > 1e-4f) {
+            printf("FAILED: nearestEuler is %.3f rad off (%.2f, %.2f, %.2f)\n", error, angles.x, angles.y, angles.z);
+            ok = false;
+        }
+    }
+
+    std::string sourcePath = findSkeletonResource("wasp_walk.skel");
+    std::string targetPath = findSkeletonResource("wasp_walk_2.skel");
+    std::string animPath = findSkeletonResource("wasp_walk.anim");
+    SkeletonParser sourceParser, targetParser;
+    AnimationClip clip;
+    if (sourcePath.empty() || targetPath.empty() || animPath.empty() || !sourceParser.parseSkeletonFile(sourcePath) ||
+        !targetParser.parseSkeletonFile(targetPath) || !clip.Load(animPath.c_str())) {
+        printf("\n[retarget] wasp_walk skeletons or animation not found, skipping\n");
+        return ok;
+    }
+    Skeleton& source = sourceParser.getSkeleton();
+    Skeleton& target = targetParser.getSkeleton();
+    source.buildJointList();
+    target.buildJointList();
+    auto& sourceJoints = source.getJointList();
+    auto& targetJoints = target.getJointList();
+
+    Retargeter retargeter;
+    auto begin = Clock::now();
+    if (!retargeter.build(source, target)) return false;
+    double buildMs = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+
+    // Sample the walk once; instances play it at different phases.
+    const int frameCount = 120;
+    std::vector<std::vector<glm::vec3>> frames(frameCount);
+    std::vector<glm::vec3> rootOffsets(frameCount);
+    for (int f = 0; f < frameCount; ++f) {
+        clip.Evaluate(clip.rangeStart + (clip.rangeEnd - clip.rangeStart) * f / frameCount, sourceJoints);
+        for (const auto& joint : sourceJoints) frames[f].push_back(joint->pose);
+        rootOffsets[f] = sourceJoints[0]->offset;
+    }
+
+    // A joint turns away from its rest pose by the same world rotation on
+    // both skeletons. The rest pose must map onto the target's rest pose.
+    std::vector<glm::vec3> sourceRest, targetRest, targetPose;
+    for (const auto& joint : sourceJoints) sourceRest.push_back(joint->orginalPos);
+    for (const auto& joint : targetJoints) targetRest.push_back(joint->orginalPos);
+    std::vector<glm::quat> sourceRestWorld, targetRestWorld, sourceWorld, targetWorld;
+    worldRotations(sourceJoints, sourceRest, sourceRestWorld);
+    worldRotations(targetJoints, targetRest, targetRestWorld);
+    float worstRest = 0.0f, worstFrame = 0.0f;
+    glm::vec3 rootOffset;
+    retargeter.retarget(sourceRest, sourceJoints[0]->originOffset, targetPose, rootOffset);
+    for (size_t t = 0; t < targetJoints.size(); ++t) {
+        worstRest = std::max(worstRest, glm::angle(glm::quat(targetPose[t]) * glm::inverse(glm::quat(targetRest[t]))));
+    }
+    for (int f = 0; f < frameCount; f += 7) {
+        retargeter.retarget(frames[f], rootOffsets[f], targetPose, rootOffset);
+        worldRotations(sourceJoints, frames[f], sourceWorld);
+        worldRotations(targetJoints, targetPose, targetWorld);
+        for (size_t t = 0; t < targetJoints.size(); ++t) {
+            int s = retargeter.getSourceJoint(t);
+            if (s < 0) continue;
+            glm::quat sourceDelta = sourceWorld[s] * glm::inverse(sourceRestWorld[s]);
+            glm::quat targetDelta = targetWorld[t] * glm::inverse(targetRestWorld[t]);
+            worstFrame = std::max(worstFrame, glm::angle(targetDelta * glm::inverse(sourceDelta)));
+        }
+    }
+
+    // Played in order, twice round the loop and then with the root spun a
+    // full turn, no angle may jump by anything like the half turn of a
+    // flipped triple.
+    float largestStep = 0.0f;
+    std::vector<glm::vec3> previous = targetPose, spun = frames[0];
+    const int spinSteps = 90;
+    for (int f = 0; f < 2 * frameCount + spinSteps; ++f) {
+        const std::vector<glm::vec3>* frame = &frames[f % frameCount];
+        if (f >= 2 * frameCount) {
+            spun[0] = frames[0][0] + glm::vec3(glm::two_pi<float>() * (f - 2 * frameCount) / spinSteps, 0.0f, 0.0f);
+            frame = &spun;
+        }
+        retargeter.retarget(*frame, rootOffsets[f % frameCount], targetPose, rootOffset);
+        for (size_t t = 0; t < targetJoints.size(); ++t) {
+            glm::vec3 step = glm::abs(targetPose[t] - previous[t]);
+            largestStep = std::max(largestStep, std::max(step.x, std::max(step.y, step.z)));
+        }
+        previous = targetPose;
+    }
+
+    // A frame of another skeleton is refused, not read out of bounds.
+    std::vector<glm::vec3> wrongSize(sourceJoints.size() - 1, glm::vec3(0.0f)), untouched = targetPose;
+    bool refused = !retargeter.retarget(wrongSize, rootOffsets[0], targetPose, rootOffset) && targetPose == untouched;
+
+    printf("\n[retarget] wasp_walk.skel -> wasp_walk_2.skel, %zu of %zu joints mapped, built in %.3f ms\n",
+        retargeter.getMappedCount(), targetJoints.size(), buildMs);
+    printf("rest pose error %.2e rad, world rotation error over the walk %.2e rad\n", worstRest, worstFrame);
+    printf("largest Euler angle step between frames %.3f rad\n", largestStep);
+    if (retargeter.getMappedCount() != targetJoints.size() || worstRest > 1e-3f || worstFrame > 1e-3f) {
+        printf("FAILED: retargeted poses do not follow the source\n");
+        ok = false;
+    }
+    if (largestStep > 1.0f) {
+        printf("FAILED: retargeted Euler angles flip between frames\n");
+        ok = false;
+    }
+    if (!refused) {
+        printf("FAILED: a source pose of the wrong size was retargeted\n");
+        ok = false;
+    }
+
+    // Throughput: many instances per frame, precomputed map against
+    // rebuilding the map for every instance.
+    const int instances = 500, steps = 60;
+    std::vector<std::vector<glm::vec3>> instancePoses(instances);
+    std::vector<glm::vec3> instanceRoots(instances);
+    begin = Clock::now();
+    for (int step = 0; step < steps; ++step) {
+        for (int i = 0; i < instances; ++i) {
+            int f = (step + i * 7) % frameCount;
+            retargeter.retarget(frames[f], rootOffsets[f], instancePoses[i], instanceRoots[i]);
+        }
+    }
+    double mappedUs = std::chrono::duration<double, std::micro>(Clock::now() - begin).count() / (steps * instances);
+
+    const int rebuilds = 200;
+    begin = Clock::now();
+    for (int i = 0; i < rebuilds; ++i) {
+        Retargeter fresh;
+        fresh.build(source, target);
+        fresh.retarget(frames[i % frameCount], rootOffsets[i % frameCount], instancePoses[0], instanceRoots[0]);
+    }
+    double rebuildUs = std::chrono::duration<double, std::micro>(Clock::now() - begin).count() / rebuilds;
+
+    printf("%-28s %12s %18s\n", "", "us/instance", "instances/16ms");
+    printf("%-28s %12.2f %18.0f\n", "precomputed map", mappedUs, 16000.0 / mappedUs);
+    printf("%-28s %12.2f %18.0f\n", "map rebuilt per instance", rebuildUs, 16000.0 / rebuildUs);
+    return ok;
+}
+
+bool blending() {
+    using Clock = std::chrono::high_resolution_clock;
+    bool ok = true;
+
+    std::string skelPath = findSkeletonResource("wasp_walk.skel");
+    std::string animPath = findSkeletonResource("wasp_walk.anim");
+    SkeletonParser parser;
+    AnimationClip walk;
+    if (skelPath.empty() || animPath.empty() || !parser.parseSkeletonFile(skelPath) || !walk.Load(animPath.c_str())) {
+        printf("\n[blend] wasp_walk skeleton or animation not found, skipping\n");
+        return true;
+    }
+    Skeleton& skeleton = parser.getSkeleton();
+    skeleton.buildJointList();
+    auto& joints = skeleton.getJointList();
+    // A second clip for the blend tree: a copy of the walk, which joins the
+    // tree at another phase and plays at another speed.
+    AnimationClip shifted = walk;
+    const float period = walk.rangeEnd - walk.rangeStart;
+
+    // One clip on one layer must reproduce sampling the clip directly.
+    AnimationBlender blender;
+    blender.initialize(skeleton, 2);
+    blender.getLayer(0).crossfade(&walk, 0.0f);
+    float worstSingle = 0.0f;
+    for (int f = 1; f <= 20; ++f) {
+        const float dt = period / 23.0f;
+        blender.update(dt);
+        std::vector<glm::vec3> before;
+        for (const auto& joint : joints) before.push_back(joint->pose);
+        const AnimationPose& pose = blender.evaluate();
+        for (size_t j = 0; j < joints.size(); ++j) {
+            if (joints[j]->pose != before[j]) {
+                printf("FAILED: evaluate() wrote to joint %zu\n", j);
+                return false;
+            }
+        }
+        float time = walk.rangeStart + std::fmod(f * dt, period);
+        walk.Evaluate(time, joints);
+        for (size_t j = 0; j < joints.size(); ++j) {
+            worstSingle = std::max(worstSingle, glm::angle(pose.rotations[j] * glm::inverse(glm::quat(joints[j]->pose))));
+        }
+    }
+
+    // Two layers: a base layer crossfading between the clips and an upper
+    // layer masked to half the body, with its blend weights changing.
+    AnimationLayer& upper = blender.getLayer(1);
+    upper.weight = 0.6f;
+    upper.setMask(skeleton, skeleton.getRoot().get(), 0.0f);
+    upper.setMask(skeleton, joints[joints.size() / 2].get(), 1.0f);
+    upper.setClipWeight(&shifted, 1.0f);
+    upper.setClipWeight(&walk, 0.5f);
+
+    const float dt = 1.0f / 60.0f;
+    auto frame = [&](int f) {
+        if (f % 45 == 0) blender.getLayer(0).crossfade((f / 45) % 2 ? &shifted : &walk, 0.3f, (f / 45) % 2 ? 1.3f : 1.0f);
+        if (f % 20 == 0) upper.setClipWeight(&walk, 0.25f + 0.5f * ((f / 20) % 2), 0.2f);
+        blender.update(dt);
+        blender.apply(joints);
+    };
+    for (int f = 0; f < 120; ++f) frame(f);  // warm up: first crossfades, every entry slot used once
+
+    const int frames = 20000;
+    size_t allocationsBefore = AllocationCounter::getCount();
+    auto begin = Clock::now();
+    for (int f = 120; f < 120 + frames; ++f) frame(f);
+    double blendUs = std::chrono::duration<double, std::micro>(Clock::now() - begin).count() / frames;
+    size_t allocations = AllocationCounter::getCount() - allocationsBefore;
+
+    // Reference: the clip written straight into the joints, as before blending.
+    begin = Clock::now();
+    for (int f = 0; f < frames; ++f) walk.Evaluate(walk.rangeStart + std::fmod(f * dt, period), joints);
+    double directUs = std::chrono::duration<double, std::micro>(Clock::now() - begin).count() / frames;
+
+    bool finite = true;
+    for (const auto& joint : joints) finite = finite && std::isfinite(joint->pose.x + joint->pose.y + joint->pose.z);
+
+    printf("\n[blend] wasp_walk, %zu joints, 2 layers (upper masked), crossfade every 45 frames\n", joints.size());
+    printf("single clip vs direct sampling: worst joint error %.2e rad\n", worstSingle);
+    printf("steady state: pose pool %zu buffers, grown %zu times; ", blender.getPool().getCapacity(), blender.getPool().getGrowCount());
+    if (AllocationCounter::isEnabled()) printf("%zu heap allocations in %d frames\n", allocations, frames);
+    else printf("heap allocations not counted in this build\n");
+    printf("%-28s %12s\n", "", "us/frame");
+    printf("%-28s %12.2f\n", "blend tree + layers", blendUs);
+    printf("%-28s %12.2f\n", "single clip, direct", directUs);
+    if (worstSingle > 1e-4f) {
+        printf("FAILED: single clip blend does not match the clip\n");
+        ok = false;
+    }
+    if (allocations != 0 || blender.getPool().getGrowCount() != 0 || !finite) {
+        printf("FAILED: blending allocates in steady state or produced invalid poses\n");
+        ok = false;
+    }
+    if (!AllocationCounter::isEnabled()) {
+        printf("FAILED: cannot check for steady-state allocations, rebuild with -DBENCHMARK_ALLOCATION_COUNTING\n");
+        ok = false;
+    }
+    return ok;
+}
+
+bool posePipeline() {
+    using Clock = std::chrono::high_resolution_clock;
+    SkeletonParser parser;
+    if (!loadDragon(parser)) {
+        printf("\n[posepipeline] dragon.skel not found, skipping\n");
+        return true;
+    }
+    Skeleton& skeleton = parser.getSkeleton();
+    skeleton.buildJointList();
+    skeleton.setPosition(glm::vec3(0.5f, -1.0f, 2.0f));
+    skeleton.setRotation(glm::angleAxis(0.7f, glm::normalize(glm::vec3(1.0f, 2.0f, -0.5f))));
+    auto& joints = skeleton.getJointList();
+    const glm::mat4 base = glm::translate(glm::mat4(1.0f), skeleton.getPosition()) * glm::mat4_cast(skeleton.getRotation());
+
+    const int poseCount = 64;
+    std::mt19937 rng(45);
+    std::vector<std::vector<glm::vec3>> poses(poseCount);
+    for (auto& pose : poses) {
+        for (const auto& joint : joints) pose.push_back(randomPose(joint.get(), rng));
+    }
+    auto setPose = [&](int p) {
+        for (size_t j = 0; j < joints.size(); ++j) joints[j]->pose = poses[p][j];
+    };
+
+    // Same world matrices as the recursive Euler -> mat4 path.
+    float worstDifference = 0.0f;
+    std::vector<glm::mat4> legacy(joints.size());
+    for (int p = 0; p < poseCount; ++p) {
+        setPose(p);
+        skeleton.getRoot()->update(base);
+        for (size_t j = 0; j < joints.size(); ++j) {
+            legacy[j] = joints[j]->worldMatrix;
+            joints[j]->worldMatrix = glm::mat4(0.0f);
+        }
+        skeleton.invalidate();
+        skeleton.update();
+        for (size_t j = 0; j < joints.size(); ++j) {
+            for (int c = 0; c < 4; ++c) {
+                glm::vec4 d = glm::abs(legacy[j][c] - joints[j]->worldMatrix[c]);
+                worstDifference = std::max(worstDifference, std::max(std::max(d.x, d.y), std::max(d.z, d.w)));
+            }
+        }
+    }
+
+    const int rounds = 20000;
+    auto begin = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        setPose(r % poseCount);
+        skeleton.getRoot()->update(base);
+    }
+    double legacyNs = std::chrono::duration<double, std::nano>(Clock::now() - begin).count() / (double(rounds) * joints.size());
+    begin = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        setPose(r % poseCount);
+        skeleton.update();
+    }
+    double pipelineNs = std::chrono::duration<double, std::nano>(Clock::now() - begin).count() / (double(rounds) * joints.size());
+
+    printf("\n[posepipeline] dragon.skel, %zu joints, %d random poses\n", joints.size(), poseCount);
+    printf("largest world matrix difference against the recursive path: %.2e\n", worstDifference);
+    printf("%-36s %10s\n", "", "ns/joint");
+    printf("%-36s %10.1f\n", "recursive, clamp + Euler -> 4x4", legacyNs);
+    printf("%-36s %10.1f\n", "flat quat + translation, affine 3x4", pipelineNs);
+    if (worstDifference > 1e-4f) {
+        printf("FAILED: pose pipeline world matrices differ from the recursive path\n");
+        return false;
+    }
+    return true;
+}
+
+bool dirtyUpdate() {
+    using Clock = std::chrono::high_resolution_clock;
+    SkeletonParser parser;
+    if (!loadDragon(parser)) {
+        printf("\n[dirtyupdate] dragon.skel not found, skipping\n");
+        return true;
+    }
+    Skeleton& skeleton = parser.getSkeleton();
+    skeleton.buildJointList();
+    auto& joints = skeleton.getJointList();
+    bool ok = true;
+
+    // Subtree sizes, to know how many joints an edit should touch.
+    std::vector<size_t> subtree(joints.size(), 1);
+    for (size_t i = joints.size(); i-- > 1;) {
+        for (size_t p = i; p-- > 0;) {
+            if (joints[p].get() == joints[i]->parent) {
+                subtree[p] += subtree[i];
+                break;
+            }
+        }
+    }
+
+    std::mt19937 rng(46);
+    skeleton.update();
+    size_t first = skeleton.getRecomputedCount();
+    skeleton.update();
+    size_t idle = skeleton.getRecomputedCount();
+
+    // Edit single joints as the UI sliders would, and check the matrices
+    // against a full recompute after every edit.
+    size_t expectedTotal = 0, recomputedTotal = 0;
+    float worstDifference = 0.0f;
+    std::vector<glm::mat4> incremental(joints.size());
+    for (int edit = 0; edit < 200; ++edit) {
+        size_t j = std::uniform_int_distribution<size_t>(0, joints.size() - 1)(rng);
+        joints[j]->pose = randomPose(joints[j].get(), rng);
+        skeleton.update();
+        expectedTotal += subtree[j];
+        recomputedTotal += skeleton.getRecomputedCount();
+        for (size_t k = 0; k < joints.size(); ++k) incremental[k] = joints[k]->worldMatrix;
+        skeleton.invalidate();
+        skeleton.update();
+        for (size_t k = 0; k < joints.size(); ++k) {
+            for (int c = 0; c < 4; ++c) {
+                glm::vec4 d = glm::abs(incremental[k][c] - joints[k]->worldMatrix[c]);
+                worstDifference = std::max(worstDifference, std::max(std::max(d.x, d.y), std::max(d.z, d.w)));
+            }
+        }
+    }
+
+    // Cost per update: nothing changed (paused), one leaf edited, everything changed.
+    const int rounds = 100000;
+    size_t leaf = joints.size() - 1;
+    auto timeUpdates = [&](const std::function<void(int)>& change) {
+        auto begin = Clock::now();
+        for (int r = 0; r < rounds; ++r) {
+            change(r);
+            skeleton.update();
+        }
+        return std::chrono::duration<double, std::micro>(Clock::now() - begin).count() / rounds;
+    };
+    double idleUs = timeUpdates([](int) {});
+    double leafUs = timeUpdates([&](int r) { joints[leaf]->pose.x = (r & 1) ? 0.1f : 0.2f; });
+    double fullUs = timeUpdates([&](int) { skeleton.invalidate(); });
+
+    printf("\n[dirtyupdate] dragon.skel, %zu joints\n", joints.size());
+    printf("first update %zu joints, unchanged update %zu joints\n", first, idle);
+    printf("200 single-joint edits: %zu joints recomputed, %zu in the edited subtrees, largest difference %.2e\n",
+        recomputedTotal, expectedTotal, worstDifference);
+    printf("%-28s %10s\n", "", "us/update");
+    printf("%-28s %10.3f\n", "nothing changed", idleUs);
+    printf("%-28s %10.3f\n", "one leaf edited", leafUs);
+    printf("%-28s %10.3f\n", "every joint", fullUs);
+    if (first != joints.size() || idle != 0 || recomputedTotal > expectedTotal || worstDifference > 0.0f) {
+        printf("FAILED: dirty tracking recomputed the wrong joints\n");
+        ok = false;
+    }
+    return ok;
+}
+
+namespace {
+    // Synthetic take: keys every 0.2 s of channel time with smooth values.
+    const float SYNTHETIC_KEY_STEP = 0.2f;
+
+    StreamKey syntheticKey(size_t channel, long long k) {
+        float phase = 0.05f * (float)(k % 100000) + (float)channel;
+        return { (float)k * SYNTHETIC_KEY_STEP, 0.5f * std::sin(phase), 0.1f * std::cos(phase), 0.1f * std::cos(phase) };
+    }
+
+    float syntheticValue(size_t channel, float time) {
+        long long k = (long long)(time / SYNTHETIC_KEY_STEP);
+        while ((float)(k + 1) * SYNTHETIC_KEY_STEP <= time) ++k;
+        while (k > 0 && (float)k * SYNTHETIC_KEY_STEP > time) --k;
+        StreamKey k0 = syntheticKey(channel, k), k1 = syntheticKey(channel, k + 1);
+        float dt = k1.time - k0.time;
+        float s = (time - k0.time) / dt;
+        float h00 = 2 * s * s * s - 3 * s * s + 1;
+        float h10 = s * s * s - 2 * s * s + s;
+        float h01 = -2 * s * s * s + 3 * s * s;
+        float h11 = s * s * s - s * s;
+        return h00 * k0.value + h10 * dt * k0.outTangent + h01 * k1.value + h11 * dt * k1.inTangent;
+    }
+
+    float poseDifference(const AnimationPose& a, const AnimationPose& b) {
+        float worst = glm::length(a.rootTranslation - b.rootTranslation);
+        for (size_t j = 0; j < a.rotations.size(); ++j) {
+            worst = std::max(worst, glm::angle(a.rotations[j] * glm::inverse(b.rotations[j])));
+        }
+        return worst;
+    }
+}
+
+bool streamingClip() {
+    using Clock = std::chrono::high_resolution_clock;
+    namespace fs = std::filesystem;
+    bool ok = true;
+
+    // wasp_walk converted: streaming playback matches the loaded clip.
+    std::string animPath = findSkeletonResource("wasp_walk.anim");
+    AnimationClip walk;
+    if (!animPath.empty() && walk.Load(animPath.c_str())) {
+        std::string walkPath = (fs::temp_directory_path() / "wasp_walk.sclip").string();
+        StreamingClip streamed;
+        if (!StreamingClip::convert(walk, walkPath, 0.5f) || !streamed.open(walkPath)) return false;
+        AnimationPose expected, actual;
+        expected.rotations.resize(walk.channels.size() / 3 - 1);
+        actual.rotations.resize(expected.rotations.size());
+        float worst = 0.0f;
+        std::mt19937 rng(47);
+        std::uniform_real_distribution<float> anyTime(walk.rangeStart, walk.rangeEnd);
+        for (int i = 0; i < 2000; ++i) {
+            float time = i < 1000 ? walk.rangeStart + (walk.rangeEnd - walk.rangeStart) * i / 1000.0f : anyTime(rng);
+            walk.Evaluate(time, expected);
+            if (!streamed.Evaluate(time, actual)) return false;
+            worst = std::max(worst, poseDifference(expected, actual));
+        }
+        printf("\n[streaming] wasp_walk.anim as %zu windows: largest difference from the loaded clip %.2e\n",
+            streamed.getChunkCount(), worst);
+        if (worst > 1e-4f) {
+            printf("FAILED: streamed wasp_walk differs from the loaded clip\n");
+            ok = false;
+        }
+        streamed.close();
+        fs::remove(walkPath);
+    }
+
+    // Synthetic 10 hour take, written window by window.
+    const float hours = 10.0f;
+    const float clipSeconds = hours * 3600.0f;
+    const float window = 2.0f;  // channel time; one second of clip time
+    const size_t joints = 3, channels = (joints + 1) * 3;
+    std::string path = (fs::temp_directory_path() / "synthetic_10h.sclip").string();
+
+    auto begin = Clock::now();
+    StreamingClipWriter writer;
+    if (!writer.open(path, channels, 0.0f, clipSeconds)) return false;
+    std::vector<std::vector<StreamKey>> windowKeys(channels);
+    const int windowCount = (int)(clipSeconds * 2 / window);
+    for (int w = 0; w < windowCount; ++w) {
+        float start = w * window, end = (w + 1) * window;
+        long long first = (long long)std::floor(start / SYNTHETIC_KEY_STEP);
+        long long last = (long long)std::ceil(end / SYNTHETIC_KEY_STEP);
+        while ((float)first * SYNTHETIC_KEY_STEP > start) --first;
+        while ((float)last * SYNTHETIC_KEY_STEP < end) ++last;
+        for (size_t c = 0; c < channels; ++c) {
+            windowKeys[c].clear();
+            for (long long k = first; k <= last; ++k) windowKeys[c].push_back(syntheticKey(c, k));
+        }
+        if (!writer.addWindow(start, end, windowKeys)) return false;
+    }
+    if (!writer.finish()) return false;
+    double writeSeconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    double fileMb = fs::file_size(path) / (1024.0 * 1024.0);
+
+    StreamingClip clip;
+    if (!clip.open(path)) return false;
+    AnimationPose pose;
+    pose.rotations.resize(joints);
+
+    // Play the whole take at 30 frames a second, as fast as possible.
+    const float dt = 1.0f / 30.0f;
+    const long long frames = (long long)(clipSeconds / dt);
+    size_t residentMinute = 0, residentHour = 0, allocationsBefore = 0;
+    float worstPlayback = 0.0f;
+    bool failedRead = false;
+    begin = Clock::now();
+    for (long long f = 0; f < frames; ++f) {
+        float time = (float)((double)f * dt);
+        if (!clip.Evaluate(time, pose)) {
+            failedRead = true;
+            break;
+        }
+        if (f % 997 == 0) {
+            float channelTime = time * 2;
+            worstPlayback = std::max(worstPlayback, std::abs(pose.rootTranslation.x - syntheticValue(0, channelTime)));
+            worstPlayback = std::max(worstPlayback, std::abs(pose.rootTranslation.z - syntheticValue(2, channelTime)));
+        }
+        if (f == (long long)(60.0f / dt)) {
+            residentMinute = clip.getResidentBytes();
+            allocationsBefore = AllocationCounter::getCount();
+        }
+        if (f == (long long)(3600.0f / dt)) residentHour = clip.getResidentBytes();
+    }
+    double playSeconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    size_t allocations = AllocationCounter::getCount() - allocationsBefore;
+    size_t residentEnd = clip.getResidentBytes();
+    StreamingClip::Stats played = clip.getStats();
+
+    // Random seeks.
+    const int seeks = 2000;
+    std::mt19937 rng(470);
+    std::uniform_real_distribution<float> anyTime(0.0f, clipSeconds);
+    begin = Clock::now();
+    for (int i = 0; i < seeks && !failedRead; ++i) failedRead = !clip.Evaluate(anyTime(rng), pose);
+    double seekUs = std::chrono::duration<double, std::micro>(Clock::now() - begin).count() / seeks;
+    StreamingClip::Stats afterSeeks = clip.getStats();
+    clip.close();
+    fs::remove(path);
+
+    printf("\n[streaming] synthetic %.0f h take, %zu channels, %d windows, %.1f MB file written in %.2f s\n",
+        hours, channels, windowCount, fileMb, writeSeconds);
+    printf("played %lld frames in %.2f s: %zu windows loaded, %zu stalls (the benchmark outruns real time), "
+        "%.1f us per window load\n", frames, playSeconds, played.chunksLoaded, played.stalls,
+        1e6 * played.loadSeconds / std::max<size_t>(1, played.chunksLoaded));
+    printf("resident window memory: %zu bytes after 1 min, %zu after 1 h, %zu after %.0f h\n",
+        residentMinute, residentHour, residentEnd, hours);
+    if (AllocationCounter::isEnabled()) printf("heap allocations after the first minute: %zu; ", allocations);
+    else printf("heap allocations not counted in this build; ");
+    printf("largest playback error %.2e\n", worstPlayback);
+    printf("%d random seeks: %.1f us each, %.1f index entries read per seek (log2 of %d windows = %.1f)\n",
+        seeks, seekUs, (double)(afterSeeks.indexReads - played.indexReads - (afterSeeks.chunksLoaded - played.chunksLoaded)) / seeks,
+        windowCount, std::log2((double)windowCount));
+    if (failedRead || residentHour != residentMinute || residentEnd != residentMinute || allocations != 0 || worstPlayback > 1e-4f) {
+        printf("FAILED: streaming playback is not bounded or not correct\n");
+        ok = false;
+    }
+    return ok;
+}
+
+bool assetLoading() {
+    using Clock = std::chrono::high_resolution_clock;
+    std::string skelPath = findSkeletonResource("wasp.skel");
+    std::string skinPath = findSkeletonResource("wasp.skin");
+    std::string animPath = findSkeletonResource("wasp_walk.anim");
+    if (skelPath.empty() || skinPath.empty() || animPath.empty()) {
+        printf("\n[assetload] wasp assets not found, skipping\n");
+        return true;
+    }
+
+    // Startup as before (one asset after the other) against all three at once.
+    const int runs = 20;
+    double sequentialMs = 0.0, parallelMs = 0.0;
+    size_t joints = 0, vertices = 0, channels = 0;
+    bool same = true;
+    for (int run = 0; run < runs; ++run) {
+        AssetLoader sequential;
+        auto begin = Clock::now();
+        auto skeleton = sequential.loadSkeleton(skelPath).get();
+        auto skin = sequential.loadSkin(skinPath).get();
+        auto clip = sequential.loadAnimation(animPath).get();
+        sequentialMs += std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+        if (!skeleton || !skin || !clip) {
+            printf("FAILED: wasp assets did not load\n");
+            return false;
+        }
+
+        AssetLoader parallel;
+        begin = Clock::now();
+        auto pendingSkeleton = parallel.loadSkeleton(skelPath);
+        auto pendingSkin = parallel.loadSkin(skinPath);
+        auto pendingClip = parallel.loadAnimation(animPath);
+        auto skeleton2 = pendingSkeleton.get();
+        auto skin2 = pendingSkin.get();
+        auto clip2 = pendingClip.get();
+        parallelMs += std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+        same = same && skeleton2 && skin2 && clip2 &&
+            skeleton2->getJointList().size() == skeleton->getJointList().size() &&
+            skin2->vertices.size() == skin->vertices.size() && skin2->triangles.size() == skin->triangles.size() &&
+            clip2->channels.size() == clip->channels.size();
+        joints = skeleton->getJointList().size();
+        vertices = skin->vertices.size();
+        channels = clip->channels.size();
+        if (run == runs - 1) {
+            printf("\n[assetload] wasp.skel (%zu joints), wasp.skin (%zu vertices), wasp_walk.anim (%zu channels)\n",
+                joints, vertices, channels);
+            parallel.printReport();
+        }
+    }
+    printf("%-28s %12s\n", "", "ms/startup");
+    printf("%-28s %12.2f\n", "one after the other", sequentialMs / runs);
+    printf("%-28s %12.2f\n", "concurrent", parallelMs / runs);
+    if (!same) {
+        printf("FAILED: concurrent loading gave different assets\n");
+        return false;
+    }
+    return true;
+}
+
+namespace {
+    bool sameSkin(const Skin& a, const Skin& b) {
+        if (a.vertices.size() != b.vertices.size() || a.triangles.size() != b.triangles.size() ||
+            a.bindingMats != b.bindingMats) return false;
+        for (size_t i = 0; i < a.vertices.size(); ++i) {
+            const SkinVertex& u = a.vertices[i];
+            const SkinVertex& v = b.vertices[i];
+            if (u.position != v.position || u.normal != v.normal || u.weights.size() != v.weights.size()) return false;
+            for (size_t j = 0; j < u.weights.size(); ++j) {
+                if (u.weights[j].jointIndex != v.weights[j].jointIndex || u.weights[j].weight != v.weights[j].weight) return false;
+            }
+        }
+        for (size_t i = 0; i < a.triangles.size(); ++i) {
+            const Triangle& s = a.triangles[i];
+            const Triangle& t = b.triangles[i];
+            if (s.v0 != t.v0 || s.v1 != t.v1 || s.v2 != t.v2) return false;
+        }
+        return true;
+    }
+
+    // A width x height grid in the layout of the exported .skin files, one to
+    // four weights per vertex over 'joints' bindings.
+    bool writeSyntheticSkin(const std::string& path, int width, int height, int joints) {
+        FILE* file = fopen(path.c_str(), "w");
+        if (!file) return false;
+        const int vertexCount = width * height;
+        std::mt19937 rng(49);
+        std::uniform_real_distribution<float> jitter(-0.05f, 0.05f);
+        fprintf(file, "positions %d {\n", vertexCount);
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                fprintf(file, "\t%9.3f%9.3f%9.3f\n", x * 0.01f, y * 0.01f, jitter(rng));
+            }
+        }
+        fprintf(file, "}\nnormals %d {\n", vertexCount);
+        for (int i = 0; i < vertexCount; ++i) {
+            glm::vec3 n = glm::normalize(glm::vec3(jitter(rng), jitter(rng), 1.0f));
+            fprintf(file, "\t%9.3f%9.3f%9.3f\n", n.x, n.y, n.z);
+        }
+        fprintf(file, "}\nskinweights %d {\n", vertexCount);
+        for (int i = 0; i < vertexCount; ++i) {
+            const int count = 1 + i % 4;
+            fprintf(file, "\t%d", count);
+            for (int j = 0; j < count; ++j) fprintf(file, " %d %.3f", (i / width + j) % joints, 1.0f / count);
+            fprintf(file, "\n");
+        }
+        fprintf(file, "}\ntriangles %d {\n", 2 * (width - 1) * (height - 1));
+        for (int y = 0; y + 1 < height; ++y) {
+            for (int x = 0; x + 1 < width; ++x) {
+                const int v = y * width + x;
+                fprintf(file, "\t%d %d %d\n\t%d %d %d\n", v, v + 1, v + width + 1, v, v + width + 1, v + width);
+            }
+        }
+        fprintf(file, "}\nbindings %d {\n", joints);
+        for (int j = 0; j < joints; ++j) {
+            fprintf(file, "\tmatrix {\n\t\t%9.3f%9.3f%9.3f\n\t\t%9.3f%9.3f%9.3f\n\t\t%9.3f%9.3f%9.3f\n\t\t%9.3f%9.3f%9.3f\n\t}\n",
+                1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, -0.1f * j, 0.0f);
+        }
+        fprintf(file, "}\n");
+        return fclose(file) == 0;
+    }
+}
+
+bool skinParsing() {
+    using Clock = std::chrono::high_resolution_clock;
+    namespace fs = std::filesystem;
+    bool ok = true;
+
+    // The shipped skins: identical to the Tokenizer path.
+    for (const char* name : { "tube.skin", "wasp.skin" }) {
+        std::string path = findSkeletonResource(name);
+        if (path.empty()) continue;
+        Skin expected, actual;
+        SkinParser parser;
+        if (!expected.loadFromFile(path) || !parser.parseSkinFile(path, actual) || !sameSkin(expected, actual)) {
+            printf("FAILED: %s parses differently\n", name);
+            ok = false;
+        }
+    }
+
+    const int width = 1000, height = 2000, joints = 24;
+    std::string path = (fs::temp_directory_path() / "synthetic_skin.skin").string();
+    if (!writeSyntheticSkin(path, width, height, joints)) return false;
+    const double megabytes = fs::file_size(path) / (1024.0 * 1024.0);
+
+    Skin expected;
+    auto begin = Clock::now();
+    bool loaded = expected.loadFromFile(path);
+    const double tokenizerMs = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+
+    const int runs = 3;
+    double parallelMs = 0.0;
+    SkinParser parser;
+    Skin actual;
+    for (int run = 0; run < runs && loaded; ++run) {
+        begin = Clock::now();
+        loaded = parser.parseSkinFile(path, actual);
+        parallelMs += std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+    }
+    parallelMs /= runs;
+    fs::remove(path);
+    if (!loaded) {
+        printf("FAILED: synthetic skin did not load\n");
+        return false;
+    }
+
+    const SkinParser::Stats& stats = parser.getStats();
+    printf("\n[skinparse] synthetic skin: %zu vertices, %zu triangles, %zu bindings, %.1f MB; %zu threads\n",
+        actual.vertices.size(), actual.triangles.size(), actual.bindingMats.size(), megabytes,
+        JobSystem::getInstance().getThreadCount());
+    printf("%-28s %10s %10s\n", "", "ms", "MB/s");
+    printf("%-28s %10.1f %10.1f\n", "Tokenizer", tokenizerMs, megabytes * 1000.0 / tokenizerMs);
+    printf("%-28s %10.1f %10.1f   (read %.1f ms, %zu chunks)\n", "SkinParser", parallelMs,
+        megabytes * 1000.0 / parallelMs, stats.readMilliseconds, stats.chunks);
+    if (!sameSkin(expected, actual)) {
+        printf("FAILED: chunked parse differs from the Tokenizer\n");
+        ok = false;
+    }
+    return ok;
+}
+
+namespace {
+    // Poll the reloader like the frame loop does until something arrives or
+    // 'timeout' passes; returns the reloads and the wait in ms.
+    std::vector<HotReloader::Reload> waitForReloads(HotReloader& reloader, double timeoutMs, double& waitedMs) {
+        auto begin = std::chrono::steady_clock::now();
+        std::vector<HotReloader::Reload> reloads;
+        while (true) {
+            for (HotReloader::Reload& reload : reloader.poll()) reloads.push_back(std::move(reload));
+            waitedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+            if (!reloads.empty() || waitedMs > timeoutMs) return reloads;
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    }
+
+    void touch(const std::string& path, const std::string& append) {
+        std::ofstream out(path, std::ios::app);
+        out << append;
+    }
+}
+
+bool hotReload() {
+    namespace fs = std::filesystem;
+    const char* names[] = { "wasp.skel", "wasp.skin", "wasp_walk.anim" };
+    const fs::path directory = fs::temp_directory_path() / "hotreload_bench";
+    fs::create_directories(directory);
+    for (const char* name : names) {
+        std::string source = findSkeletonResource(name);
+        if (source.empty()) {
+            printf("\n[hotreload] wasp assets not found, skipping\n");
+            return true;
+        }
+        fs::copy_file(source, directory / name, fs::copy_options::overwrite_existing);
+    }
+    const std::string skel = (directory / names[0]).string();
+    const std::string skin = (directory / names[1]).string();
+    const std::string anim = (directory / names[2]).string();
+
+    // What a restart reparses: every asset.
+    AssetLoader restart;
+    auto begin = std::chrono::steady_clock::now();
+    bool loaded = restart.loadSkeleton(skel).get() && restart.loadSkin(skin).get() && restart.loadAnimation(anim).get();
+    const double restartMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    if (!loaded) return false;
+
+    bool ok = true;
+    printf("\n[hotreload] wasp assets; a restart reparses all three in %.1f ms (plus window and shaders)\n", restartMs);
+    printf("%-10s %-26s %10s %10s %8s\n", "watcher", "edit", "wait ms", "parse ms", "reloads");
+    for (bool polling : { false, true }) {
+        HotReloader reloader;
+        reloader.watch(skel, HotReloader::AssetType::Skeleton);
+        reloader.watch(skin, HotReloader::AssetType::Skin);
+        reloader.watch(anim, HotReloader::AssetType::Animation);
+        reloader.start(polling);
+        const char* watcher = reloader.isUsingInotify() ? "inotify" : "polling";
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+        // Each edit should bring back exactly the edited asset.
+        struct Edit { const char* label; const std::string* path; HotReloader::AssetType type; };
+        const Edit edits[] = {
+            { "wasp.skin", &skin, HotReloader::AssetType::Skin },
+            { "wasp_walk.anim", &anim, HotReloader::AssetType::Animation },
+            { "wasp.skel", &skel, HotReloader::AssetType::Skeleton },
+        };
+        for (const Edit& edit : edits) {
+            touch(*edit.path, "\n");
+            double waited = 0.0;
+            std::vector<HotReloader::Reload> reloads = waitForReloads(reloader, 3000.0, waited);
+            bool right = reloads.size() == 1 && reloads[0].type == edit.type && reloads[0].path == *edit.path;
+            printf("%-10s %-26s %10.1f %10.1f %8zu\n", watcher, edit.label, waited,
+                reloads.empty() ? 0.0 : reloads[0].milliseconds, reloads.size());
+            if (!right) {
+                printf("FAILED: editing %s did not reload exactly that asset\n", edit.label);
+                ok = false;
+            }
+        }
+
+        // A broken save is dropped; the running version stays.
+        fs::copy_file(skin, directory / "wasp.skin.good", fs::copy_options::overwrite_existing);
+        { std::ofstream broken(skin, std::ios::trunc); broken << "positions 5 {\n 1 2 3\n}\n"; }
+        double waited = 0.0;
+        std::vector<HotReloader::Reload> reloads = waitForReloads(reloader, 600.0, waited);
+        printf("%-10s %-26s %10s %10s %8zu\n", watcher, "broken wasp.skin", "-", "-", reloads.size());
+        if (!reloads.empty()) {
+            printf("FAILED: a broken skin was handed over\n");
+            ok = false;
+        }
+        fs::copy_file(directory / "wasp.skin.good", skin, fs::copy_options::overwrite_existing);
+        waitForReloads(reloader, 1000.0, waited);
+        reloader.stop();
+    }
+    fs::remove_all(directory);
+    return ok;
+}
+
+}
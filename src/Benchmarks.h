@@ -0,0 +1,90 @@
+// Benchmarks.h
+#pragma once
+
+#include <string>
+
+// Headless benchmarks and self-checks, run with "-bench <name>" before any
+// window or GL context is created. run() returns false for an unknown name or
+// a failed check so the process exit code can be used from scripts.
+namespace Benchmarks {
+    bool run(const std::string& name);
+
+    // Vertex-stage normal transforms of a large skin on dragon.skel, done on the
+    // CPU: per-vertex inverse-transposes against the precomputed normal matrix,
+    // inverse-transpose palette and rigid-joint path, with ns/vertex.
+    bool normalMatrices();
+
+    // dragon.skel in random poses through packBoneInstances: every instance
+    // matches its joint's box and world matrix, and the layout the GL expects.
+    bool boneInstances();
+
+    // Self-collision grid build / detect / resolve at 10k, 50k and 200k particles.
+    bool selfCollision();
+
+    // Joint primitive collision, SIMD batch against the scalar path.
+    bool jointColliders();
+
+    // Dozens of cloths stepped concurrently on the job system versus one by one.
+    bool multiCloth();
+
+    // Hanging cloths settling to sleep, then woken by a wind change.
+    bool sleeping();
+
+    // Fused triangle area/normal pass against three separate per-consumer passes.
+    bool trianglePass();
+
+    // Every cloth solver backend stepping the same scene; positions after N
+    // steps are compared against the scalar reference.
+    bool solverBackends();
+
+    // Fixed 4 ms stepping against the adaptive step controller on a stiff and a soft cloth.
+    bool timestepControl();
+
+    // Bending springs and tethers: builder cost per particle and the stretch
+    // of a hanging cloth compared to simply raising the stiffness.
+    bool tethers();
+
+    // Cloth from a triangle mesh: unique edges via the edge hash map against
+    // sorting edge keys, and the full build, up to 1M triangles.
+    bool meshTopology();
+
+    // CCD, FABRIK, Jacobian transpose and DLS: convergence on an unlimited
+    // chain, solves per second on the limbs of dragon.skel within its limits.
+    bool inverseKinematics();
+
+    // Damped least squares foot planting for a crowd of dragon.skel
+    // instances, solved one by one and as a parallel batch.
+    bool ikCrowd();
+
+    // wasp_walk.skel animation on wasp_walk_2.skel: rest and world rotation
+    // checks, then instances retargeted per frame.
+    bool retargeting();
+
+    // wasp_walk blended on two layers with crossfades and a mask: matches the
+    // clip when alone, and allocates nothing per frame once warmed up.
+    bool blending();
+
+    // dragon.skel world matrices from flat quaternion + translation local
+    // transforms against the recursive Euler -> 4x4 path: results and ns/joint.
+    bool posePipeline();
+
+    // dragon.skel with single joints edited: only the edited subtrees are
+    // recomputed, the matrices match a full update, and the cost of each case.
+    bool dirtyUpdate();
+
+    // wasp_walk streamed against the loaded clip, then a synthetic 10 hour
+    // take played through and seeked: resident memory stays constant.
+    bool streamingClip();
+
+    // wasp.skel, wasp.skin and wasp_walk.anim parsed one after the other and
+    // concurrently through the AssetLoader, with per-asset times.
+    bool assetLoading();
+
+    // .skin files through the chunked SkinParser against the Tokenizer: same
+    // result on the shipped skins and a synthetic 2M vertex skin, with MB/s.
+    bool skinParsing();
+
+    // Copies of the wasp assets edited under a HotReloader, with inotify and
+    // with polling: only the edited asset comes back, and how soon.
+    bool hotReload();
+}
@@ -0,0 +1,11 @@
+// BoneInstance.cpp
+#include "BoneInstance.h"
+
+void packBoneInstances(const std::vector<std::shared_ptr<Joint>>& joints, std::vector<BoneInstance>& instances) {
+    instances.resize(joints.size());
+    for (size_t i = 0; i < joints.size(); ++i) {
+        instances[i].boxMin = joints[i]->boxMin;
+        instances[i].boxMax = joints[i]->boxMax;
+        instances[i].world = joints[i]->worldMatrix;
+    }
+}
@@ -0,0 +1,18 @@
+// BoneInstance.h
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Skeleton.h"
+
+// Per-instance data of one bone box, streamed as instanced vertex attributes
+// (locations 4-9). The unit cube is stretched to [boxMin, boxMax] in joint space.
+struct BoneInstance {
+    glm::vec3 boxMin;
+    glm::vec3 boxMax;
+    glm::mat4 world;
+};
+
+// Fill one BoneInstance per joint. Pure CPU, no GL, so it is checked headless.
+void packBoneInstances(const std::vector<std::shared_ptr<Joint>>& joints, std::vector<BoneInstance>& instances);
@@ -200,7 +200,7 @@ void Channel::precomputeTangents() {
     }
 }
 
-float Channel::Evaluate(float time) {
+float Channel::Evaluate(float time) const {
     // Return 0 if no keys exist.
     if (keys.empty())
         return 0.0f;
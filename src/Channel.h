@@ -23,7 +23,7 @@ public:
     std::vector<Key> keys;
 
     // Returns the interpolated value at the given time.
-    float Evaluate(float time);
+    float Evaluate(float time) const;
 
     // Loads channel data from the file using our Tokenizer.
     bool Load(class Tokenizer& tokenizer);
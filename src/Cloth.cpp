@@ -2,12 +2,40 @@
 #include "Cloth.h"
 #include <glm/gtx/compatibility.hpp> // for glm::lerp if needed
 #include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include "JobSystem.h"
 
-void Cloth::initializeRectangularCloth(int numWidth, int numHeight, float spacing, const glm::vec3& origin, float stiffness, float damper, float mass) {
-    // Clear any existing data.
+namespace {
+    float elapsedMs(std::chrono::high_resolution_clock::time_point from, std::chrono::high_resolution_clock::time_point to) {
+        return std::chrono::duration<float, std::milli>(to - from).count();
+    }
+}
+
+void Cloth::clearTopology() {
     particles.clear();
     springs.clear();
     triangles.clear();
+    fixedParticles.clear();
+    tethers.clear();
+    sleepRegions.clear();
+    sleepingCount = 0;
+    collisionCellSize = 0.0f;
+    restPositions.clear();
+}
+
+void Cloth::finishTopology() {
+    ClothTopology::buildTethers(*this);
+
+    geometry.build(particles, triangles);
+    geometryStale = true;
+    refreshGeometry();
+    ++topologyVersion;
+}
+
+void Cloth::initializeRectangularCloth(int numWidth, int numHeight, float spacing, const glm::vec3& origin, float stiffness, float damper, float mass) {
+    clearTopology();
 
     particles.reserve(numWidth * numHeight);
     springs.reserve(4 * numWidth * numHeight - 3 * numWidth - 3 * numHeight + 2);
@@ -19,6 +47,7 @@ void Cloth::initializeRectangularCloth(int numWidth, int numHeight, float spacin
             // For example, fix the top row.
             bool fixed = ( (j == 0 && i==0) || (j==0 && i == numWidth-1) );
             particles.emplace_back(pos, mass, fixed);
+            restPositions.push_back(pos);
             if (fixed) {
                 fixedParticles.push_back(&particles.back()); 
             }
@@ -69,52 +98,311 @@ void Cloth::initializeRectangularCloth(int numWidth, int numHeight, float spacin
             triangles.emplace_back(&particles[index], &particles[indexBelowRight], &particles[indexRight]);
         }
     }
+
+    if (bendingSprings) {
+        ClothTopology::addGridBendingSprings(*this, numWidth, numHeight, stiffness * bendingScale, damper * bendingScale);
+    }
+    finishTopology();
+}
+
+bool Cloth::initializeFromMesh(const std::vector<glm::vec3>& positions, const std::vector<Triangle>& meshTriangles,
+    const std::vector<int>& pinned, float stiffness, float damper, float mass) {
+    const int vertexCount = (int)positions.size();
+    for (const Triangle& tri : meshTriangles) {
+        if (tri.v0 < 0 || tri.v1 < 0 || tri.v2 < 0 || tri.v0 >= vertexCount || tri.v1 >= vertexCount || tri.v2 >= vertexCount) {
+            std::cerr << "Cloth mesh triangle references vertex outside 0.." << vertexCount - 1 << std::endl;
+            return false;
+        }
+    }
+    for (int index : pinned) {
+        if (index < 0 || index >= vertexCount) {
+            std::cerr << "Cloth mesh pinned vertex " << index << " out of range" << std::endl;
+            return false;
+        }
+    }
+
+    // Triangles with a repeated vertex have no area or edges of their own.
+    std::vector<Triangle> valid;
+    valid.reserve(meshTriangles.size());
+    for (const Triangle& tri : meshTriangles) {
+        if (tri.v0 != tri.v1 && tri.v1 != tri.v2 && tri.v0 != tri.v2) valid.push_back(tri);
+    }
+
+    clearTopology();
+
+    std::vector<bool> fixed(vertexCount, false);
+    for (int index : pinned) fixed[index] = true;
+
+    particles.reserve(vertexCount);
+    restPositions.assign(positions.begin(), positions.end());
+    for (int i = 0; i < vertexCount; ++i) {
+        particles.emplace_back(positions[i], mass, (bool)fixed[i]);
+        if (fixed[i]) fixedParticles.push_back(&particles.back());
+    }
+
+    std::vector<MeshEdge> edges;
+    int nonManifold = ClothTopology::findMeshEdges(valid, edges);
+    if (nonManifold > 0) {
+        std::cerr << "Cloth mesh has " << nonManifold << " non-manifold edge uses; extra triangles get no bending springs" << std::endl;
+    }
+    ClothTopology::addMeshSprings(*this, edges, bendingSprings, stiffness, damper, stiffness * bendingScale, damper * bendingScale);
+
+    triangles.reserve(valid.size());
+    for (const Triangle& tri : valid) {
+        triangles.emplace_back(&particles[tri.v0], &particles[tri.v1], &particles[tri.v2]);
+    }
+
+    finishTopology();
+    return true;
+}
+
+void Cloth::refreshGeometry() {
+    if (geometry.getTriangleCount() != triangles.size() || geometry.getVertexCount() != particles.size()) {
+        geometry.build(particles, triangles);
+    }
+    geometry.update(particles);
+    geometryStale = false;
+
+    for (size_t t = 0; t < triangles.size(); ++t) {
+        triangles[t].normal = geometry.getNormal(t);
+    }
 }
 
 void Cloth::update(float dt) {
+    auto stepStart = std::chrono::high_resolution_clock::now();
 
-    applyAeroDynamic();
+    if (sleepRegions.empty() || sleepRegions.back().first + sleepRegions.back().count != (int)particles.size()) {
+        buildSleepRegions();
+    }
+    checkWakeTriggers();
 
-    // Compute and apply spring-damper forces.
-    for (auto& spring : springs) {
-        spring.applyForce();
+    if (geometryStale || geometry.getTriangleCount() != triangles.size()) {
+        refreshGeometry();
+    }
+    if (sleepingCount > 0) {
+        wakeFromSprings();
     }
-    // Apply forces to particles.
-    for (auto& p : particles) {
-        // Gravity.
-        p.applyForce(gravity * p.mass);
 
-        if (p.position.y <= groundLevel && p.velocity.y != 0) {
-            float v_n = p.velocity.y;
+    if (!backend || backend->getType() != backendType) {
+        backend = ClothSolverBackend::create(backendType);
+    }
+    backend->step(*this, dt);
 
-            // Compute impulse magnitude:
-            // J = - (1 + restitution) * m * v_n
-            float impulseMagnitude = -(1.0f + restitution) * v_n * p.mass;
-            glm::vec3 impulse(0.0f, impulseMagnitude, 0.f);
+    if (useTethers) {
+        applyTethers();
+    }
 
-            // Apply the impulse to change the velocity.
-            p.applyImpulse(impulse);
-            p.position.y = groundLevel + PHYS_EPISILON;
+    // Colliders still see sleeping particles so a collider moving into them
+    // wakes them up.
+    if (sleepingCount > 0 && !colliders.empty()) {
+        sleepingSnapshot.resize(particles.size());
+        for (size_t i = 0; i < particles.size(); ++i) sleepingSnapshot[i] = particles[i].position;
+    }
+    colliderContacts.assign(colliders.size(), 0);
+    for (size_t i = 0; i < colliders.size(); ++i) {
+        if (!colliders[i]->enabled) continue;
+        colliderContacts[i] = colliders[i]->collide(particles, collisionThickness, colliderScratch);
+    }
+    if (sleepingCount > 0 && !colliders.empty()) {
+        for (size_t i = 0; i < particles.size(); ++i) {
+            if (isAsleep(i) && particles[i].position != sleepingSnapshot[i]) wakeParticle(i);
         }
+    }
 
-        //Wind force (for simplicity, applying uniformly).
-       //p.applyForce(wind);
-        p.update(dt);
-
+    // A fully asleep cloth cannot create new self contacts.
+    if (selfCollision && sleepingCount < (int)sleepRegions.size()) {
+        handleSelfCollisions();
     }
 
-    //// Update particle positions and handle ground collisions.
-    //for (auto& p : particles) {
-    //}
+    updateSleepRegions(dt);
+
+    // One fused pass for the triangle normals, the next step's aerodynamics
+    // and the renderer.
+    refreshGeometry();
+
+    lastStepMs = elapsedMs(stepStart, std::chrono::high_resolution_clock::now());
+    accumulatedStepMs += lastStepMs;
+}
 
-    // Update triangle normals.
-    for (auto& tri : triangles) {
-        tri.computeNormal();
+void stepCloths(const std::vector<Cloth*>& cloths, float dt) {
+    JobSystem& jobs = JobSystem::getInstance();
+    JobSystem::Counter counter;
+    for (Cloth* cloth : cloths) {
+        jobs.submit([cloth, dt]() { cloth->update(dt); }, counter);
     }
+    jobs.wait(counter);
 }
 
 void Cloth::setWind(const glm::vec3& newWind) {
     wind = newWind;
+    wakeAll();
+}
+
+void Cloth::buildSleepRegions() {
+    sleepRegionSize = std::max(sleepRegionSize, 1);
+    sleepRegions.clear();
+    for (int first = 0; first < (int)particles.size(); first += sleepRegionSize) {
+        SleepRegion region;
+        region.first = first;
+        region.count = std::min(sleepRegionSize, (int)particles.size() - first);
+        sleepRegions.push_back(region);
+    }
+    sleepingCount = 0;
+
+    lastGravity = gravity;
+    lastWind = wind;
+    lastGround = groundLevel;
+    lastFixedPositions.clear();
+    for (const Particle* p : fixedParticles) lastFixedPositions.push_back(p->position);
+}
+
+void Cloth::wakeAll() {
+    for (auto& region : sleepRegions) {
+        region.asleep = false;
+        region.quietTime = 0.0f;
+    }
+    sleepingCount = 0;
+}
+
+void Cloth::wakeParticle(size_t particleIndex) {
+    SleepRegion& region = sleepRegions[particleIndex / sleepRegionSize];
+    if (!region.asleep) return;
+    region.asleep = false;
+    region.quietTime = 0.0f;
+    --sleepingCount;
+}
+
+void Cloth::wakeFromSprings() {
+    // A moving particle pulling on a sleeping one through a spring wakes it.
+    const Particle* base = particles.data();
+    const float wakeSpeed2 = 2.0f * sleepEnergy;
+    for (const auto& spring : springs) {
+        size_t a = spring.p1 - base, b = spring.p2 - base;
+        bool aAsleep = isAsleep(a), bAsleep = isAsleep(b);
+        if (aAsleep == bAsleep) continue;
+        const Particle& mover = aAsleep ? *spring.p2 : *spring.p1;
+        if (glm::dot(mover.velocity, mover.velocity) * mover.mass > wakeSpeed2) {
+            wakeParticle(aAsleep ? a : b);
+        }
+    }
+}
+
+void Cloth::applyTethers() {
+    // Each particle has at most one tether and anchors are fixed, so the
+    // projections are independent.
+    JobSystem::getInstance().parallelFor(tethers.size(), 2048, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; ++t) {
+            const ClothTether& tether = tethers[t];
+            if (isAsleep(tether.particle)) continue;
+            Particle& p = particles[tether.particle];
+            const glm::vec3& anchor = particles[tether.anchor].position;
+
+            glm::vec3 d = p.position - anchor;
+            float length2 = glm::dot(d, d);
+            float limit = tether.maxLength * (1.0f + tetherSlack);
+            if (length2 <= limit * limit) continue;
+
+            float length = glm::sqrt(length2);
+            glm::vec3 n = d / length;
+            p.position = anchor + n * limit;
+            float outward = glm::dot(p.velocity, n);
+            if (outward > 0.0f) p.velocity -= n * outward;
+        }
+    });
+}
+
+void Cloth::checkWakeTriggers() {
+    // Parameters are edited directly from the UI, so compare against the last step.
+    bool changed = gravity != lastGravity || wind != lastWind || groundLevel != lastGround;
+    if (lastFixedPositions.size() != fixedParticles.size()) {
+        changed = true;
+        lastFixedPositions.resize(fixedParticles.size());
+    }
+    for (size_t i = 0; i < fixedParticles.size(); ++i) {
+        if (fixedParticles[i]->position != lastFixedPositions[i]) {
+            changed = true;
+            lastFixedPositions[i] = fixedParticles[i]->position;
+        }
+    }
+    lastGravity = gravity;
+    lastWind = wind;
+    lastGround = groundLevel;
+
+    if (changed || !sleepingEnabled) wakeAll();
+}
+
+void Cloth::updateSleepRegions(float dt) {
+    // Sleeping regions have zero velocity, so the energy stats only need the awake ones.
+    activeParticles = 0;
+    kineticEnergy = 0.0f;
+    maxSpeed = 0.0f;
+    for (auto& region : sleepRegions) {
+        if (region.asleep) continue;
+        activeParticles += region.count;
+
+        float maxEnergy = 0.0f;
+        for (int i = region.first; i < region.first + region.count; ++i) {
+            const Particle& p = particles[i];
+            if (p.fixed) continue;
+            float speed2 = glm::dot(p.velocity, p.velocity);
+            float energy = 0.5f * p.mass * speed2;
+            maxEnergy = std::max(maxEnergy, energy);
+            kineticEnergy += energy;
+            maxSpeed = std::max(maxSpeed, speed2);
+        }
+        if (!sleepingEnabled) continue;
+
+        region.quietTime = maxEnergy < sleepEnergy ? region.quietTime + dt : 0.0f;
+        if (region.quietTime >= sleepDelay) {
+            region.asleep = true;
+            ++sleepingCount;
+            for (int i = region.first; i < region.first + region.count; ++i) {
+                particles[i].velocity = glm::vec3(0.0f);
+            }
+        }
+    }
+    maxSpeed = std::sqrt(maxSpeed);
+}
+
+const ClothStepLimits& Cloth::getStepLimits() {
+    if (stepLimitsVersion == topologyVersion && stepLimitsDrag == ambientDrag) return stepLimits;
+
+    // Gershgorin bounds on the stiffness and damping matrices, per unit mass:
+    // omega^2 <= 2 * sum(k) / m and gamma <= 2 * sum(c) / m + drag / m.
+    std::vector<float> stiffnessSum(particles.size(), 0.0f), dampingSum(particles.size(), 0.0f);
+    const Particle* base = particles.data();
+    float minRest = 0.0f;
+    for (const auto& spring : springs) {
+        size_t a = spring.p1 - base, b = spring.p2 - base;
+        stiffnessSum[a] += spring.stiffness;
+        stiffnessSum[b] += spring.stiffness;
+        dampingSum[a] += spring.damping;
+        dampingSum[b] += spring.damping;
+        if (spring.restLength > 0.0f && (minRest == 0.0f || spring.restLength < minRest)) minRest = spring.restLength;
+    }
+
+    // Symplectic Euler on x'' = -w^2 x - g x' is stable while
+    // w^2 dt^2 + 2 g dt < 4, i.e. dt < (sqrt(g^2 + 4 w^2) - g) / w^2.
+    float stableDt = 0.0f;
+    for (size_t i = 0; i < particles.size(); ++i) {
+        if (particles[i].fixed || particles[i].mass <= 0.0f) continue;
+        float omega2 = 2.0f * stiffnessSum[i] / particles[i].mass;
+        float gamma = (2.0f * dampingSum[i] + ambientDrag) / particles[i].mass;
+        float dt = omega2 > 0.0f ? (std::sqrt(gamma * gamma + 4.0f * omega2) - gamma) / omega2
+                                 : (gamma > 0.0f ? 2.0f / gamma : 0.0f);
+        if (dt > 0.0f && (stableDt == 0.0f || dt < stableDt)) stableDt = dt;
+    }
+
+    stepLimits.stableDt = stableDt;
+    stepLimits.minRestLength = minRest;
+    stepLimitsVersion = topologyVersion;
+    stepLimitsDrag = ambientDrag;
+    return stepLimits;
+}
+
+void Cloth::removeCollider(const ClothCollider* collider) {
+    colliders.erase(std::remove_if(colliders.begin(), colliders.end(),
+        [&](const std::shared_ptr<ClothCollider>& c) { return c.get() == collider; }), colliders.end());
 }
 
 void Cloth::moveFixedParticles(const glm::vec3& delta) {
@@ -123,49 +411,168 @@ void Cloth::moveFixedParticles(const glm::vec3& delta) {
             p.position += delta;
         }
     }
+    geometryStale = true;
+    wakeAll();
 }
 
-void Cloth::applyAeroDynamic() {
+void Cloth::handleSelfCollisions() {
+    using Clock = std::chrono::high_resolution_clock;
+    selfCollisionStats = SelfCollisionStats();
+    if (particles.empty() || triangles.empty()) return;
+
+    auto gridStart = Clock::now();
+
+    if (collisionCellSize <= 0.0f) {
+        float total = 0.0f;
+        for (const auto& spring : springs) total += spring.restLength;
+        collisionCellSize = springs.empty() ? 1.0f : total / springs.size();
+    }
+    const float thickness = collisionThickness;
+    const float cellSize = std::max(collisionCellSize, 2.0f * thickness);
+    // Within two edges of each other in the rest shape, a particle and a
+    // triangle are held apart by springs; colliding them too makes sharp
+    // folds (e.g. around a pinned corner) jitter forever.
+    const float restSkip2 = 4.0f * collisionCellSize * collisionCellSize;
+    const bool hasRest = restPositions.size() == particles.size();
+
+    collisionPositions.resize(particles.size());
+    for (size_t i = 0; i < particles.size(); ++i) {
+        collisionPositions[i] = particles[i].position;
+    }
+    collisionGrid.build(collisionPositions, cellSize);
+
+    auto detectStart = Clock::now();
+
+    // Broad phase: each triangle queries the cells under its thickened bounds.
+    // Narrow phase: exact point-triangle distance against the thickness.
+    // Chunks write to their own contact lists, so no locking is needed.
+    const size_t grain = 1024;
+    const size_t chunkCount = (triangles.size() + grain - 1) / grain;
+    chunkContacts.resize(chunkCount);
+    chunkCandidates.assign(chunkCount, 0);
+    for (auto& contacts : chunkContacts) contacts.clear();
+
+    const Particle* base = particles.data();
+    JobSystem::getInstance().parallelFor(triangles.size(), grain, [&](size_t begin, size_t end) {
+        const size_t chunk = begin / grain;
+        std::vector<ClothContact>& contacts = chunkContacts[chunk];
+        thread_local std::vector<uint32_t> candidates;
+        int candidateCount = 0;
+
+        for (size_t t = begin; t < end; ++t) {
+            const ClothTriangle& tri = triangles[t];
+            const uint32_t i1 = static_cast<uint32_t>(tri.p1 - base);
+            const uint32_t i2 = static_cast<uint32_t>(tri.p2 - base);
+            const uint32_t i3 = static_cast<uint32_t>(tri.p3 - base);
+            const glm::vec3& a = collisionPositions[i1];
+            const glm::vec3& b = collisionPositions[i2];
+            const glm::vec3& c = collisionPositions[i3];
+
+            glm::vec3 boxMin = glm::min(a, glm::min(b, c)) - glm::vec3(thickness);
+            glm::vec3 boxMax = glm::max(a, glm::max(b, c)) + glm::vec3(thickness);
+
+            candidates.clear();
+            collisionGrid.query(boxMin, boxMax, candidates);
+            candidateCount += static_cast<int>(candidates.size());
 
-    for (auto& tri : triangles) {
-        // Positions & velocities of the 3 vertices
-        glm::vec3 p1Pos = tri.p1->position;
-        glm::vec3 p2Pos = tri.p2->position;
-        glm::vec3 p3Pos = tri.p3->position;
+            glm::vec3 n = glm::cross(b - a, c - a);
+            float nLen = glm::length(n);
+            if (nLen < 1e-12f) continue;
+            n /= nLen;
 
-        glm::vec3 v1 = tri.p1->velocity;
-        glm::vec3 v2 = tri.p2->velocity;
-        glm::vec3 v3 = tri.p3->velocity;
+            for (uint32_t pi : candidates) {
+                if (pi == i1 || pi == i2 || pi == i3) continue;
+                if (hasRest) {
+                    const glm::vec3& r = restPositions[pi];
+                    if (glm::dot(r - restPositions[i1], r - restPositions[i1]) < restSkip2 ||
+                        glm::dot(r - restPositions[i2], r - restPositions[i2]) < restSkip2 ||
+                        glm::dot(r - restPositions[i3], r - restPositions[i3]) < restSkip2) continue;
+                }
+                const glm::vec3& p = collisionPositions[pi];
+                if (glm::any(glm::lessThan(p, boxMin)) || glm::any(glm::greaterThan(p, boxMax))) continue;
 
-        // Average velocity of the triangle
-        glm::vec3 vAvg = (v1 + v2 + v3) / 3.0f;
-        glm::vec3 vRel = wind - vAvg; // relative wind velocity
+                glm::vec3 bary = closestPointBarycentric(p, a, b, c);
+                glm::vec3 q = bary.x * a + bary.y * b + bary.z * c;
+                glm::vec3 d = p - q;
+                if (glm::dot(d, d) >= thickness * thickness) continue;
 
-        // Compute edges & normal
-        glm::vec3 edge1 = p2Pos - p1Pos;
-        glm::vec3 edge2 = p3Pos - p1Pos;
-        glm::vec3 normal = glm::cross(edge1, edge2);
-        float area = 0.5f * glm::length(normal);
-        if (area < 1e-7f) {
-            continue; // degenerate triangle
+                ClothContact contact;
+                contact.particle = pi;
+                contact.triangle = static_cast<uint32_t>(t);
+                contact.bary = bary;
+                contact.normal = glm::dot(p - a, n) >= 0.0f ? n : -n;
+                contacts.push_back(contact);
+            }
+        }
+        chunkCandidates[chunk] += candidateCount;
+    });
+
+    auto resolveStart = Clock::now();
+
+    // Response: push the particle and the triangle apart along the contact
+    // normal by mass-weighted amounts, then cancel the approaching velocity.
+    for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+        selfCollisionStats.candidates += chunkCandidates[chunk];
+        for (const ClothContact& contact : chunkContacts[chunk]) {
+            Particle& p = particles[contact.particle];
+            const ClothTriangle& tri = triangles[contact.triangle];
+            Particle* verts[3] = { tri.p1, tri.p2, tri.p3 };
+            const glm::vec3& n = contact.normal;
+
+            float invMassP = p.fixed ? 0.0f : 1.0f / p.mass;
+            float invMass[3];
+            float invMassT = 0.0f;
+            glm::vec3 q(0.0f), vq(0.0f);
+            for (int k = 0; k < 3; ++k) {
+                invMass[k] = verts[k]->fixed ? 0.0f : 1.0f / verts[k]->mass;
+                invMassT += contact.bary[k] * contact.bary[k] * invMass[k];
+                q += contact.bary[k] * verts[k]->position;
+                vq += contact.bary[k] * verts[k]->velocity;
+            }
+            float denom = invMassP + invMassT;
+            if (denom <= 0.0f) continue;
+
+            float depth = thickness - glm::dot(p.position - q, n);
+
+            // Contacts entirely inside sleeping regions are frozen as they are.
+            // Real penetration wakes sleeping participants; resting contacts
+            // that only graze the thickness do not.
+            if (sleepingCount > 0) {
+                const size_t vi[3] = {
+                    static_cast<size_t>(verts[0] - particles.data()),
+                    static_cast<size_t>(verts[1] - particles.data()),
+                    static_cast<size_t>(verts[2] - particles.data()) };
+                bool allAsleep = isAsleep(contact.particle) &&
+                    isAsleep(vi[0]) && isAsleep(vi[1]) && isAsleep(vi[2]);
+                if (allAsleep) continue;
+                if (depth > 0.25f * thickness) {
+                    wakeParticle(contact.particle);
+                    for (int k = 0; k < 3; ++k) wakeParticle(vi[k]);
+                }
+            }
+
+            if (depth > 0.0f) {
+                float lambda = depth / denom;
+                p.position += n * (lambda * invMassP);
+                for (int k = 0; k < 3; ++k) {
+                    verts[k]->position -= n * (lambda * invMass[k] * contact.bary[k]);
+                }
+            }
+
+            float vRel = glm::dot(p.velocity - vq, n);
+            if (vRel < 0.0f) {
+                float j = -vRel / denom;
+                p.applyImpulse(n * j);
+                for (int k = 0; k < 3; ++k) {
+                    verts[k]->applyImpulse(-n * (j * contact.bary[k]));
+                }
+            }
         }
-        normal = glm::normalize(normal);
-
-        // Project velocity onto normal
-        float vDotN = glm::dot(vRel, normal);
-        // The "flat plate" formula: F = -0.5 * rho * |v|^2 * Cd * A * n
-        // But we only want the component perpendicular to the surface:
-        // sign is determined by dot(vRel, n) (which can be negative)
-        float forceMag = 0.5f * rho * (vDotN * vDotN) * Cd * area;
-        // If vDotN < 0, the force is in the opposite direction
-        // multiply by sign(vDotN):
-        float sign = (vDotN >= 0.0f) ? 1.0f : -1.0f;
-        glm::vec3 F = -sign * forceMag * normal;
-
-        // Distribute among the three vertices
-        glm::vec3 eachVertexForce = F / 3.0f;
-        tri.p1->applyForce(eachVertexForce);
-        tri.p2->applyForce(eachVertexForce);
-        tri.p3->applyForce(eachVertexForce);
+        selfCollisionStats.contacts += static_cast<int>(chunkContacts[chunk].size());
     }
+
+    auto resolveEnd = Clock::now();
+    selfCollisionStats.gridMs = elapsedMs(gridStart, detectStart);
+    selfCollisionStats.detectMs = elapsedMs(detectStart, resolveStart);
+    selfCollisionStats.resolveMs = elapsedMs(resolveStart, resolveEnd);
 }
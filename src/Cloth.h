@@ -1,10 +1,46 @@
 // Cloth.h
 #pragma once
 #include <vector>
+#include <memory>
 #include <glm/glm.hpp>
 #include "Particle.h"
 #include "SpringDamper.h"
 #include "ClothTriangle.h"
+#include "SpatialHashGrid.h"
+#include "ClothCollider.h"
+#include "ClothGeometry.h"
+#include "ClothSolverBackend.h"
+#include "ClothTopology.h"
+
+// A particle closer than the collision thickness to a cloth triangle it is not part of.
+struct ClothContact {
+    uint32_t particle;
+    uint32_t triangle;
+    glm::vec3 bary;    // closest point on the triangle
+    glm::vec3 normal;  // triangle normal, oriented toward the particle
+};
+
+struct SelfCollisionStats {
+    int candidates = 0;     // particle-triangle pairs from the grid
+    int contacts = 0;       // pairs within the collision thickness
+    float gridMs = 0.0f;    // hash grid rebuild
+    float detectMs = 0.0f;  // parallel broad + narrow phase
+    float resolveMs = 0.0f; // contact response
+};
+
+// Explicit-integration limits derived from the springs and masses. A
+// stableDt of 0 means nothing constrains the step (no springs, no drag).
+struct ClothStepLimits {
+    float stableDt = 0.0f;       // largest stable explicit step, seconds
+    float minRestLength = 0.0f;  // shortest spring at rest
+};
+
+// A block of consecutive particles that sleeps and wakes as a unit.
+struct SleepRegion {
+    int first = 0, count = 0;
+    float quietTime = 0.0f;  // seconds spent below the sleep energy
+    bool asleep = false;
+};
 
 class Cloth {
 public:
@@ -24,12 +60,72 @@ public:
     float rho = 1.225f;
     float Cd = 1.28f;
 
+    // Self-collision: particles are kept collisionThickness away from triangles.
+    // The thickness should stay below half the rest edge length, otherwise
+    // neighbouring particles start colliding with the triangles around them.
+    // Off unless asked for: it is the most expensive part of a step.
+    bool selfCollision = false;
+    float collisionThickness = 0.01f;
+    SelfCollisionStats selfCollisionStats;
+
+    // Extra connectivity, read by the initialize functions. Bending springs
+    // join particles two apart along rows and columns (or across each pair of
+    // mesh triangles), with the structural stiffness and damping scaled by
+    // bendingScale.
+    bool bendingSprings = false;
+    float bendingScale = 0.2f;
+
+    // Long-range attachments to the nearest fixed particle, built on every
+    // initialization and enforced after integration while useTethers is set.
+    // A particle may drift tetherSlack (fraction of its rest distance) past
+    // the limit before it is pulled back.
+    bool useTethers = false;
+    float tetherSlack = 0.05f;
+    std::vector<ClothTether> tethers;
+
+    // External colliders, run after integration and before self-collision.
+    // Their update() is the owner's job, see ClothCollider.
+    std::vector<std::shared_ptr<ClothCollider>> colliders;
+    std::vector<int> colliderContacts;  // per collider, last step
+    ColliderScratch colliderScratch;    // reused by the colliders every step
+
+    float lastStepMs = 0.0f;  // wall time of the last update()
+    float accumulatedStepMs = 0.0f;  // summed over updates until the owner resets it
+    float kineticEnergy = 0.0f;  // J, after the last update()
+    float maxSpeed = 0.0f;       // m/s, after the last update()
+
+    // Sleeping: a region whose particles all stay below sleepEnergy (kinetic
+    // energy, J) for sleepDelay seconds is frozen. Its springs, aero triangles
+    // and integration are skipped until wind, gravity, ground or a fixed
+    // particle changes, a collision moves it, or a moving neighbour tugs on it.
+    bool sleepingEnabled = true;
+    float sleepEnergy = 1e-4f;
+    float sleepDelay = 0.5f;
+    int sleepRegionSize = 256;
+    int activeParticles = 0;  // particles simulated in the last step
+
+    float getActivePercent() const {
+        return particles.empty() ? 0.0f : 100.0f * activeParticles / particles.size();
+    }
+    bool isAsleep(size_t particleIndex) const {
+        return sleepingCount > 0 && sleepRegions[particleIndex / sleepRegionSize].asleep;
+    }
+    void wakeAll();
+
     Cloth()
         : gravity(0.0f, -9.81f, 0.0f), wind(0.0f), ambientDrag(0.1f), groundLevel(-100.0) {}
 
     // Example initialization: a rectangular cloth grid.
     void initializeRectangularCloth(int numWidth, int numHeight, float spacing, const glm::vec3& origin, float stiffness, float damper, float mass);
 
+    // Cloth from an arbitrary triangle mesh (e.g. a Skin's positions and
+    // triangles): one particle per vertex, structural springs on the unique
+    // edges, bending springs across adjacent triangles if bendingSprings is
+    // set. Vertices listed in 'pinned' are fixed. Returns false, leaving the
+    // cloth untouched, if an index is out of range.
+    bool initializeFromMesh(const std::vector<glm::vec3>& positions, const std::vector<Triangle>& meshTriangles,
+        const std::vector<int>& pinned, float stiffness, float damper, float mass);
+
     // Update the simulation by a time step dt.
     void update(float dt);
 
@@ -40,7 +136,64 @@ public:
     // Move fixed particles according to user control.
     void moveFixedParticles(const glm::vec3& delta);
 
-    // Apply aero dynamic Force
-    void applyAeroDynamic();
+    // Forces and integration run on a swappable backend; see ClothSolverBackend.
+    void setBackend(ClothBackendType type) { backendType = type; }
+    ClothBackendType getBackendType() const { return backendType; }
+    int getTopologyVersion() const { return topologyVersion; }
+
+    // Cached until the topology or the ambient drag changes.
+    const ClothStepLimits& getStepLimits();
+
+    // Triangle areas and normals as of the end of the last step, plus the
+    // vertex-triangle adjacency; also used by the renderer for vertex normals.
+    const ClothGeometry& getGeometry() const { return geometry; }
+
+    // Detect and resolve particle-triangle contacts within collisionThickness.
+    void handleSelfCollisions();
+
+    void addCollider(const std::shared_ptr<ClothCollider>& collider) { colliders.push_back(collider); }
+    void removeCollider(const ClothCollider* collider);
+
+private:
+    ClothGeometry geometry;
+    bool geometryStale = true;  // positions changed outside update()
+    int topologyVersion = 0;  // bumped whenever particles, springs or triangles are rebuilt
+
+    ClothBackendType backendType = ClothBackendType::SIMD;
+    std::unique_ptr<ClothSolverBackend> backend;
+
+    void refreshGeometry();
+    void clearTopology();
+    void finishTopology();  // tethers, geometry, version bump
+
+    SpatialHashGrid collisionGrid;
+    float collisionCellSize = 0.0f;  // mean rest edge length, computed on first use
+    std::vector<glm::vec3> collisionPositions;
+    std::vector<glm::vec3> restPositions;  // particles that start close never collide
+    std::vector<std::vector<ClothContact>> chunkContacts;
+    std::vector<int> chunkCandidates;
+
+    std::vector<SleepRegion> sleepRegions;
+    int sleepingCount = 0;  // regions asleep
+    glm::vec3 lastGravity = glm::vec3(0.0f), lastWind = glm::vec3(0.0f);
+    float lastGround = 0.0f;
+    std::vector<glm::vec3> lastFixedPositions;
+    std::vector<glm::vec3> sleepingSnapshot;
+
+    void buildSleepRegions();
+    void wakeParticle(size_t particleIndex);
+    void wakeFromSprings();
+    void applyTethers();
+
+    ClothStepLimits stepLimits;
+    int stepLimitsVersion = -1;
+    float stepLimitsDrag = 0.0f;
+    void checkWakeTriggers();
+    void updateSleepRegions(float dt);
 
 };
+
+// Step several cloths concurrently, one job per cloth. Work inside each step
+// (particle chunks, collision passes) is split further and stolen by idle
+// workers, so a few large cloths and many small ones both keep all threads busy.
+void stepCloths(const std::vector<Cloth*>& cloths, float dt);
@@ -0,0 +1,55 @@
+// ClothCollider.cpp
+#include "ClothCollider.h"
+
+namespace {
+    // Move p out along n by the penetration depth and drop the velocity
+    // component pointing into the surface.
+    bool pushOut(Particle& p, const glm::vec3& n, float penetration) {
+        if (penetration <= 0.0f) return false;
+        p.position += n * penetration;
+        float vn = glm::dot(p.velocity, n);
+        if (vn < 0.0f) p.velocity -= n * vn;
+        return true;
+    }
+}
+
+int SphereCollider::collide(std::vector<Particle>& particles, float thickness, ColliderScratch&) const {
+    int contacts = 0;
+    const float reach = radius + thickness;
+    for (auto& p : particles) {
+        if (p.fixed) continue;
+        glm::vec3 d = p.position - center;
+        float dist2 = glm::dot(d, d);
+        if (dist2 >= reach * reach || dist2 < 1e-12f) continue;
+        float dist = glm::sqrt(dist2);
+        contacts += pushOut(p, d / dist, reach - dist);
+    }
+    return contacts;
+}
+
+int CapsuleCollider::collide(std::vector<Particle>& particles, float thickness, ColliderScratch&) const {
+    int contacts = 0;
+    const float reach = radius + thickness;
+    const glm::vec3 axis = b - a;
+    const float axisLen2 = glm::dot(axis, axis);
+    for (auto& p : particles) {
+        if (p.fixed) continue;
+        float t = axisLen2 > 0.0f ? glm::clamp(glm::dot(p.position - a, axis) / axisLen2, 0.0f, 1.0f) : 0.0f;
+        glm::vec3 d = p.position - (a + axis * t);
+        float dist2 = glm::dot(d, d);
+        if (dist2 >= reach * reach || dist2 < 1e-12f) continue;
+        float dist = glm::sqrt(dist2);
+        contacts += pushOut(p, d / dist, reach - dist);
+    }
+    return contacts;
+}
+
+int PlaneCollider::collide(std::vector<Particle>& particles, float thickness, ColliderScratch&) const {
+    int contacts = 0;
+    for (auto& p : particles) {
+        if (p.fixed) continue;
+        float dist = glm::dot(normal, p.position) - offset;
+        contacts += pushOut(p, normal, thickness - dist);
+    }
+    return contacts;
+}
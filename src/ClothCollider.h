@@ -0,0 +1,106 @@
+// ClothCollider.h
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "Particle.h"
+
+// Closest point on triangle abc to p (Ericson, Real-Time Collision Detection 5.1.5).
+// Returns the barycentric weights of the closest point.
+inline glm::vec3 closestPointBarycentric(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+    glm::vec3 ab = b - a, ac = c - a, ap = p - a;
+    float d1 = glm::dot(ab, ap), d2 = glm::dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f) return glm::vec3(1, 0, 0);
+
+    glm::vec3 bp = p - b;
+    float d3 = glm::dot(ab, bp), d4 = glm::dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3) return glm::vec3(0, 1, 0);
+
+    float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+        float v = d1 / (d1 - d3);
+        return glm::vec3(1.0f - v, v, 0);
+    }
+
+    glm::vec3 cp = p - c;
+    float d5 = glm::dot(ab, cp), d6 = glm::dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6) return glm::vec3(0, 0, 1);
+
+    float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+        float w = d2 / (d2 - d6);
+        return glm::vec3(1.0f - w, 0, w);
+    }
+
+    float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+        float w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+        return glm::vec3(0, 1.0f - w, w);
+    }
+
+    float denom = 1.0f / (va + vb + vc);
+    float v = vb * denom;
+    float w = vc * denom;
+    return glm::vec3(1.0f - v - w, v, w);
+}
+
+// Working memory a collider may use inside collide(). Each cloth owns one,
+// so cloths stepping concurrently never share it and it is reused from step
+// to step instead of being allocated per call.
+struct ColliderScratch {
+    std::vector<float> x, y, z, movable;  // particles in SoA form
+};
+
+// Something cloth particles cannot pass through. The owner calls update()
+// once per step so a moving collider can catch up with its source; every
+// cloth then calls collide() to push its particles out to 'thickness' from
+// the surface and remove the velocity component heading into it. collide()
+// only reads collider state, so one collider can serve several cloths
+// stepping concurrently. It returns the number of particles corrected.
+class ClothCollider {
+public:
+    bool enabled = true;
+
+    virtual ~ClothCollider() = default;
+
+    virtual const char* getName() const = 0;
+    virtual void update() {}
+    virtual int collide(std::vector<Particle>& particles, float thickness, ColliderScratch& scratch) const = 0;
+};
+
+class SphereCollider : public ClothCollider {
+public:
+    glm::vec3 center;
+    float radius;
+
+    SphereCollider(const glm::vec3& center, float radius)
+        : center(center), radius(radius) {}
+
+    const char* getName() const override { return "Sphere"; }
+    int collide(std::vector<Particle>& particles, float thickness, ColliderScratch& scratch) const override;
+};
+
+class CapsuleCollider : public ClothCollider {
+public:
+    glm::vec3 a, b;  // segment end points
+    float radius;
+
+    CapsuleCollider(const glm::vec3& a, const glm::vec3& b, float radius)
+        : a(a), b(b), radius(radius) {}
+
+    const char* getName() const override { return "Capsule"; }
+    int collide(std::vector<Particle>& particles, float thickness, ColliderScratch& scratch) const override;
+};
+
+// Half-space dot(normal, x) < offset is solid.
+class PlaneCollider : public ClothCollider {
+public:
+    glm::vec3 normal;
+    float offset;
+
+    PlaneCollider(const glm::vec3& normal, float offset)
+        : normal(glm::normalize(normal)), offset(offset) {}
+
+    const char* getName() const override { return "Plane"; }
+    int collide(std::vector<Particle>& particles, float thickness, ColliderScratch& scratch) const override;
+};
@@ -0,0 +1,141 @@
+// ClothGeometry.cpp
+#include "ClothGeometry.h"
+#include "JobSystem.h"
+#ifdef CLOTH_GEOMETRY_SSE
+#include <emmintrin.h>
+#endif
+
+namespace {
+    const float MIN_AREA = 1e-7f;
+}
+
+void ClothGeometry::build(const std::vector<Particle>& particles, const std::vector<ClothTriangle>& triangles) {
+    triangleCount = triangles.size();
+    vertexCount = particles.size();
+
+    const size_t padded = (triangleCount + 3) & ~size_t(3);
+    i0.assign(padded, 0);
+    i1.assign(padded, 0);
+    i2.assign(padded, 0);
+    area.assign(padded, 0.0f);
+    nx.assign(padded, 0.0f);
+    ny.assign(padded, 0.0f);
+    nz.assign(padded, 0.0f);
+
+    const Particle* base = particles.data();
+    for (size_t t = 0; t < triangleCount; ++t) {
+        i0[t] = static_cast<uint32_t>(triangles[t].p1 - base);
+        i1[t] = static_cast<uint32_t>(triangles[t].p2 - base);
+        i2[t] = static_cast<uint32_t>(triangles[t].p3 - base);
+    }
+
+    // Counting sort of (vertex, triangle) pairs by vertex.
+    vertexStart.assign(vertexCount + 1, 0);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        ++vertexStart[i0[t] + 1];
+        ++vertexStart[i1[t] + 1];
+        ++vertexStart[i2[t] + 1];
+    }
+    for (size_t v = 0; v < vertexCount; ++v) {
+        vertexStart[v + 1] += vertexStart[v];
+    }
+    vertexTriangles.resize(3 * triangleCount);
+    std::vector<uint32_t> cursor(vertexStart.begin(), vertexStart.end() - 1);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        vertexTriangles[cursor[i0[t]]++] = static_cast<uint32_t>(t);
+        vertexTriangles[cursor[i1[t]]++] = static_cast<uint32_t>(t);
+        vertexTriangles[cursor[i2[t]]++] = static_cast<uint32_t>(t);
+    }
+}
+
+void ClothGeometry::update(const std::vector<Particle>& particles) {
+    if (triangleCount == 0 || particles.size() != vertexCount) return;
+
+    const Particle* base = particles.data();
+    const size_t groups = i0.size() / 4;
+    JobSystem::getInstance().parallelFor(groups, 256, [&](size_t begin, size_t end) {
+#ifdef CLOTH_GEOMETRY_SSE
+        if (useSIMD) {
+            updateRangeSSE(base, begin * 4, end * 4);
+            return;
+        }
+#endif
+        updateRangeScalar(base, begin * 4, end * 4);
+    });
+}
+
+void ClothGeometry::updateRangeScalar(const Particle* particles, size_t begin, size_t end) {
+    for (size_t t = begin; t < end; ++t) {
+        const glm::vec3& a = particles[i0[t]].position;
+        glm::vec3 n = glm::cross(particles[i1[t]].position - a, particles[i2[t]].position - a);
+        float len = glm::length(n);
+        float triArea = 0.5f * len;
+        if (triArea < MIN_AREA) {
+            area[t] = 0.0f;
+            nx[t] = ny[t] = nz[t] = 0.0f;
+            continue;
+        }
+        n /= len;
+        area[t] = triArea;
+        nx[t] = n.x;
+        ny[t] = n.y;
+        nz[t] = n.z;
+    }
+}
+
+#ifdef CLOTH_GEOMETRY_SSE
+void ClothGeometry::updateRangeSSE(const Particle* particles, size_t begin, size_t end) {
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 minArea = _mm_set1_ps(MIN_AREA);
+
+    for (size_t t = begin; t < end; t += 4) {
+        // Gather the three corners of four triangles into lanes.
+        const glm::vec3* a[4];
+        const glm::vec3* b[4];
+        const glm::vec3* c[4];
+        for (int k = 0; k < 4; ++k) {
+            a[k] = &particles[i0[t + k]].position;
+            b[k] = &particles[i1[t + k]].position;
+            c[k] = &particles[i2[t + k]].position;
+        }
+        __m128 ax = _mm_setr_ps(a[0]->x, a[1]->x, a[2]->x, a[3]->x);
+        __m128 ay = _mm_setr_ps(a[0]->y, a[1]->y, a[2]->y, a[3]->y);
+        __m128 az = _mm_setr_ps(a[0]->z, a[1]->z, a[2]->z, a[3]->z);
+        __m128 e1x = _mm_sub_ps(_mm_setr_ps(b[0]->x, b[1]->x, b[2]->x, b[3]->x), ax);
+        __m128 e1y = _mm_sub_ps(_mm_setr_ps(b[0]->y, b[1]->y, b[2]->y, b[3]->y), ay);
+        __m128 e1z = _mm_sub_ps(_mm_setr_ps(b[0]->z, b[1]->z, b[2]->z, b[3]->z), az);
+        __m128 e2x = _mm_sub_ps(_mm_setr_ps(c[0]->x, c[1]->x, c[2]->x, c[3]->x), ax);
+        __m128 e2y = _mm_sub_ps(_mm_setr_ps(c[0]->y, c[1]->y, c[2]->y, c[3]->y), ay);
+        __m128 e2z = _mm_sub_ps(_mm_setr_ps(c[0]->z, c[1]->z, c[2]->z, c[3]->z), az);
+
+        __m128 cx = _mm_sub_ps(_mm_mul_ps(e1y, e2z), _mm_mul_ps(e1z, e2y));
+        __m128 cy = _mm_sub_ps(_mm_mul_ps(e1z, e2x), _mm_mul_ps(e1x, e2z));
+        __m128 cz = _mm_sub_ps(_mm_mul_ps(e1x, e2y), _mm_mul_ps(e1y, e2x));
+
+        __m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, cx), _mm_mul_ps(cy, cy)), _mm_mul_ps(cz, cz)));
+        __m128 triArea = _mm_mul_ps(half, len);
+        __m128 valid = _mm_cmpge_ps(triArea, minArea);
+
+        // Division by a zero length gives inf/NaN, which the mask clears.
+        __m128 invLen = _mm_div_ps(_mm_set1_ps(1.0f), len);
+        _mm_storeu_ps(&area[t], _mm_and_ps(valid, triArea));
+        _mm_storeu_ps(&nx[t], _mm_and_ps(valid, _mm_mul_ps(cx, invLen)));
+        _mm_storeu_ps(&ny[t], _mm_and_ps(valid, _mm_mul_ps(cy, invLen)));
+        _mm_storeu_ps(&nz[t], _mm_and_ps(valid, _mm_mul_ps(cz, invLen)));
+    }
+}
+#endif
+
+void ClothGeometry::computeVertexNormals(std::vector<glm::vec3>& normals) const {
+    normals.resize(vertexCount);
+    JobSystem::getInstance().parallelFor(vertexCount, 2048, [&](size_t begin, size_t end) {
+        for (size_t v = begin; v < end; ++v) {
+            glm::vec3 sum(0.0f);
+            for (uint32_t t : incidentTriangles(v)) {
+                sum += getNormal(t);
+            }
+            float len2 = glm::dot(sum, sum);
+            normals[v] = len2 > 1e-12f ? sum / glm::sqrt(len2) : glm::vec3(0.0f, 1.0f, 0.0f);
+        }
+    });
+}
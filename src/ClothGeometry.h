@@ -0,0 +1,70 @@
+// ClothGeometry.h
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+#include "Particle.h"
+#include "ClothTriangle.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CLOTH_GEOMETRY_SSE 1
+#endif
+
+// Per-step triangle data of a cloth, computed once in a single fused pass and
+// shared by the aerodynamics, the triangle normals and the renderer's vertex
+// normals. Triangle arrays are SoA and padded to a multiple of 4 so the pass
+// runs four triangles per SSE lane group; padding triangles are degenerate.
+//
+// Scattering per-triangle values to vertices is done as a gather instead:
+// build() stores, for every vertex, the triangles around it (CSR offsets in
+// vertexStart, triangle ids in vertexTriangles), so each vertex is written by
+// exactly one thread and no atomics or locks are needed.
+class ClothGeometry {
+private:
+    size_t triangleCount = 0;
+    size_t vertexCount = 0;
+    std::vector<uint32_t> vertexStart;      // vertexCount + 1 offsets
+    std::vector<uint32_t> vertexTriangles;  // incident triangle ids
+
+    void updateRangeScalar(const Particle* particles, size_t begin, size_t end);
+#ifdef CLOTH_GEOMETRY_SSE
+    void updateRangeSSE(const Particle* particles, size_t begin, size_t end);
+#endif
+
+public:
+    // Vertex indices of each triangle.
+    std::vector<uint32_t> i0, i1, i2;
+    // Results of the last update(). Degenerate triangles get area 0 and a zero normal.
+    std::vector<float> area, nx, ny, nz;
+
+    bool useSIMD = true;
+
+    struct TriangleRange {
+        const uint32_t* first;
+        const uint32_t* last;
+        const uint32_t* begin() const { return first; }
+        const uint32_t* end() const { return last; }
+    };
+
+    // Rebuild indices and adjacency; call whenever the topology changes.
+    void build(const std::vector<Particle>& particles, const std::vector<ClothTriangle>& triangles);
+
+    // Recompute area and unit normal of every triangle from the particle positions.
+    void update(const std::vector<Particle>& particles);
+
+    // Area-independent average of the incident triangle normals, normalized.
+    // Vertices without a usable triangle get +Y.
+    void computeVertexNormals(std::vector<glm::vec3>& normals) const;
+
+    TriangleRange incidentTriangles(size_t vertex) const {
+        return { vertexTriangles.data() + vertexStart[vertex], vertexTriangles.data() + vertexStart[vertex + 1] };
+    }
+
+    glm::vec3 getNormal(size_t triangle) const {
+        return glm::vec3(nx[triangle], ny[triangle], nz[triangle]);
+    }
+
+    size_t getTriangleCount() const { return triangleCount; }
+    size_t getVertexCount() const { return vertexCount; }
+};
@@ -1,34 +1,169 @@
 // ClothManager.cpp
 #include "ClothManager.h"
 #include <iostream>
+#include <chrono>
 #include <GL/glew.h>
+#include "SkinMeshCollider.h"
+#include "SkeletonRenderer.h"
+#include "JointColliders.h"
+#include "Skin.h"
+#include "SkinParser.h"
 
 bool ClothManager::initializeCloth() {
     // Initialize the cloth simulation.
-    cloth.initializeRectangularCloth(numWidth, numHeight, spacing, origin, stiffness, damper, 1);
+    if (addCloth(currentParams()) < 0) return false;
+    groundRenderer.initializeGround(groundLevel);
+    lastTime = glfwGetTime();
+    return true;
+}
+
+ClothParams ClothManager::currentParams() const {
+    ClothParams params;
+    params.numWidth = numWidth;
+    params.numHeight = numHeight;
+    params.spacing = spacing;
+    params.stiffness = stiffness;
+    params.damper = damper;
+    params.origin = origin;
+    params.bendingSprings = bendingSprings;
+    params.tethers = tethers;
+    params.selfCollision = selfCollision;
+    params.meshFile = meshFile;
+    params.pinned = meshPinned;
+    return params;
+}
+
+int ClothManager::addCloth(const ClothParams& params) {
+    ClothInstance instance;
+    instance.params = params;
+    if (params.meshFile.empty()) {
+        if (!buildCloth(instance, nullptr)) return -1;
+    }
+    else {
+        Skin mesh;
+        SkinParser parser;
+        if (!parser.parseSkinFile(params.meshFile, mesh)) {
+            std::cerr << "Failed to load cloth mesh " << params.meshFile << std::endl;
+            return -1;
+        }
+        if (!buildCloth(instance, &mesh)) return -1;
+    }
+
+    instances.push_back(std::move(instance));
+    return static_cast<int>(instances.size()) - 1;
+}
+
+int ClothManager::reloadMesh(const std::string& file, const Skin& mesh) {
+    int rebuilt = 0;
+    for (ClothInstance& instance : instances) {
+        if (instance.params.meshFile != file) continue;
+        ClothInstance replacement;
+        replacement.params = instance.params;
+        if (!buildCloth(replacement, &mesh)) {
+            std::cerr << "Cloth mesh " << file << " did not build, keeping the running cloth" << std::endl;
+            continue;
+        }
+        instance = std::move(replacement);
+        ++rebuilt;
+    }
+    return rebuilt;
+}
+
+bool ClothManager::buildCloth(ClothInstance& instance, const Skin* mesh) {
+    const ClothParams& params = instance.params;
+    instance.cloth = std::make_unique<Cloth>();
+    instance.renderer = std::make_unique<ClothRenderer>();
+
+    Cloth& cloth = *instance.cloth;
+    cloth.bendingSprings = params.bendingSprings;
+    cloth.useTethers = params.tethers;
+    if (!mesh) {
+        cloth.initializeRectangularCloth(params.numWidth, params.numHeight, params.spacing, params.origin, params.stiffness, params.damper, 1);
+    }
+    else {
+        std::vector<glm::vec3> positions;
+        positions.reserve(mesh->vertices.size());
+        for (const SkinVertex& vertex : mesh->vertices) positions.push_back(vertex.position + params.origin);
+        if (!cloth.initializeFromMesh(positions, mesh->triangles, params.pinned, params.stiffness, params.damper, 1)) {
+            return false;
+        }
+    }
+    cloth.selfCollision = params.selfCollision;
     cloth.setGround(this->groundLevel);
     cloth.setWind({0.5, 0.5, 0.5});
+    cloth.setBackend(backendType);
+    for (const auto& collider : colliders) {
+        cloth.addCollider(collider);
+    }
     // Initialize the renderer with the cloth simulation state.
-    renderer.initialize(cloth);
-    renderer.initializeGround(groundLevel);
-    lastTime = glfwGetTime();
+    instance.renderer->initialize(cloth);
     return true;
 }
 
+void ClothManager::setBackend(ClothBackendType type) {
+    backendType = type;
+    for (auto& instance : instances) {
+        instance.cloth->setBackend(type);
+    }
+}
+
+void ClothManager::removeCloth(int index) {
+    if (index < 0 || index >= (int)instances.size()) return;
+    instances.erase(instances.begin() + index);
+    if (selectedCloth >= (int)instances.size()) {
+        selectedCloth = instances.empty() ? 0 : (int)instances.size() - 1;
+    }
+}
+
+void ClothManager::attachSkinCollider(SkeletonRenderer* skeletonRenderer) {
+    if (!skeletonRenderer || !skeletonRenderer->getSkin()) {
+        std::cerr << "No skinned mesh to collide the cloth against." << std::endl;
+        return;
+    }
+    colliders.push_back(std::make_shared<SkinMeshCollider>(skeletonRenderer));
+    for (auto& instance : instances) instance.cloth->addCollider(colliders.back());
+}
+
+void ClothManager::attachJointColliders(Skeleton* skeleton) {
+    if (!skeleton) return;
+    colliders.push_back(std::make_shared<JointColliderSet>(skeleton));
+    for (auto& instance : instances) instance.cloth->addCollider(colliders.back());
+}
+
 void ClothManager::Update(float dt) {
-    // You might choose a fixed timestep here.
-    //float dt = 0.00016f; // ~60 FPS timestep
-    cloth.update(dt);
-    renderer.update(cloth);
-    renderer.updateGroundGeometry(groundLevel);
+    // Shared colliders catch up once, before any cloth reads them.
+    for (auto& collider : colliders) {
+        if (collider->enabled) collider->update();
+    }
 
-    cloth.setGround(this->groundLevel);
+    std::vector<Cloth*> cloths;
+    cloths.reserve(instances.size());
+    for (auto& instance : instances) {
+        instance.cloth->setGround(this->groundLevel);
+        cloths.push_back(instance.cloth.get());
+    }
+    stepController.advance(cloths, dt);
+
+    for (auto& instance : instances) {
+        instance.frameSimMs += instance.cloth->accumulatedStepMs;
+        instance.cloth->accumulatedStepMs = 0.0f;
+    }
     // Optionally, update camera-related information if needed.
     if (camera) {
     }
 }
 
 void ClothManager::render(const glm::mat4& viewProjMatrix, GLuint shaderProgram) {
-    renderer.render(viewProjMatrix, shaderProgram);
-    renderer.renderGround(viewProjMatrix, shaderProgram);
+    for (auto& instance : instances) {
+        auto start = std::chrono::high_resolution_clock::now();
+        instance.renderer->update(*instance.cloth);
+        instance.renderer->render(viewProjMatrix, shaderProgram);
+        auto end = std::chrono::high_resolution_clock::now();
+
+        instance.lastRenderMs = std::chrono::duration<float, std::milli>(end - start).count();
+        instance.lastFrameSimMs = instance.frameSimMs;
+        instance.frameSimMs = 0.0f;
+    }
+    groundRenderer.updateGroundGeometry(groundLevel);
+    groundRenderer.renderGround(viewProjMatrix, shaderProgram);
 }
@@ -1,39 +1,108 @@
 // ClothManager.h
 #pragma once
+#include <memory>
+#include <string>
 #include "Cloth.h"
 #include "ClothRenderer.h"
 #include "Camera.h"
+#include "ClothStepController.h"
+
+class SkeletonRenderer;
+class Skeleton;
+class Skin;
+
+// Construction parameters of one cloth: a rectangular grid, or the triangle
+// mesh of a .skin file (offset by origin) when meshFile is set.
+struct ClothParams {
+    int numWidth = 20, numHeight = 20;
+    float spacing = 0.05f, stiffness = 3000, damper = 10;
+    glm::vec3 origin = glm::vec3(-2, 2, 3);
+    bool bendingSprings = false;
+    bool tethers = false;
+    bool selfCollision = false;
+    std::string meshFile;
+    std::vector<int> pinned;  // mesh vertices held fixed
+};
+
+// One cloth in the scene with its renderer and timings.
+struct ClothInstance {
+    ClothParams params;
+    std::unique_ptr<Cloth> cloth;
+    std::unique_ptr<ClothRenderer> renderer;
+
+    float frameSimMs = 0.0f;      // simulation time accumulated this frame
+    float lastFrameSimMs = 0.0f;  // simulation time of the previous frame
+    float lastRenderMs = 0.0f;    // CPU time of upload + draw last frame
+};
 
 class ClothManager {
 private:
-    Cloth cloth;
-    ClothRenderer renderer;
+    std::vector<ClothInstance> instances;
+    std::vector<std::shared_ptr<ClothCollider>> colliders; // shared by every cloth
+    ClothBackendType backendType = ClothBackendType::SIMD;
+    ClothStepController stepController;
+    ClothRenderer groundRenderer;
     Camera* camera;
 
     double lastTime;
 
+    // Fill instance.cloth and instance.renderer from instance.params; mesh
+    // is the parsed params.meshFile, or null for a rectangular cloth.
+    bool buildCloth(ClothInstance& instance, const Skin* mesh);
+
 public:
+    // Parameters for the next cloth created by initializeCloth()/addCloth().
     int numWidth = 20, numHeight = 20;
     float spacing = 0.05f, stiffness = 3000, damper = 10;
     glm::vec3 origin = glm::vec3(-2, 2, 3);
+    bool bendingSprings = false;
+    bool tethers = false;
+    bool selfCollision = false;
+    std::string meshFile;
+    std::vector<int> meshPinned;
     
     float groundLevel = -10.f;
 
+    int selectedCloth = 0;  // instance shown by getCloth()/getRenderer()
+
     // Initialization functions to set up a cloth simulation.
     bool initializeCloth();
 
+    // Add a cloth built from the given parameters; returns its index, or -1
+    // if its mesh could not be loaded.
+    int addCloth(const ClothParams& params);
+    void removeCloth(int index);
+    // Hot reload: rebuild every cloth made from 'file' with the re-parsed
+    // mesh, keeping its parameters. Returns the number rebuilt.
+    int reloadMesh(const std::string& file, const Skin& mesh);
+    ClothParams currentParams() const;
+
     // Bind a camera (for rendering).
     void bindCamera(Camera* cam) { camera = cam; }
 
-    // Update simulation and renderer.
+    // Collide the cloth against the skinned mesh drawn by a skeleton renderer.
+    void attachSkinCollider(SkeletonRenderer* skeletonRenderer);
+    // Collide the cloth against one capsule or box per joint of a skeleton.
+    void attachJointColliders(Skeleton* skeleton);
+
+    // Solver backend of every cloth, current and future.
+    void setBackend(ClothBackendType type);
+    ClothBackendType getBackend() const { return backendType; }
+
+    // Advance every cloth by a frame of dt seconds in adaptive substeps, each
+    // stepping all cloths concurrently.
     void Update(float dt);
+    ClothStepController& getStepController() { return stepController; }
 
     // Render cloth.
     void render(const glm::mat4& viewProjMatrix, GLuint shaderProgram);
 
     // Expose functions to adjust simulation parameters (e.g., wind, fixed points)
-    void setWind(const glm::vec3& wind) { cloth.setWind(wind); }
-    void moveFixedParticles(const glm::vec3& delta) { cloth.moveFixedParticles(delta); }
-    ClothRenderer* getRenderer() { return &renderer; }
-    Cloth* getCloth() { return &cloth; }
+    void setWind(const glm::vec3& wind) { for (auto& i : instances) i.cloth->setWind(wind); }
+    void moveFixedParticles(const glm::vec3& delta) { if (Cloth* c = getCloth()) c->moveFixedParticles(delta); }
+    ClothRenderer* getRenderer() { return selectedCloth < (int)instances.size() ? instances[selectedCloth].renderer.get() : nullptr; }
+    Cloth* getCloth() { return selectedCloth < (int)instances.size() ? instances[selectedCloth].cloth.get() : nullptr; }
+
+    size_t getClothCount() const { return instances.size(); }
+    const ClothInstance& getClothInstance(size_t index) const { return instances[index]; }
 };
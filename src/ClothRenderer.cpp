@@ -1,35 +1,14 @@
 #include "ClothRenderer.h"
+#include "Shader.h"
+#include "FrameStats.h"
 #include <iostream>
 #include <glm/gtc/type_ptr.hpp>
 #include <algorithm>
 
-// Helper: Compute per-vertex normals by averaging the normals of all triangles incident to each particle.
+// Per-vertex normals come from the cloth's triangle pass: the average of the
+// incident triangle normals, gathered through its vertex adjacency.
 void ClothRenderer::computeNormals(const Cloth& cloth, std::vector<glm::vec3>& normals) {
-    // Initialize normals to zero.
-    normals.resize(cloth.particles.size(), glm::vec3(0.0f));
-
-    // For each cloth triangle (ClothTriangle) accumulate its normal to each vertex.
-    for (const auto& tri : cloth.triangles) {
-        // Compute triangle normal using the three particles.
-        glm::vec3 edge1 = tri.p2->position - tri.p1->position;
-        glm::vec3 edge2 = tri.p3->position - tri.p1->position;
-        glm::vec3 triNormal = glm::normalize(glm::cross(edge1, edge2));
-
-        // Find indices of the particles in cloth.particles.
-        auto idx1 = std::find_if(cloth.particles.begin(), cloth.particles.end(), [&](const Particle& p) { return &p == tri.p1; }) - cloth.particles.begin();
-        auto idx2 = std::find_if(cloth.particles.begin(), cloth.particles.end(), [&](const Particle& p) { return &p == tri.p2; }) - cloth.particles.begin();
-        auto idx3 = std::find_if(cloth.particles.begin(), cloth.particles.end(), [&](const Particle& p) { return &p == tri.p3; }) - cloth.particles.begin();
-
-        // Accumulate the triangle normal to each vertex.
-        if (idx1 < normals.size()) normals[idx1] += triNormal;
-        if (idx2 < normals.size()) normals[idx2] += triNormal;
-        if (idx3 < normals.size()) normals[idx3] += triNormal;
-    }
-
-    // Normalize all normals.
-    for (auto& n : normals) {
-        n = glm::normalize(n);
-    }
+    cloth.getGeometry().computeVertexNormals(normals);
 }
 
 void ClothRenderer::setupBuffers(const Cloth& cloth) {
@@ -59,20 +38,13 @@ void ClothRenderer::setupBuffers(const Cloth& cloth) {
     }
 
     // Build index data from cloth triangles.
+    const ClothGeometry& geometry = cloth.getGeometry();
     indexData.clear();
-    for (const auto& tri : cloth.triangles) {
-        GLuint i1 = static_cast<GLuint>(
-            std::find_if(cloth.particles.begin(), cloth.particles.end(),
-                [&](const Particle& par) { return &par == tri.p1; }) - cloth.particles.begin());
-        GLuint i2 = static_cast<GLuint>(
-            std::find_if(cloth.particles.begin(), cloth.particles.end(),
-                [&](const Particle& par) { return &par == tri.p2; }) - cloth.particles.begin());
-        GLuint i3 = static_cast<GLuint>(
-            std::find_if(cloth.particles.begin(), cloth.particles.end(),
-                [&](const Particle& par) { return &par == tri.p3; }) - cloth.particles.begin());
-        indexData.push_back(i1);
-        indexData.push_back(i2);
-        indexData.push_back(i3);
+    indexData.reserve(3 * geometry.getTriangleCount());
+    for (size_t t = 0; t < geometry.getTriangleCount(); ++t) {
+        indexData.push_back(geometry.i0[t]);
+        indexData.push_back(geometry.i1[t]);
+        indexData.push_back(geometry.i2[t]);
     }
     indexCount = static_cast<GLuint>(indexData.size());
 
@@ -160,12 +132,10 @@ void ClothRenderer::renderGround(const glm::mat4& viewProjMatrix, GLuint shaderP
     if (!groundInitialized) return;
 
     glUseProgram(shaderProgram);
-    GLuint skinModeLoc = glGetUniformLocation(shaderProgram, "useGPUSkinning");
-    glUniform1i(skinModeLoc, 0);
 
     groundMaterial.SetUniforms(shaderProgram, "material");
     directLight.SetUniforms(shaderProgram, "dirLight");
-    pointLight.SetUniforms(shaderProgram, "pointLight");
+    pointLight.SetUniforms(shaderProgram, "pointLights[0]");
 
     //  viewProj  uniform
     GLint vpLoc = glGetUniformLocation(shaderProgram, "viewProj");
@@ -175,10 +145,13 @@ void ClothRenderer::renderGround(const glm::mat4& viewProjMatrix, GLuint shaderP
     glm::mat4 model = glm::mat4(1.0f);
     GLint modelLoc = glGetUniformLocation(shaderProgram, "model");
     glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
+    glm::mat3 normalMatrix = computeNormalMatrix(model);
+    glUniformMatrix3fv(glGetUniformLocation(shaderProgram, "normalMatrix"), 1, GL_FALSE, glm::value_ptr(normalMatrix));
 
 
     glBindVertexArray(groundVAO);
     glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    FrameStats::getInstance().drawCalls++;
     glBindVertexArray(0);
 
     glUseProgram(0);
@@ -235,9 +208,6 @@ void ClothRenderer::update(const Cloth& cloth) {
 void ClothRenderer::render(const glm::mat4& viewProjMatrix, GLuint shaderProgram) {
     glUseProgram(shaderProgram);
 
-    GLuint skinModeLoc = glGetUniformLocation(shaderProgram, "useGPUSkinning");
-    glUniform1i(skinModeLoc, 0);
-
 
     // Set shader uniforms (similar to SkeletonRenderer).
     GLint vpLoc = glGetUniformLocation(shaderProgram, "viewProj");
@@ -247,15 +217,18 @@ void ClothRenderer::render(const glm::mat4& viewProjMatrix, GLuint shaderProgram
     GLint modelLoc = glGetUniformLocation(shaderProgram, "model");
     glm::mat4 model = glm::mat4(1.0f);
     glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
+    glm::mat3 normalMatrix = computeNormalMatrix(model);
+    glUniformMatrix3fv(glGetUniformLocation(shaderProgram, "normalMatrix"), 1, GL_FALSE, glm::value_ptr(normalMatrix));
 
     // Set material uniforms.
     material.SetUniforms(shaderProgram, "material");
     directLight.SetUniforms(shaderProgram, "dirLight");
-    pointLight.SetUniforms(shaderProgram, "pointLight");
+    pointLight.SetUniforms(shaderProgram, "pointLights[0]");
 
     // Draw cloth.
     glBindVertexArray(VAO);
     glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indexCount), GL_UNSIGNED_INT, 0);
+    FrameStats::getInstance().drawCalls++;
     glBindVertexArray(0);
     glUseProgram(0);
 }
@@ -0,0 +1,274 @@
+// ClothSolverBackend.cpp
+#include "ClothSolverBackend.h"
+#include "Cloth.h"
+#include "JobSystem.h"
+#ifdef CLOTH_SOLVER_SSE
+#include <emmintrin.h>
+#endif
+
+namespace {
+    // Each corner's share of the flat-plate drag on triangle t:
+    // F = -0.5 * rho * |v.n|^2 * Cd * A * n, signed by the side the wind hits.
+    glm::vec3 aeroShare(const Cloth& cloth, size_t t) {
+        const ClothGeometry& geometry = cloth.getGeometry();
+        const uint32_t a = geometry.i0[t], b = geometry.i1[t], c = geometry.i2[t];
+        const float area = geometry.area[t];
+        if (area <= 0.0f || (cloth.isAsleep(a) && cloth.isAsleep(b) && cloth.isAsleep(c))) {
+            return glm::vec3(0.0f);
+        }
+
+        const std::vector<Particle>& particles = cloth.particles;
+        glm::vec3 vAvg = (particles[a].velocity + particles[b].velocity + particles[c].velocity) / 3.0f;
+        glm::vec3 vRel = cloth.wind - vAvg;
+        glm::vec3 normal = geometry.getNormal(t);
+
+        float vDotN = glm::dot(vRel, normal);
+        float forceMag = 0.5f * cloth.rho * (vDotN * vDotN) * cloth.Cd * area;
+        float sign = (vDotN >= 0.0f) ? 1.0f : -1.0f;
+        return (-sign * forceMag / 3.0f) * normal;
+    }
+
+    // Gather the aero shares of the triangles around particles [begin, end).
+    void applyAeroShares(Cloth& cloth, const std::vector<glm::vec3>& shares, size_t begin, size_t end) {
+        const ClothGeometry& geometry = cloth.getGeometry();
+        for (size_t v = begin; v < end; ++v) {
+            glm::vec3 force(0.0f);
+            for (uint32_t t : geometry.incidentTriangles(v)) {
+                force += shares[t];
+            }
+            cloth.particles[v].applyForce(force);
+        }
+    }
+
+    // Gravity, drag, ground bounce and explicit Euler for particles [begin, end).
+    void integrateParticles(Cloth& cloth, float dt, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            Particle& p = cloth.particles[i];
+            if (cloth.isAsleep(i)) {
+                p.forceAccum = glm::vec3(0.0f);
+                continue;
+            }
+            // Gravity.
+            p.applyForce(cloth.gravity * p.mass);
+            // Ambient drag, so a hanging cloth eventually comes to rest.
+            p.applyForce(-cloth.ambientDrag * p.velocity);
+
+            if (p.position.y <= cloth.groundLevel && p.velocity.y != 0) {
+                float v_n = p.velocity.y;
+
+                // Compute impulse magnitude:
+                // J = - (1 + restitution) * m * v_n
+                float impulseMagnitude = -(1.0f + cloth.restitution) * v_n * p.mass;
+                glm::vec3 impulse(0.0f, impulseMagnitude, 0.f);
+
+                // Apply the impulse to change the velocity.
+                p.applyImpulse(impulse);
+                p.position.y = cloth.groundLevel + cloth.PHYS_EPISILON;
+            }
+
+            p.update(dt);
+        }
+    }
+}
+
+std::unique_ptr<ClothSolverBackend> ClothSolverBackend::create(ClothBackendType type) {
+    switch (type) {
+    case ClothBackendType::Scalar: return std::make_unique<ScalarClothBackend>();
+    case ClothBackendType::SIMD: return std::make_unique<SIMDClothBackend>();
+    }
+    return nullptr;
+}
+
+const char* ClothSolverBackend::getTypeName(ClothBackendType type) {
+    switch (type) {
+    case ClothBackendType::Scalar: return "Scalar";
+    case ClothBackendType::SIMD: return "Multithreaded SIMD";
+    }
+    return "Unknown";
+}
+
+// ---------------------------------------------------------------------------
+// Scalar reference
+
+void ScalarClothBackend::step(Cloth& cloth, float dt) {
+    const size_t triangleCount = cloth.getGeometry().getTriangleCount();
+    aeroForces.resize(triangleCount);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        aeroForces[t] = aeroShare(cloth, t);
+    }
+    applyAeroShares(cloth, aeroForces, 0, cloth.particles.size());
+
+    const Particle* base = cloth.particles.data();
+    for (auto& spring : cloth.springs) {
+        if (cloth.isAsleep(spring.p1 - base) && cloth.isAsleep(spring.p2 - base)) continue;
+        spring.applyForce();
+    }
+
+    integrateParticles(cloth, dt, 0, cloth.particles.size());
+}
+
+// ---------------------------------------------------------------------------
+// Multithreaded SIMD
+
+void SIMDClothBackend::build(const Cloth& cloth) {
+    const std::vector<SpringDamper>& springs = cloth.springs;
+    const size_t count = springs.size();
+    const size_t padded = (count + 3) & ~size_t(3);
+    const Particle* base = cloth.particles.data();
+
+    lanes.a.assign(padded, 0);
+    lanes.b.assign(padded, 0);
+    lanes.restLength.assign(padded, 0.0f);
+    lanes.stiffness.assign(padded, 0.0f);
+    lanes.damping.assign(padded, 0.0f);
+    lanes.fx.assign(padded, 0.0f);
+    lanes.fy.assign(padded, 0.0f);
+    lanes.fz.assign(padded, 0.0f);
+    for (size_t s = 0; s < count; ++s) {
+        lanes.a[s] = static_cast<uint32_t>(springs[s].p1 - base);
+        lanes.b[s] = static_cast<uint32_t>(springs[s].p2 - base);
+        lanes.restLength[s] = springs[s].restLength;
+        lanes.stiffness[s] = springs[s].stiffness;
+        lanes.damping[s] = springs[s].damping;
+    }
+
+    // Counting sort of spring ends by particle, as in ClothGeometry.
+    const size_t particleCount = cloth.particles.size();
+    particleStart.assign(particleCount + 1, 0);
+    for (size_t s = 0; s < count; ++s) {
+        ++particleStart[lanes.a[s] + 1];
+        ++particleStart[lanes.b[s] + 1];
+    }
+    for (size_t i = 0; i < particleCount; ++i) {
+        particleStart[i + 1] += particleStart[i];
+    }
+    particleSprings.resize(2 * count);
+    std::vector<uint32_t> cursor(particleStart.begin(), particleStart.end() - 1);
+    for (size_t s = 0; s < count; ++s) {
+        particleSprings[cursor[lanes.a[s]]++] = static_cast<uint32_t>(s << 1);
+        particleSprings[cursor[lanes.b[s]]++] = static_cast<uint32_t>((s << 1) | 1);
+    }
+
+    builtTopology = cloth.getTopologyVersion();
+}
+
+void SIMDClothBackend::step(Cloth& cloth, float dt) {
+    if (builtTopology != cloth.getTopologyVersion() || particleStart.size() != cloth.particles.size() + 1) {
+        build(cloth);
+    }
+
+    JobSystem& jobs = JobSystem::getInstance();
+    const size_t triangleCount = cloth.getGeometry().getTriangleCount();
+    const size_t particleCount = cloth.particles.size();
+    aeroForces.resize(triangleCount);
+
+    jobs.parallelFor(triangleCount, 1024, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; ++t) {
+            aeroForces[t] = aeroShare(cloth, t);
+        }
+    });
+
+    // Spring forces four at a time; groups are independent.
+    jobs.parallelFor(lanes.a.size() / 4, 256, [&](size_t begin, size_t end) {
+#ifdef CLOTH_SOLVER_SSE
+        computeSpringsSSE(cloth, begin * 4, end * 4);
+#else
+        computeSpringsScalar(cloth, begin * 4, end * 4);
+#endif
+    });
+
+    // Each particle gathers its aero and spring forces and integrates itself.
+    jobs.parallelFor(particleCount, 1024, [&](size_t begin, size_t end) {
+        applyAeroShares(cloth, aeroForces, begin, end);
+        for (size_t i = begin; i < end; ++i) {
+            if (cloth.isAsleep(i)) continue;
+            glm::vec3 force(0.0f);
+            for (uint32_t k = particleStart[i]; k < particleStart[i + 1]; ++k) {
+                const uint32_t entry = particleSprings[k];
+                const uint32_t s = entry >> 1;
+                glm::vec3 f(lanes.fx[s], lanes.fy[s], lanes.fz[s]);
+                force += (entry & 1) ? -f : f;
+            }
+            cloth.particles[i].applyForce(force);
+        }
+        integrateParticles(cloth, dt, begin, end);
+    });
+}
+
+void SIMDClothBackend::computeSpringsScalar(const Cloth& cloth, size_t begin, size_t end) {
+    const std::vector<Particle>& particles = cloth.particles;
+    for (size_t s = begin; s < end; ++s) {
+        const Particle& p1 = particles[lanes.a[s]];
+        const Particle& p2 = particles[lanes.b[s]];
+        glm::vec3 force(0.0f);
+
+        glm::vec3 delta = p1.position - p2.position;
+        float currentLength = glm::length(delta);
+        bool asleep = cloth.isAsleep(lanes.a[s]) && cloth.isAsleep(lanes.b[s]);
+        if (currentLength > 0.0f && !asleep) {
+            glm::vec3 direction = delta / currentLength;
+            float springForce = -lanes.stiffness[s] * (currentLength - lanes.restLength[s]);
+            float dampingForce = -lanes.damping[s] * glm::dot(p1.velocity - p2.velocity, direction);
+            force = (springForce + dampingForce) * direction;
+        }
+        lanes.fx[s] = force.x;
+        lanes.fy[s] = force.y;
+        lanes.fz[s] = force.z;
+    }
+}
+
+#ifdef CLOTH_SOLVER_SSE
+void SIMDClothBackend::computeSpringsSSE(const Cloth& cloth, size_t begin, size_t end) {
+    const std::vector<Particle>& particles = cloth.particles;
+    const __m128 zero = _mm_setzero_ps();
+
+    for (size_t s = begin; s < end; s += 4) {
+        const Particle* p1[4];
+        const Particle* p2[4];
+        bool allAsleep = true;
+        for (int k = 0; k < 4; ++k) {
+            p1[k] = &particles[lanes.a[s + k]];
+            p2[k] = &particles[lanes.b[s + k]];
+            allAsleep = allAsleep && cloth.isAsleep(lanes.a[s + k]) && cloth.isAsleep(lanes.b[s + k]);
+        }
+        if (allAsleep) {
+            _mm_storeu_ps(&lanes.fx[s], zero);
+            _mm_storeu_ps(&lanes.fy[s], zero);
+            _mm_storeu_ps(&lanes.fz[s], zero);
+            continue;
+        }
+
+        __m128 dx = _mm_setr_ps(p1[0]->position.x - p2[0]->position.x, p1[1]->position.x - p2[1]->position.x,
+                                p1[2]->position.x - p2[2]->position.x, p1[3]->position.x - p2[3]->position.x);
+        __m128 dy = _mm_setr_ps(p1[0]->position.y - p2[0]->position.y, p1[1]->position.y - p2[1]->position.y,
+                                p1[2]->position.y - p2[2]->position.y, p1[3]->position.y - p2[3]->position.y);
+        __m128 dz = _mm_setr_ps(p1[0]->position.z - p2[0]->position.z, p1[1]->position.z - p2[1]->position.z,
+                                p1[2]->position.z - p2[2]->position.z, p1[3]->position.z - p2[3]->position.z);
+        __m128 vx = _mm_setr_ps(p1[0]->velocity.x - p2[0]->velocity.x, p1[1]->velocity.x - p2[1]->velocity.x,
+                                p1[2]->velocity.x - p2[2]->velocity.x, p1[3]->velocity.x - p2[3]->velocity.x);
+        __m128 vy = _mm_setr_ps(p1[0]->velocity.y - p2[0]->velocity.y, p1[1]->velocity.y - p2[1]->velocity.y,
+                                p1[2]->velocity.y - p2[2]->velocity.y, p1[3]->velocity.y - p2[3]->velocity.y);
+        __m128 vz = _mm_setr_ps(p1[0]->velocity.z - p2[0]->velocity.z, p1[1]->velocity.z - p2[1]->velocity.z,
+                                p1[2]->velocity.z - p2[2]->velocity.z, p1[3]->velocity.z - p2[3]->velocity.z);
+
+        __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+        __m128 valid = _mm_cmpgt_ps(length, zero);
+        // Zero-length springs divide by zero here; the mask clears them.
+        __m128 invLength = _mm_and_ps(valid, _mm_div_ps(_mm_set1_ps(1.0f), length));
+        dx = _mm_mul_ps(dx, invLength);
+        dy = _mm_mul_ps(dy, invLength);
+        dz = _mm_mul_ps(dz, invLength);
+
+        __m128 stretch = _mm_sub_ps(length, _mm_loadu_ps(&lanes.restLength[s]));
+        __m128 springForce = _mm_mul_ps(_mm_loadu_ps(&lanes.stiffness[s]), stretch);
+        __m128 closing = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, dx), _mm_mul_ps(vy, dy)), _mm_mul_ps(vz, dz));
+        __m128 dampingForce = _mm_mul_ps(_mm_loadu_ps(&lanes.damping[s]), closing);
+        // -(k * stretch) - (c * closing)
+        __m128 magnitude = _mm_sub_ps(zero, _mm_add_ps(springForce, dampingForce));
+
+        _mm_storeu_ps(&lanes.fx[s], _mm_mul_ps(magnitude, dx));
+        _mm_storeu_ps(&lanes.fy[s], _mm_mul_ps(magnitude, dy));
+        _mm_storeu_ps(&lanes.fz[s], _mm_mul_ps(magnitude, dz));
+    }
+}
+#endif
@@ -0,0 +1,77 @@
+// ClothSolverBackend.h
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CLOTH_SOLVER_SSE 1
+#endif
+
+class Cloth;
+
+enum class ClothBackendType {
+    Scalar,  // single-threaded reference, the original per-spring loop
+    SIMD     // SoA springs in SSE lanes, every pass split across the job system
+};
+
+// The force and integration half of a cloth step: aerodynamics, springs,
+// gravity, drag, ground bounce and explicit Euler. Cloth::update keeps the
+// parts that must behave the same whatever the backend (wake triggers,
+// colliders, self-collision, sleeping, the triangle geometry pass) and hands
+// this part to the backend selected for the cloth.
+//
+// Backends honour sleeping (Cloth::isAsleep) and may keep per-cloth caches;
+// each Cloth owns its own instance.
+class ClothSolverBackend {
+public:
+    virtual ~ClothSolverBackend() = default;
+
+    virtual ClothBackendType getType() const = 0;
+    virtual const char* getName() const = 0;
+
+    // Accumulate every force and advance the particles by dt.
+    virtual void step(Cloth& cloth, float dt) = 0;
+
+    static std::unique_ptr<ClothSolverBackend> create(ClothBackendType type);
+    static const char* getTypeName(ClothBackendType type);
+};
+
+class ScalarClothBackend : public ClothSolverBackend {
+private:
+    std::vector<glm::vec3> aeroForces;
+
+public:
+    ClothBackendType getType() const override { return ClothBackendType::Scalar; }
+    const char* getName() const override { return "Scalar"; }
+    void step(Cloth& cloth, float dt) override;
+};
+
+class SIMDClothBackend : public ClothSolverBackend {
+private:
+    // Springs in SoA form, padded to a multiple of 4 with zero-stiffness springs.
+    struct SpringLanes {
+        std::vector<uint32_t> a, b;
+        std::vector<float> restLength, stiffness, damping;
+        std::vector<float> fx, fy, fz;  // force on 'a'; 'b' gets the opposite
+    };
+    SpringLanes lanes;
+    // For every particle, its springs as (spring << 1) | (particle is 'b').
+    std::vector<uint32_t> particleStart, particleSprings;
+    int builtTopology = -1;
+
+    std::vector<glm::vec3> aeroForces;
+
+    void build(const Cloth& cloth);
+    void computeSpringsScalar(const Cloth& cloth, size_t begin, size_t end);
+#ifdef CLOTH_SOLVER_SSE
+    void computeSpringsSSE(const Cloth& cloth, size_t begin, size_t end);
+#endif
+
+public:
+    ClothBackendType getType() const override { return ClothBackendType::SIMD; }
+    const char* getName() const override { return "Multithreaded SIMD"; }
+    void step(Cloth& cloth, float dt) override;
+};
@@ -0,0 +1,80 @@
+// ClothStepController.cpp
+#include "ClothStepController.h"
+#include "Cloth.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+void ClothStepController::advance(const std::vector<Cloth*>& cloths, float frameDt) {
+    using Clock = std::chrono::high_resolution_clock;
+    const auto frameStart = Clock::now();
+
+    stats.substeps = 0;
+    stats.simulatedTime = 0.0f;
+    frameDt = std::min(frameDt, maxFrameDt);
+    if (cloths.empty() || frameDt <= 0.0f) {
+        stats.frameMs = 0.0f;
+        return;
+    }
+
+    float stableDt = 0.0f;
+    for (Cloth* cloth : cloths) {
+        float limit = cloth->getStepLimits().stableDt;
+        if (limit > 0.0f && (stableDt == 0.0f || limit < stableDt)) stableDt = limit;
+    }
+    stats.stableDt = stableDt;
+
+    std::vector<float> energies(cloths.size());
+    for (size_t i = 0; i < cloths.size(); ++i) energies[i] = cloths[i]->kineticEnergy;
+
+    float remaining = frameDt;
+    bool overrun = false;
+    while (remaining > 1e-6f) {
+        float elapsedMs = std::chrono::duration<float, std::milli>(Clock::now() - frameStart).count();
+        if (stats.substeps >= maxSubsteps || (stats.substeps > 0 && elapsedMs + msPerSubstep > budgetMs)) {
+            overrun = true;
+            break;
+        }
+
+        float dt = remaining;
+        if (stableDt > 0.0f) dt = std::min(dt, stableDt * safety * stabilityScale);
+        for (Cloth* cloth : cloths) {
+            bool colliding = cloth->selfCollision || !cloth->colliders.empty();
+            float minRest = cloth->getStepLimits().minRestLength;
+            if (colliding && cloth->maxSpeed > 0.0f && minRest > 0.0f) {
+                dt = std::min(dt, maxDisplacement * minRest / cloth->maxSpeed);
+            }
+        }
+        // Spread the rest of the frame evenly rather than ending on a sliver.
+        dt = remaining / std::ceil(remaining / dt - 1e-4f);
+
+        auto stepStart = Clock::now();
+        stepCloths(cloths, dt);
+        float stepMs = std::chrono::duration<float, std::milli>(Clock::now() - stepStart).count();
+        msPerSubstep = msPerSubstep == 0.0f ? stepMs : 0.9f * msPerSubstep + 0.1f * stepMs;
+
+        bool spike = false;
+        for (size_t i = 0; i < cloths.size(); ++i) {
+            float energy = cloths[i]->kineticEnergy;
+            float floor = energyFloor * cloths[i]->particles.size();
+            if (!std::isfinite(energy) || energy > energyGrowthLimit * std::max(energies[i], floor)) spike = true;
+            energies[i] = energy;
+        }
+        if (spike) {
+            stabilityScale = std::max(stabilityScale * 0.5f, 1.0f / 64.0f);
+            ++stats.instabilities;
+        }
+        else {
+            stabilityScale = std::min(stabilityScale * 1.01f, 1.0f);
+        }
+
+        remaining -= dt;
+        stats.simulatedTime += dt;
+        stats.dt = dt;
+        ++stats.substeps;
+    }
+
+    if (overrun) ++stats.overruns;
+    stats.stabilityScale = stabilityScale;
+    stats.frameMs = std::chrono::duration<float, std::milli>(Clock::now() - frameStart).count();
+}
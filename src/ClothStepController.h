@@ -0,0 +1,51 @@
+// ClothStepController.h
+#pragma once
+
+#include <vector>
+
+class Cloth;
+
+struct ClothStepStats {
+    float dt = 0.0f;            // substep length used last frame
+    float stableDt = 0.0f;      // stability limit of the stiffest cloth
+    int substeps = 0;           // substeps taken last frame
+    float simulatedTime = 0.0f; // seconds advanced last frame
+    float frameMs = 0.0f;       // CPU time spent stepping last frame
+    float stabilityScale = 1.0f;
+    int overruns = 0;           // frames that hit the budget and dropped time
+    int instabilities = 0;      // energy spikes that shrank the step
+};
+
+// Chooses the cloth timestep per frame instead of a fixed 4 ms. The substep
+// is the smallest of:
+//   - the explicit stability limit of every cloth (ClothStepLimits) times
+//     'safety' and the current stability scale,
+//   - for cloths that collide, the step that keeps the fastest particle under
+//     maxDisplacement rest lengths of travel so contacts are not skipped,
+//   - the time left in the frame.
+// Substeps stop when the next one would exceed budgetMs (or maxSubsteps);
+// the remaining simulated time is dropped and counted as an overrun, so a
+// heavy scene runs slower instead of unstable.
+//
+// Kinetic energy is watched between substeps. Growth by more than
+// energyGrowthLimit in one substep halves the stability scale, which then
+// recovers slowly while the simulation stays calm.
+class ClothStepController {
+private:
+    float stabilityScale = 1.0f;
+    float msPerSubstep = 0.0f;  // running average
+
+public:
+    float budgetMs = 8.0f;
+    int maxSubsteps = 64;
+    float maxFrameDt = 0.1f;    // longer frames (stalls, breakpoints) are clamped
+    float safety = 0.9f;
+    float maxDisplacement = 1.0f;
+    float energyGrowthLimit = 4.0f;
+    float energyFloor = 1e-3f;  // J per particle; growth from below this is not a spike
+
+    ClothStepStats stats;
+
+    // Advance the cloths together by frameDt of wall-clock time.
+    void advance(const std::vector<Cloth*>& cloths, float frameDt);
+};
@@ -0,0 +1,201 @@
+// ClothTopology.cpp
+#include "ClothTopology.h"
+#include "Cloth.h"
+#include "Triangle.h"
+#include <algorithm>
+
+namespace {
+    // Flat open-addressing map from a sorted vertex pair to a slot index,
+    // sized once up front so inserting never rehashes.
+    class EdgeHashMap {
+    private:
+        // Key and value side by side so a probe touches one cache line.
+        struct Slot {
+            uint64_t key;
+            uint32_t value;
+        };
+        std::vector<Slot> slots;
+        uint64_t mask = 0;
+        int shift = 64;
+
+    public:
+        static constexpr uint64_t EMPTY = UINT64_MAX;
+
+        static uint64_t makeKey(uint32_t a, uint32_t b) {
+            return a < b ? ((uint64_t)a << 32) | b : ((uint64_t)b << 32) | a;
+        }
+
+        // Room for maxEntries keys at a load factor of at most 3/4.
+        explicit EdgeHashMap(size_t maxEntries) {
+            size_t capacity = 16;
+            int bits = 4;
+            while (capacity * 3 < maxEntries * 4) {
+                capacity <<= 1;
+                ++bits;
+            }
+            slots.assign(capacity, Slot{ EMPTY, 0 });
+            mask = capacity - 1;
+            shift = 64 - bits;
+        }
+
+        // Value stored for key, inserting 'value' if absent; 'inserted' tells which.
+        uint32_t findOrInsert(uint64_t key, uint32_t value, bool& inserted) {
+            uint64_t index = (key * 0x9E3779B97F4A7C15ull) >> shift;
+            while (true) {
+                Slot& slot = slots[index];
+                if (slot.key == key) {
+                    inserted = false;
+                    return slot.value;
+                }
+                if (slot.key == EMPTY) {
+                    slot.key = key;
+                    slot.value = value;
+                    inserted = true;
+                    return value;
+                }
+                index = (index + 1) & mask;
+            }
+        }
+    };
+}
+
+namespace ClothTopology {
+
+void addGridBendingSprings(Cloth& cloth, int numWidth, int numHeight, float stiffness, float damper) {
+    std::vector<Particle>& particles = cloth.particles;
+    if ((int)particles.size() != numWidth * numHeight) return;
+
+    size_t count = 0;
+    if (numWidth > 2) count += (size_t)(numWidth - 2) * numHeight;
+    if (numHeight > 2) count += (size_t)numWidth * (numHeight - 2);
+    cloth.springs.reserve(cloth.springs.size() + count);
+
+    for (int j = 0; j < numHeight; ++j) {
+        for (int i = 0; i < numWidth; ++i) {
+            int index = j * numWidth + i;
+            if (i + 2 < numWidth) {
+                cloth.springs.emplace_back(&particles[index], &particles[index + 2], stiffness, damper);
+            }
+            if (j + 2 < numHeight) {
+                cloth.springs.emplace_back(&particles[index], &particles[index + 2 * numWidth], stiffness, damper);
+            }
+        }
+    }
+}
+
+void buildTethers(Cloth& cloth) {
+    cloth.tethers.clear();
+    const std::vector<Particle>& particles = cloth.particles;
+    const size_t count = particles.size();
+    if (count == 0 || cloth.fixedParticles.empty()) return;
+
+    // Spring adjacency in CSR form.
+    const Particle* base = particles.data();
+    std::vector<uint32_t> start(count + 1, 0);
+    for (const auto& spring : cloth.springs) {
+        ++start[(spring.p1 - base) + 1];
+        ++start[(spring.p2 - base) + 1];
+    }
+    for (size_t i = 0; i < count; ++i) start[i + 1] += start[i];
+    std::vector<uint32_t> neighbours(start[count]);
+    std::vector<uint32_t> cursor(start.begin(), start.end() - 1);
+    for (const auto& spring : cloth.springs) {
+        uint32_t a = static_cast<uint32_t>(spring.p1 - base);
+        uint32_t b = static_cast<uint32_t>(spring.p2 - base);
+        neighbours[cursor[a]++] = b;
+        neighbours[cursor[b]++] = a;
+    }
+
+    // Multi-source BFS: every particle inherits the anchor of whichever fixed
+    // particle reaches it first.
+    const uint32_t none = UINT32_MAX;
+    std::vector<uint32_t> anchor(count, none);
+    std::vector<uint32_t> queue;
+    queue.reserve(count);
+    for (const Particle* p : cloth.fixedParticles) {
+        uint32_t index = static_cast<uint32_t>(p - base);
+        if (anchor[index] != none) continue;
+        anchor[index] = index;
+        queue.push_back(index);
+    }
+    for (size_t head = 0; head < queue.size(); ++head) {
+        uint32_t current = queue[head];
+        for (uint32_t k = start[current]; k < start[current + 1]; ++k) {
+            uint32_t next = neighbours[k];
+            if (anchor[next] != none) continue;
+            anchor[next] = anchor[current];
+            queue.push_back(next);
+        }
+    }
+
+    cloth.tethers.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        if (particles[i].fixed || anchor[i] == none) continue;
+        ClothTether tether;
+        tether.particle = static_cast<uint32_t>(i);
+        tether.anchor = anchor[i];
+        tether.maxLength = glm::length(particles[i].position - particles[anchor[i]].position);
+        cloth.tethers.push_back(tether);
+    }
+}
+
+int findMeshEdges(const std::vector<Triangle>& triangles, std::vector<MeshEdge>& edges) {
+    edges.clear();
+    // A closed manifold mesh has 1.5 edges per triangle, an open one up to 3.
+    edges.reserve(triangles.size() * 3 / 2 + 16);
+    EdgeHashMap map(triangles.size() * 3);
+
+    int nonManifold = 0;
+    for (const Triangle& tri : triangles) {
+        const uint32_t v[3] = { (uint32_t)tri.v0, (uint32_t)tri.v1, (uint32_t)tri.v2 };
+        for (int k = 0; k < 3; ++k) {
+            uint32_t a = v[k], b = v[(k + 1) % 3], opposite = v[(k + 2) % 3];
+            bool inserted = false;
+            uint32_t index = map.findOrInsert(EdgeHashMap::makeKey(a, b), (uint32_t)edges.size(), inserted);
+            if (inserted) {
+                MeshEdge edge;
+                edge.a = std::min(a, b);
+                edge.b = std::max(a, b);
+                edge.opposite[0] = opposite;
+                edge.opposite[1] = MeshEdge::NO_VERTEX;
+                edges.push_back(edge);
+            }
+            else if (edges[index].opposite[1] == MeshEdge::NO_VERTEX) {
+                edges[index].opposite[1] = opposite;
+            }
+            else {
+                ++nonManifold;
+            }
+        }
+    }
+    return nonManifold;
+}
+
+void addMeshSprings(Cloth& cloth, const std::vector<MeshEdge>& edges, bool bending,
+    float stiffness, float damper, float bendingStiffness, float bendingDamper) {
+    std::vector<Particle>& particles = cloth.particles;
+    cloth.springs.reserve(cloth.springs.size() + (bending ? 2 : 1) * edges.size());
+
+    for (const MeshEdge& edge : edges) {
+        cloth.springs.emplace_back(&particles[edge.a], &particles[edge.b], stiffness, damper);
+    }
+    if (!bending) return;
+
+    // Every edge is already in the map, so a bending pair that is also an
+    // edge (or was added from another edge) is found and skipped.
+    EdgeHashMap joined(edges.size() * 2);
+    for (size_t e = 0; e < edges.size(); ++e) {
+        bool inserted = false;
+        joined.findOrInsert(EdgeHashMap::makeKey(edges[e].a, edges[e].b), (uint32_t)e, inserted);
+    }
+    for (const MeshEdge& edge : edges) {
+        uint32_t c = edge.opposite[0], d = edge.opposite[1];
+        if (d == MeshEdge::NO_VERTEX || c == d) continue;
+        bool inserted = false;
+        joined.findOrInsert(EdgeHashMap::makeKey(c, d), 0, inserted);
+        if (!inserted) continue;
+        cloth.springs.emplace_back(&particles[c], &particles[d], bendingStiffness, bendingDamper);
+    }
+}
+
+}
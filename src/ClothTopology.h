@@ -0,0 +1,51 @@
+// ClothTopology.h
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+class Cloth;
+class Triangle;
+
+// Keeps a particle within maxLength of a pinned anchor (a long-range
+// attachment). Only stretching past the limit is corrected, so the cloth can
+// still fold and bunch up towards its anchor.
+struct ClothTether {
+    uint32_t particle;
+    uint32_t anchor;
+    float maxLength;  // rest distance to the anchor
+};
+
+// An edge of a triangle mesh and the vertex opposite it in each of its first
+// two triangles; opposite[1] is NO_VERTEX on a border edge.
+struct MeshEdge {
+    static constexpr uint32_t NO_VERTEX = UINT32_MAX;
+    uint32_t a, b;  // a < b
+    uint32_t opposite[2];
+};
+
+// Builders that add derived connectivity to a cloth. Each runs in O(N) time
+// and memory in the number of particles and springs.
+namespace ClothTopology {
+    // Springs between particles two apart along the rows and columns of a
+    // numWidth x numHeight grid (particle index j * numWidth + i). They resist
+    // folding along grid lines without the cost of a dihedral angle term.
+    void addGridBendingSprings(Cloth& cloth, int numWidth, int numHeight, float stiffness, float damper);
+
+    // One tether per free particle to its nearest fixed particle, nearest in
+    // spring hops (a multi-source BFS over the spring graph), with the rest
+    // distance as the limit, so call it on the rest shape. Replaces
+    // cloth.tethers; empty without fixed particles.
+    void buildTethers(Cloth& cloth);
+
+    // Unique edges of a triangle list, found with an open-addressing hash map
+    // keyed on the sorted vertex pair (expected O(T)). Returns the number of
+    // edges shared by more than two triangles; those keep their first two.
+    int findMeshEdges(const std::vector<Triangle>& triangles, std::vector<MeshEdge>& edges);
+
+    // Structural springs from the unique edges; with bending, also a spring
+    // between the opposite vertices of every pair of triangles sharing an
+    // edge, unless those vertices are already joined.
+    void addMeshSprings(Cloth& cloth, const std::vector<MeshEdge>& edges, bool bending,
+        float stiffness, float damper, float bendingStiffness, float bendingDamper);
+}
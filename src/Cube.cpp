@@ -1,4 +1,6 @@
 #include "Cube.h"
+#include "Shader.h"
+#include "FrameStats.h"
 
 Cube::Cube(glm::vec3 cubeMin, glm::vec3 cubeMax) {
     // Model matrix.
@@ -138,6 +140,8 @@ void Cube::draw(const glm::mat4& viewProjMtx, GLuint shader) {
     // get the locations and send the uniforms to the shader
     glUniformMatrix4fv(glGetUniformLocation(shader, "viewProj"), 1, false, (float*)&viewProjMtx);
     glUniformMatrix4fv(glGetUniformLocation(shader, "model"), 1, GL_FALSE, (float*)&model);
+    glm::mat3 normalMatrix = computeNormalMatrix(model);
+    glUniformMatrix3fv(glGetUniformLocation(shader, "normalMatrix"), 1, GL_FALSE, (float*)&normalMatrix);
     glUniform3fv(glGetUniformLocation(shader, "DiffuseColor"), 1, &color[0]);
 
     // Bind the VAO
@@ -145,6 +149,7 @@ void Cube::draw(const glm::mat4& viewProjMtx, GLuint shader) {
 
     // draw the points using triangles, indexed with the EBO
     glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+    FrameStats::getInstance().drawCalls++;
 
     // Unbind the VAO and shader program
     glBindVertexArray(0);
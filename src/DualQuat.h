@@ -0,0 +1,53 @@
+// DualQuat.h
+#pragma once
+
+#include "core.h"
+#include <glm/gtc/quaternion.hpp>
+
+// Unit dual quaternion for rigid skinning. 'real' holds the rotation and
+// 'dual' encodes the translation (dual = 0.5 * t * real). Packed as 8 floats:
+// (real.xyzw, dual.xyzw), matching two RGBA texels in the joint palette.
+struct DualQuat {
+    glm::quat real;
+    glm::quat dual;
+
+    DualQuat()
+        : real(1.0f, 0.0f, 0.0f, 0.0f), dual(0.0f, 0.0f, 0.0f, 0.0f) {}
+
+    DualQuat(const glm::quat& r, const glm::quat& d)
+        : real(r), dual(d) {}
+
+    // Build from a rigid transform; any scale in the matrix is discarded.
+    static DualQuat fromMatrix(const glm::mat4& m) {
+        glm::quat r = glm::normalize(glm::quat_cast(glm::mat3(m)));
+        glm::vec3 t = glm::vec3(m[3]);
+        glm::quat d = glm::quat(0.0f, t.x, t.y, t.z) * r * 0.5f;
+        return DualQuat(r, d);
+    }
+
+    // Accumulate w * other, flipping sign so both lie in the same hemisphere.
+    void blend(const DualQuat& other, float w, const glm::quat& pivot) {
+        if (glm::dot(other.real, pivot) < 0.0f) w = -w;
+        real += other.real * w;
+        dual += other.dual * w;
+    }
+
+    void normalize() {
+        float len = glm::length(real);
+        if (len <= 0.0f) return;
+        real = real * (1.0f / len);
+        dual = dual * (1.0f / len);
+    }
+
+    glm::vec3 transformPoint(const glm::vec3& p) const {
+        glm::vec3 rv(real.x, real.y, real.z);
+        glm::vec3 dv(dual.x, dual.y, dual.z);
+        glm::vec3 t = 2.0f * (real.w * dv - dual.w * rv + glm::cross(rv, dv));
+        return transformVector(p) + t;
+    }
+
+    glm::vec3 transformVector(const glm::vec3& v) const {
+        glm::vec3 rv(real.x, real.y, real.z);
+        return v + 2.0f * glm::cross(rv, glm::cross(rv, v) + real.w * v);
+    }
+};
@@ -0,0 +1,144 @@
+// FileWatcher.cpp
+#include "FileWatcher.h"
+#include <cstdio>
+#include <cstring>
+#include <system_error>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+FileWatcher::~FileWatcher() {
+    stop();
+}
+
+void FileWatcher::watch(const std::string& path) {
+    Entry entry;
+    entry.path = path;
+    const std::filesystem::path file(path);
+    entry.directory = file.has_parent_path() ? file.parent_path().string() : ".";
+    entry.name = file.filename().string();
+    stat(entry);
+    entries.push_back(entry);
+}
+
+bool FileWatcher::start(bool forcePolling) {
+    stop();
+    stopping = false;
+    const bool useInotify = !forcePolling && startInotify();
+    try {
+        thread = std::thread(useInotify ? &FileWatcher::inotifyLoop : &FileWatcher::pollLoop, this);
+    }
+    catch (const std::system_error& error) {
+        fprintf(stderr, "FileWatcher::start - cannot start the watcher thread (%s)\n", error.what());
+        stop();
+        return false;
+    }
+    return true;
+}
+
+void FileWatcher::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    if (thread.joinable()) thread.join();
+#ifdef __linux__
+    if (inotifyFd >= 0) close(inotifyFd);
+#endif
+    inotifyFd = -1;
+}
+
+std::vector<std::string> FileWatcher::takeChanges() {
+    const auto now = std::chrono::steady_clock::now();
+    std::vector<std::string> settled;
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto it = changed.begin(); it != changed.end();) {
+        if (now - it->second >= SETTLE_TIME) {
+            settled.push_back(entries[it->first].path);
+            it = changed.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+    return settled;
+}
+
+void FileWatcher::stat(Entry& entry) const {
+    std::error_code error;
+    entry.time = std::filesystem::last_write_time(entry.path, error);
+    entry.exists = !error;
+    entry.size = entry.exists ? std::filesystem::file_size(entry.path, error) : 0;
+}
+
+void FileWatcher::markChanged(size_t entry) {
+    std::lock_guard<std::mutex> lock(mutex);
+    changed[entry] = std::chrono::steady_clock::now();
+}
+
+bool FileWatcher::startInotify() {
+#ifdef __linux__
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd < 0) return false;
+    // Files in one directory share its watch descriptor.
+    const uint32_t events = IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE;
+    for (Entry& entry : entries) {
+        entry.watchDescriptor = inotify_add_watch(inotifyFd, entry.directory.c_str(), events);
+        if (entry.watchDescriptor < 0) {
+            fprintf(stderr, "FileWatcher::startInotify - cannot watch '%s' (%s), polling instead\n",
+                entry.directory.c_str(), strerror(errno));
+            close(inotifyFd);
+            inotifyFd = -1;
+            return false;
+        }
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void FileWatcher::inotifyLoop() {
+#ifdef __linux__
+    alignas(inotify_event) char buffer[16 * 1024];
+    pollfd descriptor{ inotifyFd, POLLIN, 0 };
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stopping) return;
+        }
+        // Short timeout so stop() is not kept waiting.
+        if (poll(&descriptor, 1, 50) <= 0) continue;
+        const ssize_t length = read(inotifyFd, buffer, sizeof(buffer));
+        for (ssize_t offset = 0; offset < length;) {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            offset += sizeof(inotify_event) + event->len;
+            if (event->len == 0) continue;
+            for (size_t i = 0; i < entries.size(); ++i) {
+                if (entries[i].watchDescriptor == event->wd && entries[i].name == event->name) markChanged(i);
+            }
+        }
+    }
+#endif
+}
+
+void FileWatcher::pollLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!wake.wait_for(lock, POLL_INTERVAL, [this]() { return stopping; })) {
+        lock.unlock();
+        for (size_t i = 0; i < entries.size(); ++i) {
+            Entry& entry = entries[i];
+            const auto time = entry.time;
+            const uintmax_t size = entry.size;
+            const bool exists = entry.exists;
+            stat(entry);
+            // A missing file (mid-save) is not a change; its return is.
+            if (entry.exists && (!exists || entry.time != time || entry.size != size)) markChanged(i);
+        }
+        lock.lock();
+    }
+}
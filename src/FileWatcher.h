@@ -0,0 +1,63 @@
+// FileWatcher.h
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Reports watched files that changed on disk, from a background thread. On
+// Linux the directories holding the files are watched with inotify, which
+// also catches editors that save by renaming a new file over the old one;
+// elsewhere, or if inotify is unavailable, modification times and sizes are
+// polled every POLL_INTERVAL. A change is only reported once the file has
+// been quiet for SETTLE_TIME, so it is not read halfway through a save.
+class FileWatcher {
+public:
+    static constexpr std::chrono::milliseconds POLL_INTERVAL{ 250 };
+    static constexpr std::chrono::milliseconds SETTLE_TIME{ 100 };
+
+    FileWatcher() = default;
+    ~FileWatcher();
+
+    // Paths are reported exactly as given. Add them before start().
+    void watch(const std::string& path);
+    // forcePolling skips inotify.
+    bool start(bool forcePolling = false);
+    void stop();
+
+    // Files that changed and settled since the last call, each once.
+    std::vector<std::string> takeChanges();
+
+    bool isUsingInotify() const { return inotifyFd >= 0; }
+
+private:
+    struct Entry {
+        std::string path;
+        std::string directory, name;  // as seen by inotify
+        int watchDescriptor = -1;
+        std::filesystem::file_time_type time;  // as last polled
+        uintmax_t size = 0;
+        bool exists = false;
+    };
+
+    std::vector<Entry> entries;
+    std::unordered_map<size_t, std::chrono::steady_clock::time_point> changed;  // entry -> last event
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::thread thread;
+    bool stopping = false;
+    int inotifyFd = -1;
+
+    bool startInotify();
+    void inotifyLoop();
+    void pollLoop();
+    void stat(Entry& entry) const;
+    void markChanged(size_t entry);
+};
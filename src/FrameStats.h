@@ -0,0 +1,19 @@
+// FrameStats.h
+#pragma once
+
+// Per-frame counters shown in the editor's Performance panel. Renderers and
+// simulation systems add to them; Window resets them at the start of a frame.
+struct FrameStats {
+    int drawCalls = 0;
+    int instancesDrawn = 0;
+
+    static FrameStats& getInstance() {
+        static FrameStats instance;
+        return instance;
+    }
+
+    void beginFrame() {
+        drawCalls = 0;
+        instancesDrawn = 0;
+    }
+};
@@ -0,0 +1,77 @@
+// HotReloader.cpp
+#include "HotReloader.h"
+#include <iostream>
+
+void HotReloader::watch(const std::string& path, AssetType type) {
+    // One file may back several assets (a skin also used as a cloth mesh).
+    bool watched = false;
+    for (const auto& asset : assets) {
+        if (asset.first == path && asset.second == type) return;
+        watched = watched || asset.first == path;
+    }
+    assets.emplace_back(path, type);
+    if (!watched) watcher.watch(path);
+}
+
+void HotReloader::begin(const std::string& path, AssetType type) {
+    for (Pending& parse : pending) {
+        if (parse.reload.path == path && parse.reload.type == type) {
+            parse.changedAgain = true;
+            return;
+        }
+    }
+
+    Pending parse;
+    parse.reload.path = path;
+    parse.reload.type = type;
+    parse.begin = std::chrono::steady_clock::now();
+    switch (type) {
+    case AssetType::Skeleton: parse.skeleton = loader.loadSkeleton(path); break;
+    case AssetType::Skin:
+    case AssetType::ClothMesh: parse.skin = loader.loadSkin(path); break;
+    case AssetType::Animation: parse.clip = loader.loadAnimation(path); break;
+    case AssetType::Shader: break;
+    }
+    pending.push_back(std::move(parse));
+}
+
+bool HotReloader::isReady(const Pending& parse) {
+    auto ready = [](const auto& future) {
+        return !future.valid() || future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    };
+    return ready(parse.skeleton) && ready(parse.skin) && ready(parse.clip);
+}
+
+std::vector<HotReloader::Reload> HotReloader::poll() {
+    for (const std::string& path : watcher.takeChanges()) {
+        for (const auto& asset : assets) {
+            if (asset.first == path) begin(path, asset.second);
+        }
+    }
+
+    std::vector<Reload> finished;
+    for (size_t i = 0; i < pending.size();) {
+        Pending& parse = pending[i];
+        if (!isReady(parse)) {
+            ++i;
+            continue;
+        }
+        Reload reload = std::move(parse.reload);
+        if (parse.skeleton.valid()) reload.skeleton = parse.skeleton.get();
+        if (parse.skin.valid()) reload.skin = parse.skin.get();
+        if (parse.clip.valid()) reload.clip = parse.clip.get();
+        reload.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - parse.begin).count();
+        const bool again = parse.changedAgain;
+        pending.erase(pending.begin() + i);
+        if (again) begin(reload.path, reload.type);
+
+        const bool parsed = reload.type == AssetType::Shader || reload.skeleton || reload.skin || reload.clip;
+        if (parsed) {
+            finished.push_back(std::move(reload));
+        }
+        else {
+            std::cerr << "Hot reload: " << reload.path << " did not load, keeping the running version" << std::endl;
+        }
+    }
+    return finished;
+}
@@ -0,0 +1,59 @@
+// HotReloader.h
+#pragma once
+
+#include "AssetLoader.h"
+#include "FileWatcher.h"
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Watches the files the scene was built from and re-parses only the one that
+// changed, on a background thread through an AssetLoader. poll() hands the
+// parsed assets over between frames, so the caller swaps them in on the main
+// thread (where the GL objects live) and nothing sees a half-loaded asset.
+// An asset that fails to parse is reported and dropped, leaving the running
+// version in place. Shaders need the GL context and are only reported.
+class HotReloader {
+public:
+    enum class AssetType { Skeleton, Skin, Animation, ClothMesh, Shader };
+
+    struct Reload {
+        std::string path;
+        AssetType type;
+        double milliseconds = 0.0;  // from the change being picked up to parsed
+        std::unique_ptr<Skeleton> skeleton;
+        std::unique_ptr<Skin> skin;         // Skin and ClothMesh
+        std::unique_ptr<AnimationClip> clip;
+    };
+
+    // Paths are given as the asset was loaded. Add them before start().
+    void watch(const std::string& path, AssetType type);
+    bool start(bool forcePolling = false) { return watcher.start(forcePolling); }
+    void stop() { watcher.stop(); }
+
+    // Once per frame: starts parsing newly changed files and returns the
+    // assets that finished since the last call. Never blocks.
+    std::vector<Reload> poll();
+
+    bool isUsingInotify() const { return watcher.isUsingInotify(); }
+
+private:
+    struct Pending {
+        Reload reload;
+        std::chrono::steady_clock::time_point begin;
+        std::future<std::unique_ptr<Skeleton>> skeleton;
+        std::future<std::unique_ptr<Skin>> skin;
+        std::future<std::unique_ptr<AnimationClip>> clip;
+        bool changedAgain = false;  // edited while parsing: parse again after
+    };
+
+    FileWatcher watcher;
+    AssetLoader loader;  // outlives the futures in 'pending'
+    std::vector<std::pair<std::string, AssetType>> assets;
+    std::vector<Pending> pending;
+
+    void begin(const std::string& path, AssetType type);
+    static bool isReady(const Pending& parse);
+};
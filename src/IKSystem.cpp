@@ -1,2 +1,420 @@
+// IKSystem.cpp
 #include "IKSystem.h"
+#include <glm/gtx/quaternion.hpp>
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include "JobSystem.h"
 
+namespace {
+    const float IK_EPSILON = 1e-6f;
+
+    // Solve a x = b in place for a small symmetric positive definite a (n x n,
+    // row-major) by Cholesky factorization; a is overwritten by its factor.
+    bool choleskySolve(float* a, float* b, int n) {
+        for (int j = 0; j < n; ++j) {
+            float diagonal = a[j * n + j];
+            for (int k = 0; k < j; ++k) diagonal -= a[j * n + k] * a[j * n + k];
+            if (diagonal <= 0.0f) return false;
+            diagonal = std::sqrt(diagonal);
+            a[j * n + j] = diagonal;
+            for (int i = j + 1; i < n; ++i) {
+                float value = a[i * n + j];
+                for (int k = 0; k < j; ++k) value -= a[i * n + k] * a[j * n + k];
+                a[i * n + j] = value / diagonal;
+            }
+        }
+        for (int i = 0; i < n; ++i) {
+            float value = b[i];
+            for (int k = 0; k < i; ++k) value -= a[i * n + k] * b[k];
+            b[i] = value / a[i * n + i];
+        }
+        for (int i = n - 1; i >= 0; --i) {
+            float value = b[i];
+            for (int k = i + 1; k < n; ++k) value -= a[k * n + i] * b[k];
+            b[i] = value / a[i * n + i];
+        }
+        return true;
+    }
+}
+
+bool IKChain::build(Skeleton& skeleton, const std::vector<Joint*>& effectorJoints, Joint* root) {
+    if (!root) root = skeleton.getRoot().get();
+    if (!root || effectorJoints.empty()) return false;
+
+    // Mark every joint on a path from an effector up to the root.
+    std::vector<Joint*> marked;
+    for (Joint* effector : effectorJoints) {
+        Joint* joint = effector;
+        while (joint && joint != root) {
+            marked.push_back(joint);
+            joint = joint->parent;
+        }
+        if (joint != root) {
+            std::cerr << "IK effector " << (effector ? effector->name : "<null>") << " is not below " << root->name << std::endl;
+            return false;
+        }
+    }
+    marked.push_back(root);
+    std::sort(marked.begin(), marked.end());
+    marked.erase(std::unique(marked.begin(), marked.end()), marked.end());
+    auto isMarked = [&](Joint* joint) { return std::binary_search(marked.begin(), marked.end(), joint); };
+
+    joints.clear();
+    parent.clear();
+    subtreeEnd.clear();
+    std::function<void(Joint*, int)> visit = [&](Joint* joint, int parentIndex) {
+        int index = (int)joints.size();
+        joints.push_back(joint);
+        parent.push_back(parentIndex);
+        subtreeEnd.push_back(0);
+        for (const auto& child : joint->children) {
+            if (isMarked(child.get())) visit(child.get(), index);
+        }
+        subtreeEnd[index] = (int)joints.size();
+    };
+    visit(root, -1);
+
+    const size_t count = joints.size();
+    targetSlot.assign(count, -1);
+    effectors.clear();
+    for (Joint* effector : effectorJoints) {
+        int index = (int)(std::find(joints.begin(), joints.end(), effector) - joints.begin());
+        targetSlot[index] = (int)effectors.size();
+        effectors.push_back(index);
+    }
+
+    offset.resize(count);
+    boneLength.resize(count);
+    pose.resize(count);
+    limitMin.resize(count);
+    limitMax.resize(count);
+    localRotation.resize(count);
+    worldRotation.resize(count);
+    worldPosition.resize(count);
+    solved.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        const Joint* joint = joints[i];
+        offset[i] = joint->offset;
+        boneLength[i] = glm::length(joint->offset);
+        limitMin[i] = glm::vec3(joint->rotXLimit.x, joint->rotYLimit.x, joint->rotZLimit.x);
+        limitMax[i] = glm::vec3(joint->rotXLimit.y, joint->rotYLimit.y, joint->rotZLimit.y);
+    }
+
+    // The parent transform is the root's world matrix with its local one taken off.
+    glm::mat4 base = root->worldMatrix * glm::inverse(root->localMatrix);
+    basePosition = glm::vec3(base[3]);
+    baseRotation = glm::normalize(glm::quat_cast(glm::mat3(base)));
+
+    // Degrees of freedom for the Jacobian solvers.
+    dofJoint.clear();
+    dofAxis.clear();
+    float boneSum = 0.0f;
+    int bones = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (boneLength[i] > IK_EPSILON) {
+            boneSum += boneLength[i];
+            ++bones;
+        }
+        bool moves = false;
+        for (int effector : effectors) moves = moves || (effector > (int)i && effector < subtreeEnd[i]);
+        if (!moves) continue;
+        for (int axis = 2; axis >= 0; --axis) {
+            if (limitMax[i][axis] <= limitMin[i][axis]) continue;
+            dofJoint.push_back((int)i);
+            dofAxis.push_back(axis);
+        }
+    }
+    meanBoneLength = bones > 0 ? boneSum / bones : 1.0f;
+    const size_t rows = 3 * effectors.size(), columns = dofJoint.size();
+    dofWorldAxis.resize(columns);
+    jacobian.resize(rows * columns);
+    normal.resize(rows * rows);
+    residual.resize(rows);
+    step.resize(std::max(rows, columns));
+
+    readPose();
+    return true;
+}
+
+void IKChain::readPose() {
+    for (size_t i = 0; i < joints.size(); ++i) setPose((int)i, joints[i]->pose);
+    updateWorld(0);
+}
+
+void IKChain::writePose() const {
+    for (size_t i = 0; i < joints.size(); ++i) joints[i]->pose = pose[i];
+}
+
+float IKChain::getReach(size_t effector) const {
+    float reach = 0.0f;
+    for (int index = effectors[effector]; index > 0; index = parent[index]) reach += boneLength[index];
+    return reach;
+}
+
+void IKChain::setPose(int index, const glm::vec3& angles) {
+    pose[index] = glm::clamp(angles, limitMin[index], limitMax[index]);
+    localRotation[index] = glm::quat(pose[index]);  // same convention as Joint::computeLocalMatrix
+}
+
+void IKChain::alignJoint(int index, std::vector<glm::vec3>& from, const std::vector<glm::vec3>& to) {
+    int p = parent[index];
+    const glm::quat& parentRotation = p < 0 ? baseRotation : worldRotation[p];
+
+    // pose is applied as Rz * Ry * Rx, so changing one angle turns the whole
+    // subtree about a fixed world axis: Z, then Y after Rz, then X after Rz * Ry.
+    // Each angle gets the least-squares optimum about its axis, clamped, and
+    // the vectors are turned along before the next axis is fitted.
+    glm::quat frame = parentRotation;
+    for (int axis = 2; axis >= 0; --axis) {
+        glm::vec3 unit(0.0f);
+        unit[axis] = 1.0f;
+        const glm::vec3 w = frame * unit;
+        if (limitMax[index][axis] > limitMin[index][axis]) {
+            float sine = 0.0f, cosine = 0.0f;
+            for (size_t k = 0; k < from.size(); ++k) {
+                const glm::vec3& a = from[k];
+                const glm::vec3& b = to[k];
+                sine += glm::dot(b, glm::cross(w, a));
+                cosine += glm::dot(b, a) - glm::dot(b, w) * glm::dot(a, w);
+            }
+            if (std::abs(sine) > IK_EPSILON || cosine < 0.0f) {
+                float angle = std::clamp(pose[index][axis] + std::atan2(sine, cosine), limitMin[index][axis], limitMax[index][axis]);
+                glm::quat turn = glm::angleAxis(angle - pose[index][axis], w);
+                for (glm::vec3& a : from) a = turn * a;
+                pose[index][axis] = angle;
+            }
+        }
+        frame = frame * glm::angleAxis(pose[index][axis], unit);
+    }
+    localRotation[index] = glm::quat(pose[index]);
+}
+
+void IKChain::updateWorld(int first) {
+    for (int i = first; i < subtreeEnd[first]; ++i) {
+        int p = parent[i];
+        const glm::quat& parentRotation = p < 0 ? baseRotation : worldRotation[p];
+        const glm::vec3& parentPosition = p < 0 ? basePosition : worldPosition[p];
+        worldPosition[i] = parentPosition + parentRotation * offset[i];
+        worldRotation[i] = parentRotation * localRotation[i];
+    }
+}
+
+IKSystem::IKSystem() {
+}
+
+IKSystem::~IKSystem() {
+}
+
+const char* IKSystem::getSolverName(IKSolverType type) {
+    switch (type) {
+    case IKSolverType::CCD: return "CCD";
+    case IKSolverType::FABRIK: return "FABRIK";
+    case IKSolverType::JacobianTranspose: return "J^T";
+    case IKSolverType::DLS: return "DLS";
+    }
+    return "Unknown";
+}
+
+IKResult IKSystem::solve(IKChain& chain, const std::vector<glm::vec3>& targets) const {
+    const auto start = std::chrono::high_resolution_clock::now();
+    IKResult result;
+    if (chain.size() == 0 || targets.size() != chain.getEffectorCount()) {
+        std::cerr << "IK solve needs one target per effector" << std::endl;
+        return result;
+    }
+
+    result.error = measureError(chain, targets);
+    while (result.error > tolerance && result.iterations < maxIterations) {
+        if (solver == IKSolverType::CCD) iterateCCD(chain, targets);
+        else if (solver == IKSolverType::FABRIK) iterateFABRIK(chain, targets);
+        else iterateJacobian(chain, targets);
+        ++result.iterations;
+        result.error = measureError(chain, targets);
+    }
+    result.converged = result.error <= tolerance;
+    result.milliseconds = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    return result;
+}
+
+void IKSystem::solveBatch(const std::vector<IKChain*>& chains, const std::vector<std::vector<glm::vec3>>& targets,
+    std::vector<IKResult>& results) const {
+    results.resize(chains.size());
+    if (targets.size() != chains.size()) {
+        std::cerr << "IK batch needs one target list per chain" << std::endl;
+        return;
+    }
+    // Chains keep their own scratch, so each task touches only its chain.
+    JobSystem::getInstance().parallelFor(chains.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) results[i] = solve(*chains[i], targets[i]);
+    });
+}
+
+float IKSystem::measureError(const IKChain& chain, const std::vector<glm::vec3>& targets) const {
+    float error = 0.0f;
+    for (size_t e = 0; e < targets.size(); ++e) {
+        error = std::max(error, glm::length(chain.worldPosition[chain.effectors[e]] - targets[e]));
+    }
+    return error;
+}
+
+void IKSystem::iterateCCD(IKChain& chain, const std::vector<glm::vec3>& targets) const {
+    const int count = (int)chain.size();
+    std::vector<glm::vec3>& from = chain.alignFrom;
+    std::vector<glm::vec3>& to = chain.alignTo;
+
+    // Deepest joints first; each turns to bring the effectors below it toward
+    // their targets, all of them at once in the least-squares sense.
+    for (int j = count - 1; j >= 0; --j) {
+        const glm::vec3 pivot = chain.worldPosition[j];
+        from.clear();
+        to.clear();
+        for (size_t e = 0; e < chain.effectors.size(); ++e) {
+            int effector = chain.effectors[e];
+            if (effector <= j || effector >= chain.subtreeEnd[j]) continue;
+            from.push_back(chain.worldPosition[effector] - pivot);
+            to.push_back(targets[e] - pivot);
+        }
+        if (from.empty()) continue;
+
+        chain.alignJoint(j, from, to);
+        chain.updateWorld(j);
+    }
+}
+
+void IKSystem::iterateFABRIK(IKChain& chain, const std::vector<glm::vec3>& targets) const {
+    const int count = (int)chain.size();
+    std::vector<glm::vec3>& solved = chain.solved;
+    std::vector<glm::vec3>& from = chain.alignFrom;
+    std::vector<glm::vec3>& to = chain.alignTo;
+
+    // Backward: effectors snap to their targets, and every other joint moves
+    // toward the average of where its chain children pull it.
+    for (int j = count - 1; j >= 0; --j) {
+        if (chain.targetSlot[j] >= 0) {
+            solved[j] = targets[chain.targetSlot[j]];
+            continue;
+        }
+        glm::vec3 sum(0.0f);
+        int children = 0;
+        for (int c = j + 1; c < chain.subtreeEnd[j]; c = chain.subtreeEnd[c]) {
+            glm::vec3 toward = chain.worldPosition[j] - solved[c];
+            float length = glm::length(toward);
+            sum += length > IK_EPSILON ? solved[c] + toward * (chain.boneLength[c] / length) : solved[c];
+            ++children;
+        }
+        solved[j] = children > 0 ? sum / (float)children : chain.worldPosition[j];
+    }
+
+    // Forward, root first and in rotations rather than positions: each joint
+    // sits where its (already limited) parent puts it and aims its bones at
+    // the backward positions as closely as its limits allow.
+    for (int j = 0; j < count; ++j) {
+        int p = chain.parent[j];
+        const glm::quat& parentRotation = p < 0 ? chain.baseRotation : chain.worldRotation[p];
+        const glm::vec3& parentPosition = p < 0 ? chain.basePosition : chain.worldPosition[p];
+        chain.worldPosition[j] = parentPosition + parentRotation * chain.offset[j];
+
+        from.clear();
+        to.clear();
+        const glm::quat current = parentRotation * chain.localRotation[j];
+        for (int c = j + 1; c < chain.subtreeEnd[j]; c = chain.subtreeEnd[c]) {
+            from.push_back(current * chain.offset[c]);
+            to.push_back(solved[c] - chain.worldPosition[j]);
+        }
+        if (!from.empty()) chain.alignJoint(j, from, to);
+        chain.worldRotation[j] = parentRotation * chain.localRotation[j];
+    }
+}
+
+void IKSystem::iterateJacobian(IKChain& chain, const std::vector<glm::vec3>& targets) const {
+    const int rows = 3 * (int)chain.effectors.size();
+    const int columns = (int)chain.dofJoint.size();
+    if (columns == 0) return;
+    float* J = chain.jacobian.data();
+    float* e = chain.residual.data();
+    float* step = chain.step.data();
+
+    // Columns: the world axis of each Euler angle crossed with the lever arm
+    // to every effector the joint carries, d(effector)/d(angle) = w x (p_e - p_j).
+    for (int d = 0; d < columns; ++d) {
+        int j = chain.dofJoint[d], axis = chain.dofAxis[d];
+        int p = chain.parent[j];
+        glm::quat frame = p < 0 ? chain.baseRotation : chain.worldRotation[p];
+        if (axis <= 1) frame = frame * glm::angleAxis(chain.pose[j].z, glm::vec3(0.0f, 0.0f, 1.0f));
+        if (axis == 0) frame = frame * glm::angleAxis(chain.pose[j].y, glm::vec3(0.0f, 1.0f, 0.0f));
+        glm::vec3 unit(0.0f);
+        unit[axis] = 1.0f;
+        chain.dofWorldAxis[d] = frame * unit;
+    }
+    std::fill(chain.jacobian.begin(), chain.jacobian.end(), 0.0f);
+    for (int d = 0; d < columns; ++d) {
+        int j = chain.dofJoint[d];
+        for (size_t k = 0; k < chain.effectors.size(); ++k) {
+            int effector = chain.effectors[k];
+            if (effector <= j || effector >= chain.subtreeEnd[j]) continue;
+            glm::vec3 column = glm::cross(chain.dofWorldAxis[d], chain.worldPosition[effector] - chain.worldPosition[j]);
+            for (int r = 0; r < 3; ++r) J[(3 * k + r) * columns + d] = column[r];
+        }
+    }
+
+    // Far targets are approached in steps the linearization can follow.
+    const float stepLength = maxStep * chain.meanBoneLength;
+    for (size_t k = 0; k < chain.effectors.size(); ++k) {
+        glm::vec3 error = targets[k] - chain.worldPosition[chain.effectors[k]];
+        float length = glm::length(error);
+        if (length > stepLength) error *= stepLength / length;
+        for (int r = 0; r < 3; ++r) e[3 * k + r] = error[r];
+    }
+
+    if (solver == IKSolverType::DLS) {
+        // (J J^T + lambda^2 I) y = e, then the angle step is J^T y.
+        float* A = chain.normal.data();
+        const float lambda = damping * chain.meanBoneLength;
+        for (int r = 0; r < rows; ++r) {
+            for (int c = 0; c <= r; ++c) {
+                float sum = 0.0f;
+                for (int d = 0; d < columns; ++d) sum += J[r * columns + d] * J[c * columns + d];
+                A[r * rows + c] = A[c * rows + r] = sum;
+            }
+            A[r * rows + r] += lambda * lambda;
+        }
+        if (!choleskySolve(A, e, rows)) return;
+        for (int d = 0; d < columns; ++d) {
+            float sum = 0.0f;
+            for (int r = 0; r < rows; ++r) sum += J[r * columns + d] * e[r];
+            step[d] = sum;
+        }
+    }
+    else {
+        // J^T e scaled by the step length that is optimal along it,
+        // alpha = <e, J J^T e> / |J J^T e|^2.
+        for (int d = 0; d < columns; ++d) {
+            float sum = 0.0f;
+            for (int r = 0; r < rows; ++r) sum += J[r * columns + d] * e[r];
+            step[d] = sum;
+        }
+        float numerator = 0.0f, denominator = 0.0f;
+        for (int r = 0; r < rows; ++r) {
+            float projected = 0.0f;
+            for (int d = 0; d < columns; ++d) projected += J[r * columns + d] * step[d];
+            numerator += e[r] * projected;
+            denominator += projected * projected;
+        }
+        if (denominator < IK_EPSILON * IK_EPSILON) return;
+        const float alpha = numerator / denominator;
+        for (int d = 0; d < columns; ++d) step[d] *= alpha;
+    }
+
+    for (int d = 0; d < columns; ++d) {
+        int j = chain.dofJoint[d], axis = chain.dofAxis[d];
+        chain.pose[j][axis] = std::clamp(chain.pose[j][axis] + step[d], chain.limitMin[j][axis], chain.limitMax[j][axis]);
+    }
+    for (int d = 0; d < columns; ++d) {
+        int j = chain.dofJoint[d];
+        chain.localRotation[j] = glm::quat(chain.pose[j]);
+    }
+    chain.updateWorld(0);
+}
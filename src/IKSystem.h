@@ -1,24 +1,122 @@
+// IKSystem.h
 #pragma once
 
-#include "SkeletonManager.h"
+#include "Skeleton.h"
+#include <vector>
 
+enum class IKSolverType {
+    CCD,                // cyclic coordinate descent, one joint rotation at a time
+    FABRIK,             // forward and backward reaching on positions, then back to rotations
+    JacobianTranspose,  // gradient step along J^T e, all joints and effectors at once
+    DLS                 // damped least squares, J^T (J J^T + lambda^2 I)^-1 e
+};
+
+struct IKResult {
+    int iterations = 0;
+    float error = 0.0f;  // largest effector distance to its target
+    bool converged = false;
+    float milliseconds = 0.0f;
+};
+
+// The joints between a root and one or more end effectors, copied out of the
+// shared_ptr hierarchy into flat arrays in depth-first order. The subtree of
+// joint i is the contiguous range [i, subtreeEnd[i]), so re-posing a joint
+// only touches the slice after it, and the children of i are found by
+// hopping from i + 1 through subtreeEnd.
+class IKChain {
+private:
+    friend class IKSystem;
+
+    std::vector<Joint*> joints;
+    std::vector<int> parent;      // -1 for the chain root
+    std::vector<int> subtreeEnd;  // exclusive
+    std::vector<int> targetSlot;  // index into the targets, -1 if not an effector
+    std::vector<int> effectors;   // chain index of each effector, in target order
+
+    std::vector<glm::vec3> offset;
+    std::vector<float> boneLength;  // |offset|, the distance to the parent joint
+    std::vector<glm::vec3> pose;    // Euler angles, as in Joint::pose
+    std::vector<glm::vec3> limitMin, limitMax;
+
+    std::vector<glm::quat> localRotation, worldRotation;
+    std::vector<glm::vec3> worldPosition;
+    std::vector<glm::vec3> solved;  // FABRIK scratch positions
+    std::vector<glm::vec3> alignFrom, alignTo;
+
+    // Jacobian solvers: one column per unlocked Euler angle of a joint with an
+    // effector below it, three rows per effector. Scratch is sized in build()
+    // so an iteration does not allocate.
+    std::vector<int> dofJoint, dofAxis;
+    std::vector<glm::vec3> dofWorldAxis;
+    std::vector<float> jacobian;  // rows x columns, row-major
+    std::vector<float> normal;    // J J^T + lambda^2 I, rows x rows
+    std::vector<float> residual, step;
+    float meanBoneLength = 1.0f;
+
+    // World transform of the chain root's parent.
+    glm::quat baseRotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    glm::vec3 basePosition = glm::vec3(0.0f);
+
+    void setPose(int index, const glm::vec3& angles);
+    // Turn a joint within its limits so the world-space vectors 'from' (taken
+    // from the joint, turned in place) best line up with 'to'.
+    void alignJoint(int index, std::vector<glm::vec3>& from, const std::vector<glm::vec3>& to);
+    void updateWorld(int first);  // joint 'first' and its subtree
+
+public:
+    // Collect the joints on the paths from 'root' (the skeleton root if null)
+    // to every effector. The joint world matrices must be current; the parent
+    // of the root stays fixed while solving. Returns false if an effector is
+    // not below the root.
+    bool build(Skeleton& skeleton, const std::vector<Joint*>& effectorJoints, Joint* root = nullptr);
+
+    // Copy poses from the joints (after animation, say) and back after solving.
+    void readPose();
+    void writePose() const;
+
+    size_t size() const { return joints.size(); }
+    size_t getEffectorCount() const { return effectors.size(); }
+    size_t getDegreesOfFreedom() const { return dofJoint.size(); }
+    const glm::vec3& getEffectorPosition(size_t effector) const { return worldPosition[effectors[effector]]; }
+    const glm::vec3& getPosition(size_t index) const { return worldPosition[index]; }
+    const glm::vec3& getPose(size_t index) const { return pose[index]; }
+    Joint* getJoint(size_t index) const { return joints[index]; }
+
+    // Sum of the bone lengths from the root to the effector.
+    float getReach(size_t effector) const;
+};
+
+// Moves the effectors of a chain onto their targets within the joint limits
+// (Joint::rotXLimit/rotYLimit/rotZLimit). Iteration stops as soon as every
+// effector is within 'tolerance', or after maxIterations.
 class IKSystem {
 public:
-	Skeleton* targetPose;
-	std::vector<Joint*> targetsJoints;
+    IKSolverType solver = IKSolverType::FABRIK;
+    int maxIterations = 32;
+    float tolerance = 1e-3f;
 
-	Skeleton* sourcePose;
-	std::vector<Joint*> sourceJoints;
+    // Jacobian solvers. Damping and the per-iteration effector step are in
+    // mean bone lengths of the chain, so one setting suits any skeleton scale.
+    float damping = 0.25f;
+    float maxStep = 1.0f;
 
-	IKSystem();
-	~IKSystem();
+    IKSystem();
+    ~IKSystem();
 
-private:
+    static const char* getSolverName(IKSolverType type);
 
-};
+    // One target per effector, in the order given to IKChain::build. Only the
+    // chain's copy of the pose changes; call writePose() to apply it.
+    IKResult solve(IKChain& chain, const std::vector<glm::vec3>& targets) const;
 
-IKSystem::IKSystem() {
-}
+    // Independent chains (one per character in a crowd, say) solved in
+    // parallel, one job system task each. results is resized to match.
+    void solveBatch(const std::vector<IKChain*>& chains, const std::vector<std::vector<glm::vec3>>& targets,
+        std::vector<IKResult>& results) const;
 
-IKSystem::~IKSystem() {
-}
+private:
+    float measureError(const IKChain& chain, const std::vector<glm::vec3>& targets) const;
+    void iterateCCD(IKChain& chain, const std::vector<glm::vec3>& targets) const;
+    void iterateFABRIK(IKChain& chain, const std::vector<glm::vec3>& targets) const;
+    void iterateJacobian(IKChain& chain, const std::vector<glm::vec3>& targets) const;
+};
@@ -1,6 +1,9 @@
 #include "ImGuiController.h"
 #include "SkeletonManager.h"
 #include "ClothManager.h"
+#include "FrameStats.h"
+#include "JointColliders.h"
+#include "JobSystem.h"
 #include <iostream>
 
 // ̬Աʼ
@@ -116,9 +119,10 @@ void ImGuiController::renderJointRecursive(const std::shared_ptr<Joint>& joint,
     {
         // Edit joint properties
         ImGui::Text("Pose (Euler Angles):");
-        ImGui::DragFloat("Pose X", &joint->pose.x, 0.05f, joint->rotXLimit.x, joint->rotXLimit.y);
-        ImGui::DragFloat("Pose Y", &joint->pose.y, 0.05f, joint->rotYLimit.x, joint->rotYLimit.y);
-        ImGui::DragFloat("Pose Z", &joint->pose.z, 0.05f, joint->rotZLimit.x, joint->rotZLimit.y);
+        bool poseChanged = ImGui::DragFloat("Pose X", &joint->pose.x, 0.05f, joint->rotXLimit.x, joint->rotXLimit.y);
+        poseChanged |= ImGui::DragFloat("Pose Y", &joint->pose.y, 0.05f, joint->rotYLimit.x, joint->rotYLimit.y);
+        poseChanged |= ImGui::DragFloat("Pose Z", &joint->pose.z, 0.05f, joint->rotZLimit.x, joint->rotZLimit.y);
+        if (poseChanged) joint->clampPose();  // typed values are not clamped by the drag
 
         ImGui::DragFloat("Orig Pose X", &joint->orginalPos.x, 0.05f, joint->rotXLimit.x, joint->rotXLimit.y);
         ImGui::DragFloat("Orig Pose Y", &joint->orginalPos.y, 0.05f, joint->rotYLimit.x, joint->rotYLimit.y);
@@ -199,6 +203,12 @@ void ImGuiController::renderFPS() {
     //ImGui::Text("Performance");
     ImGui::Text("FPS: %.1f", fps);
     ImGui::Text("Frame Time: %.3f ms", deltaTime * 1000.0f);
+    ImGui::Text("Draw Calls: %d", FrameStats::getInstance().drawCalls);
+    ImGui::Text("Instances Drawn: %d", FrameStats::getInstance().instancesDrawn);
+    if (skeletonManager && skeletonManager->getSkeleton()) {
+        ImGui::Text("Joints Recomputed: %zu / %zu", skeletonManager->getSkeleton()->getRecomputedCount(),
+            skeletonManager->getSkeleton()->getJointList().size());
+    }
 }
 void ImGuiController::renderSkeletonRendererUI() {
     if (!skeletonManager) {
@@ -236,6 +246,30 @@ void ImGuiController::renderSkeletonRendererUI() {
         ImGui::DragFloat3("Point Light Position", &(renderer->getPointLight()->position[0]), 0.02f);
         ImGui::DragFloat("Point Light Intensity", &(renderer->getPointLight()->intensity), 0.02f);
 
+        // Bones
+        ImGui::Separator();
+        ImGui::Checkbox("Instanced Bone Boxes", &renderer->instancedBones);
+
+        // Skinning
+        ImGui::Separator();
+        ImGui::Text("Skinning");
+        if (ImGui::Checkbox("GPU Skinning", &renderer->renderInGPU)) {
+            skeletonManager->initializeRenderer();
+        }
+        int method = static_cast<int>(renderer->skinningMethod);
+        const char* methodNames[] = { "Linear Blend", "Dual Quaternion" };
+        if (ImGui::Combo("Skinning Method", &method, methodNames, IM_ARRAYSIZE(methodNames))) {
+            renderer->skinningMethod = static_cast<SkinningMethod>(method);
+        }
+        if (ImGui::Button("Run Skinning Benchmark")) {
+            renderer->runSkinningBenchmark();
+        }
+        for (int i = 0; i < 2; ++i) {
+            const SkinningBenchmark& bench = renderer->getSkinningBenchmark(static_cast<SkinningMethod>(i));
+            ImGui::Text("%-16s %2d floats/joint  %6zu B/frame  %.1f ns/vertex",
+                methodNames[i], bench.floatsPerJoint, bench.paletteBytes, bench.nsPerVertex);
+        }
+
     }
     else {
         ImGui::Text("No Skeleton Renderer found!");
@@ -294,8 +328,58 @@ void ImGuiController::renderClothSimulationUI() {
         return;
     }
 
+    if (ImGui::CollapsingHeader("Cloth Instances")) {
+        const int count = static_cast<int>(clothManager->getClothCount());
+        ImGui::Text("%d cloths on %zu threads", count, JobSystem::getInstance().getThreadCount());
+        if (count > 0) {
+            ImGui::SliderInt("Selected Cloth", &clothManager->selectedCloth, 0, count - 1);
+        }
+        const char* backendNames[] = {
+            ClothSolverBackend::getTypeName(ClothBackendType::Scalar),
+            ClothSolverBackend::getTypeName(ClothBackendType::SIMD) };
+        int backend = static_cast<int>(clothManager->getBackend());
+        if (ImGui::Combo("Solver Backend", &backend, backendNames, IM_ARRAYSIZE(backendNames))) {
+            clothManager->setBackend(static_cast<ClothBackendType>(backend));
+        }
+        if (ImGui::Button("Add Cloth")) {
+            // New cloths line up next to each other using the parameters below.
+            ClothParams params = clothManager->currentParams();
+            params.origin.x += count * (params.numWidth * params.spacing + 0.2f);
+            clothManager->addCloth(params);
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Remove Selected") && count > 0) {
+            clothManager->removeCloth(clothManager->selectedCloth);
+        }
+
+        for (size_t i = 0; i < clothManager->getClothCount(); ++i) {
+            const ClothInstance& instance = clothManager->getClothInstance(i);
+            ImGui::Text("#%zu %dx%d  sim %.3f ms/frame  render %.3f ms  %.0f%% active", i,
+                instance.params.numWidth, instance.params.numHeight,
+                instance.lastFrameSimMs, instance.lastRenderMs, instance.cloth->getActivePercent());
+        }
+    }
+
+    if (ImGui::CollapsingHeader("Time Stepping")) {
+        ClothStepController& stepper = clothManager->getStepController();
+        ImGui::SliderFloat("Budget (ms)", &stepper.budgetMs, 1.0f, 33.0f, "%.1f");
+        ImGui::SliderInt("Max Substeps", &stepper.maxSubsteps, 1, 256);
+        ImGui::SliderFloat("Safety", &stepper.safety, 0.1f, 1.0f, "%.2f");
+        ImGui::SliderFloat("Max Travel (rest lengths)", &stepper.maxDisplacement, 0.05f, 1.0f, "%.2f");
+
+        const ClothStepStats& stats = stepper.stats;
+        ImGui::Text("dt %.3f ms (stable limit %.3f ms)", stats.dt * 1000.0f, stats.stableDt * 1000.0f);
+        ImGui::Text("%d substeps, %.1f ms simulated in %.2f ms", stats.substeps, stats.simulatedTime * 1000.0f, stats.frameMs);
+        ImGui::Text("Stability scale %.2f, %d energy spikes", stats.stabilityScale, stats.instabilities);
+        ImGui::Text("Budget overruns: %d", stats.overruns);
+    }
+
     // Get a reference to the cloth simulation.
     Cloth* cloth = clothManager->getCloth();
+    if (!cloth) {
+        ImGui::Text("No cloth selected!");
+        return;
+    }
 
     ImGui::Text("Cloth Simulation Settings");
 
@@ -303,6 +387,13 @@ void ImGuiController::renderClothSimulationUI() {
         ImGui::DragFloat("Damper", &clothManager->damper, 1.f, 0.0f, 0.f, "%.3f");
 
         ImGui::DragFloat("Stifness", &clothManager->stiffness, 1.f, 0.0f, 0.f, "%.3f");
+        ImGui::Checkbox("Bending Springs (new cloths)", &clothManager->bendingSprings);
+        ImGui::Checkbox("Tethers (new cloths)", &clothManager->tethers);
+
+        ImGui::Checkbox("Enforce Tethers", &cloth->useTethers);
+        ImGui::SameLine();
+        ImGui::Text("%zu tethers, %zu springs", cloth->tethers.size(), cloth->springs.size());
+        ImGui::SliderFloat("Tether Slack", &cloth->tetherSlack, 0.0f, 0.5f, "%.2f");
 
         // Gravity vector.
         ImGui::DragFloat3("Gravity", &cloth->gravity[0], 0.1f, -50.0f, 50.0f, "%.2f");
@@ -321,4 +412,49 @@ void ImGuiController::renderClothSimulationUI() {
         }
 
     }
+
+    if (ImGui::CollapsingHeader("Sleeping")) {
+        ImGui::Checkbox("Enable Sleeping", &cloth->sleepingEnabled);
+        ImGui::DragFloat("Ambient Drag", &cloth->ambientDrag, 0.01f, 0.0f, 10.0f, "%.2f");
+        ImGui::DragFloat("Sleep Energy (J)", &cloth->sleepEnergy, 1e-5f, 0.0f, 1.0f, "%.5f");
+        ImGui::DragFloat("Sleep Delay (s)", &cloth->sleepDelay, 0.01f, 0.0f, 10.0f, "%.2f");
+        ImGui::Text("Active particles: %d (%.1f%%)", cloth->activeParticles, cloth->getActivePercent());
+        if (ImGui::Button("Wake")) {
+            cloth->wakeAll();
+        }
+    }
+
+    if (ImGui::CollapsingHeader("Self Collision")) {
+        ImGui::Checkbox("Self Collision (new cloths)", &clothManager->selfCollision);
+        ImGui::Checkbox("Enable Self Collision", &cloth->selfCollision);
+        ImGui::DragFloat("Thickness", &cloth->collisionThickness, 0.001f, 0.0f, 1.0f, "%.3f");
+
+        const SelfCollisionStats& stats = cloth->selfCollisionStats;
+        ImGui::Text("Candidates: %d  Contacts: %d", stats.candidates, stats.contacts);
+        ImGui::Text("Grid %.3f ms  Detect %.3f ms  Resolve %.3f ms", stats.gridMs, stats.detectMs, stats.resolveMs);
+    }
+
+    if (ImGui::CollapsingHeader("Colliders")) {
+        if (cloth->colliders.empty()) {
+            ImGui::Text("No colliders attached.");
+        }
+        for (size_t i = 0; i < cloth->colliders.size(); ++i) {
+            ClothCollider* collider = cloth->colliders[i].get();
+            ImGui::PushID(static_cast<int>(i));
+            ImGui::Checkbox(collider->getName(), &collider->enabled);
+            ImGui::SameLine();
+            ImGui::Text("contacts: %d", i < cloth->colliderContacts.size() ? cloth->colliderContacts[i] : 0);
+            if (JointColliderSet* joints = dynamic_cast<JointColliderSet*>(collider)) {
+                int shape = static_cast<int>(joints->shape);
+                const char* shapeNames[] = { "Capsule", "Box" };
+                if (ImGui::Combo("Shape", &shape, shapeNames, IM_ARRAYSIZE(shapeNames))) {
+                    joints->shape = static_cast<JointColliderShape>(shape);
+                }
+                ImGui::DragFloat("Inflate", &joints->inflate, 0.001f, 0.0f, 1.0f, "%.3f");
+                ImGui::Checkbox("SIMD Batch", &joints->useSIMD);
+            }
+            ImGui::PopID();
+        }
+
+    }
 }
@@ -0,0 +1,140 @@
+// JobSystem.cpp
+#include "JobSystem.h"
+#include <algorithm>
+
+namespace {
+    // Queue owned by the current thread; 0 for threads outside the pool.
+    thread_local size_t currentQueue = 0;
+}
+
+JobSystem::JobSystem() {
+    unsigned hardwareThreads = std::thread::hardware_concurrency();
+    size_t workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+
+    queues.reserve(workerCount + 1);
+    for (size_t i = 0; i < workerCount + 1; ++i) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i) {
+        workers.emplace_back(&JobSystem::workerLoop, this, i + 1);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        if (worker.joinable()) worker.join();
+    }
+}
+
+JobSystem& JobSystem::getInstance() {
+    static JobSystem instance;
+    return instance;
+}
+
+void JobSystem::submit(std::function<void()> job, Counter& counter) {
+    counter.pending.fetch_add(1);
+    Counter* target = &counter;
+    std::function<void()> wrapped = [job = std::move(job), target]() {
+        job();
+        target->pending.fetch_sub(1);
+    };
+
+    if (workers.empty()) {
+        wrapped();
+        return;
+    }
+
+    Queue& queue = *queues[currentQueue];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(wrapped));
+    }
+    queuedJobs.fetch_add(1);
+    {
+        // Taking the lock orders this wake-up after a worker's predicate check.
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    wake.notify_one();
+}
+
+bool JobSystem::tryGetJob(size_t queueIndex, std::function<void()>& job) {
+    // Own queue first, newest job (LIFO keeps nested work cache-warm).
+    {
+        Queue& own = *queues[queueIndex];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty()) {
+            job = std::move(own.jobs.back());
+            own.jobs.pop_back();
+            queuedJobs.fetch_sub(1);
+            return true;
+        }
+    }
+
+    // Steal the oldest job from someone else.
+    const size_t count = queues.size();
+    for (size_t offset = 1; offset < count; ++offset) {
+        Queue& victim = *queues[(queueIndex + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            queuedJobs.fetch_sub(1);
+            steals.fetch_add(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::workerLoop(size_t queueIndex) {
+    currentQueue = queueIndex;
+    std::function<void()> job;
+    while (true) {
+        if (tryGetJob(queueIndex, job)) {
+            job();
+            job = nullptr;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [&] { return stopping || queuedJobs.load() > 0; });
+        if (stopping) return;
+    }
+}
+
+void JobSystem::wait(Counter& counter) {
+    std::function<void()> job;
+    while (counter.pending.load() > 0) {
+        if (tryGetJob(currentQueue, job)) {
+            job();
+            job = nullptr;
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::parallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& body) {
+    if (count == 0) return;
+    if (grainSize == 0) grainSize = 1;
+
+    if (workers.empty() || count <= grainSize) {
+        body(0, count);
+        return;
+    }
+
+    Counter counter;
+    for (size_t begin = grainSize; begin < count; begin += grainSize) {
+        size_t end = std::min(begin + grainSize, count);
+        submit([&body, begin, end]() { body(begin, end); }, counter);
+    }
+    body(0, grainSize);
+    wait(counter);
+}
@@ -0,0 +1,61 @@
+// JobSystem.h
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing job scheduler shared by the simulation systems.
+// Every worker owns a deque: it pushes and pops its own jobs at the back and
+// idle workers steal from the front of the others. Threads outside the pool
+// submit into a shared queue. wait() runs queued jobs while it waits, so a job
+// may submit and wait on child jobs (parallelFor inside a cloth step) without
+// blocking a worker.
+class JobSystem {
+public:
+    // Tracks a group of jobs; wait() returns once all have finished.
+    struct Counter {
+        std::atomic<int> pending{ 0 };
+    };
+
+    static JobSystem& getInstance();
+
+    void submit(std::function<void()> job, Counter& counter);
+    void wait(Counter& counter);
+
+    // Split [0, count) into chunks of grainSize and run them as jobs; the
+    // calling thread runs the first chunk and helps until all are done.
+    void parallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& body);
+
+    // Worker threads plus the calling thread.
+    size_t getThreadCount() const { return workers.size() + 1; }
+    uint64_t getStealCount() const { return steals.load(); }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> jobs;
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<Queue>> queues;  // [0] external threads, [i + 1] worker i
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::atomic<int> queuedJobs{ 0 };
+    std::atomic<uint64_t> steals{ 0 };
+    bool stopping = false;
+
+    JobSystem();
+    ~JobSystem();
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    void workerLoop(size_t queueIndex);
+    bool tryGetJob(size_t queueIndex, std::function<void()>& job);
+};
@@ -0,0 +1,237 @@
+// JointColliders.cpp
+#include "JointColliders.h"
+#include "JobSystem.h"
+#include <functional>
+#ifdef JOINT_COLLIDERS_SSE
+#include <emmintrin.h>
+#endif
+
+JointCapsule JointColliderSet::capsuleFromJoint(const Joint& joint) {
+    JointBox box = boxFromJoint(joint);
+
+    int longest = 0;
+    for (int i = 1; i < 3; ++i) {
+        if (box.halfExtent[i] > box.halfExtent[longest]) longest = i;
+    }
+    float radius = 0.0f;
+    for (int i = 0; i < 3; ++i) {
+        if (i != longest) radius = glm::max(radius, box.halfExtent[i]);
+    }
+    float halfLength = glm::max(box.halfExtent[longest] - radius, 0.0f);
+
+    JointCapsule capsule;
+    capsule.a = box.center - box.axis[longest] * halfLength;
+    capsule.b = box.center + box.axis[longest] * halfLength;
+    capsule.radius = radius;
+    return capsule;
+}
+
+JointBox JointColliderSet::boxFromJoint(const Joint& joint) {
+    glm::vec3 localCenter = 0.5f * (joint.boxMin + joint.boxMax);
+    glm::vec3 localHalf = 0.5f * glm::abs(joint.boxMax - joint.boxMin);
+
+    JointBox box;
+    box.center = glm::vec3(joint.worldMatrix * glm::vec4(localCenter, 1.0f));
+    for (int i = 0; i < 3; ++i) {
+        glm::vec3 column = glm::vec3(joint.worldMatrix[i]);
+        float scale = glm::length(column);
+        box.axis[i] = scale > 0.0f ? column / scale : glm::vec3(0.0f);
+        box.halfExtent[i] = localHalf[i] * scale;
+    }
+    return box;
+}
+
+void JointColliderSet::update() {
+    if (!skeleton) return;
+
+    const auto& joints = skeleton->getJointList();
+    capsules.clear();
+    boxes.clear();
+    for (const auto& joint : joints) {
+        if (shape == JointColliderShape::Capsule) capsules.push_back(capsuleFromJoint(*joint));
+        else boxes.push_back(boxFromJoint(*joint));
+    }
+}
+
+int JointColliderSet::collide(std::vector<Particle>& particles, float thickness, ColliderScratch& lanes) const {
+    const size_t count = particles.size();
+    if (count == 0 || (capsules.empty() && boxes.empty())) return 0;
+
+    // The cloth's scratch lanes only grow, so a steady step does not allocate.
+    const size_t padded = (count + 3) & ~size_t(3);
+    lanes.x.resize(padded);
+    lanes.y.resize(padded);
+    lanes.z.resize(padded);
+    lanes.movable.resize(padded);
+    for (size_t i = 0; i < count; ++i) {
+        lanes.x[i] = particles[i].position.x;
+        lanes.y[i] = particles[i].position.y;
+        lanes.z[i] = particles[i].position.z;
+        lanes.movable[i] = particles[i].fixed ? 0.0f : 1.0f;
+    }
+    for (size_t i = count; i < padded; ++i) {
+        lanes.x[i] = lanes.y[i] = lanes.z[i] = 0.0f;
+        lanes.movable[i] = 0.0f;
+    }
+
+    // Batches of four particles are independent; primitives run in order
+    // within a batch so later ones see earlier corrections.
+    const size_t batches = padded / 4;
+    auto body = [&](size_t begin, size_t end) {
+#ifdef JOINT_COLLIDERS_SSE
+        if (useSIMD) {
+            collideRangeSSE(lanes, begin * 4, end * 4, thickness);
+            return;
+        }
+#endif
+        collideRangeScalar(lanes, begin * 4, end * 4, thickness);
+    };
+    // Passed by reference: a std::function holding the lambda itself would
+    // allocate its captures on every call.
+    JobSystem::getInstance().parallelFor(batches, 64, std::cref(body));
+
+    // Write back and drop the velocity component into the surface, using the
+    // total correction of this pass as the contact normal.
+    int contacts = 0;
+    for (size_t i = 0; i < count; ++i) {
+        Particle& p = particles[i];
+        glm::vec3 corrected(lanes.x[i], lanes.y[i], lanes.z[i]);
+        glm::vec3 delta = corrected - p.position;
+        float len2 = glm::dot(delta, delta);
+        if (len2 <= 0.0f) continue;
+
+        glm::vec3 n = delta / glm::sqrt(len2);
+        p.position = corrected;
+        float vn = glm::dot(p.velocity, n);
+        if (vn < 0.0f) p.velocity -= n * vn;
+        ++contacts;
+    }
+    return contacts;
+}
+
+void JointColliderSet::collideRangeScalar(ColliderScratch& lanes, size_t begin, size_t end, float thickness) const {
+    for (size_t i = begin; i < end; ++i) {
+        if (lanes.movable[i] == 0.0f) continue;
+        glm::vec3 p(lanes.x[i], lanes.y[i], lanes.z[i]);
+
+        for (const JointCapsule& capsule : capsules) {
+            const float reach = capsule.radius + inflate + thickness;
+            glm::vec3 ab = capsule.b - capsule.a;
+            float len2 = glm::dot(ab, ab);
+            float invLen2 = len2 > 0.0f ? 1.0f / len2 : 0.0f;
+
+            glm::vec3 d = p - capsule.a;
+            float t = glm::clamp(glm::dot(d, ab) * invLen2, 0.0f, 1.0f);
+            glm::vec3 diff = d - ab * t;
+            float dist2 = glm::dot(diff, diff);
+            if (dist2 >= reach * reach || dist2 <= 1e-12f) continue;
+
+            float dist = glm::sqrt(dist2);
+            p += diff * ((reach - dist) / dist);
+        }
+
+        for (const JointBox& box : boxes) {
+            glm::vec3 d = p - box.center;
+            glm::vec3 local(glm::dot(d, box.axis[0]), glm::dot(d, box.axis[1]), glm::dot(d, box.axis[2]));
+            glm::vec3 penetration = box.halfExtent + glm::vec3(inflate + thickness) - glm::abs(local);
+            if (penetration.x <= 0.0f || penetration.y <= 0.0f || penetration.z <= 0.0f) continue;
+
+            // Leave through the nearest face.
+            int axis = 0;
+            if (penetration.y < penetration[axis]) axis = 1;
+            if (penetration.z < penetration[axis]) axis = 2;
+            float sign = local[axis] < 0.0f ? -1.0f : 1.0f;
+            p += box.axis[axis] * (penetration[axis] * sign);
+        }
+
+        lanes.x[i] = p.x;
+        lanes.y[i] = p.y;
+        lanes.z[i] = p.z;
+    }
+}
+
+#ifdef JOINT_COLLIDERS_SSE
+void JointColliderSet::collideRangeSSE(ColliderScratch& lanes, size_t begin, size_t end, float thickness) const {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 epsilon = _mm_set1_ps(1e-12f);
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+
+    for (size_t i = begin; i < end; i += 4) {
+        __m128 px = _mm_loadu_ps(&lanes.x[i]);
+        __m128 py = _mm_loadu_ps(&lanes.y[i]);
+        __m128 pz = _mm_loadu_ps(&lanes.z[i]);
+        const __m128 active = _mm_cmpneq_ps(_mm_loadu_ps(&lanes.movable[i]), zero);
+        if (_mm_movemask_ps(active) == 0) continue;
+
+        for (const JointCapsule& capsule : capsules) {
+            const float reachS = capsule.radius + inflate + thickness;
+            glm::vec3 abS = capsule.b - capsule.a;
+            float len2 = glm::dot(abS, abS);
+
+            const __m128 reach = _mm_set1_ps(reachS);
+            const __m128 abx = _mm_set1_ps(abS.x), aby = _mm_set1_ps(abS.y), abz = _mm_set1_ps(abS.z);
+            const __m128 invLen2 = _mm_set1_ps(len2 > 0.0f ? 1.0f / len2 : 0.0f);
+
+            __m128 dx = _mm_sub_ps(px, _mm_set1_ps(capsule.a.x));
+            __m128 dy = _mm_sub_ps(py, _mm_set1_ps(capsule.a.y));
+            __m128 dz = _mm_sub_ps(pz, _mm_set1_ps(capsule.a.z));
+
+            __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, abx), _mm_mul_ps(dy, aby)), _mm_mul_ps(dz, abz)), invLen2);
+            t = _mm_min_ps(_mm_max_ps(t, zero), one);
+
+            __m128 cx = _mm_sub_ps(dx, _mm_mul_ps(abx, t));
+            __m128 cy = _mm_sub_ps(dy, _mm_mul_ps(aby, t));
+            __m128 cz = _mm_sub_ps(dz, _mm_mul_ps(abz, t));
+            __m128 dist2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, cx), _mm_mul_ps(cy, cy)), _mm_mul_ps(cz, cz));
+
+            __m128 hit = _mm_and_ps(_mm_cmplt_ps(dist2, _mm_mul_ps(reach, reach)), _mm_cmpgt_ps(dist2, epsilon));
+            hit = _mm_and_ps(hit, active);
+            if (_mm_movemask_ps(hit) == 0) continue;
+
+            __m128 dist = _mm_sqrt_ps(dist2);
+            __m128 scale = _mm_and_ps(hit, _mm_div_ps(_mm_sub_ps(reach, dist), dist));
+            px = _mm_add_ps(px, _mm_mul_ps(cx, scale));
+            py = _mm_add_ps(py, _mm_mul_ps(cy, scale));
+            pz = _mm_add_ps(pz, _mm_mul_ps(cz, scale));
+        }
+
+        for (const JointBox& box : boxes) {
+            const float grow = inflate + thickness;
+            __m128 dx = _mm_sub_ps(px, _mm_set1_ps(box.center.x));
+            __m128 dy = _mm_sub_ps(py, _mm_set1_ps(box.center.y));
+            __m128 dz = _mm_sub_ps(pz, _mm_set1_ps(box.center.z));
+
+            __m128 local[3], penetration[3];
+            __m128 inside = active;
+            for (int k = 0; k < 3; ++k) {
+                local[k] = _mm_add_ps(_mm_add_ps(
+                    _mm_mul_ps(dx, _mm_set1_ps(box.axis[k].x)),
+                    _mm_mul_ps(dy, _mm_set1_ps(box.axis[k].y))),
+                    _mm_mul_ps(dz, _mm_set1_ps(box.axis[k].z)));
+                penetration[k] = _mm_sub_ps(_mm_set1_ps(box.halfExtent[k] + grow), _mm_andnot_ps(signMask, local[k]));
+                inside = _mm_and_ps(inside, _mm_cmpgt_ps(penetration[k], zero));
+            }
+            if (_mm_movemask_ps(inside) == 0) continue;
+
+            // Nearest face, preferring x then y on ties like the scalar path.
+            __m128 useX = _mm_and_ps(_mm_cmple_ps(penetration[0], penetration[1]), _mm_cmple_ps(penetration[0], penetration[2]));
+            __m128 useY = _mm_andnot_ps(useX, _mm_cmple_ps(penetration[1], penetration[2]));
+            __m128 useZ = _mm_andnot_ps(_mm_or_ps(useX, useY), inside);
+            __m128 use[3] = { _mm_and_ps(useX, inside), _mm_and_ps(useY, inside), useZ };
+
+            for (int k = 0; k < 3; ++k) {
+                __m128 sign = _mm_or_ps(_mm_and_ps(local[k], signMask), one);
+                __m128 amount = _mm_and_ps(use[k], _mm_mul_ps(penetration[k], sign));
+                px = _mm_add_ps(px, _mm_mul_ps(_mm_set1_ps(box.axis[k].x), amount));
+                py = _mm_add_ps(py, _mm_mul_ps(_mm_set1_ps(box.axis[k].y), amount));
+                pz = _mm_add_ps(pz, _mm_mul_ps(_mm_set1_ps(box.axis[k].z), amount));
+            }
+        }
+
+        _mm_storeu_ps(&lanes.x[i], px);
+        _mm_storeu_ps(&lanes.y[i], py);
+        _mm_storeu_ps(&lanes.z[i], pz);
+    }
+}
+#endif
@@ -0,0 +1,61 @@
+// JointColliders.h
+#pragma once
+
+#include "ClothCollider.h"
+#include "Skeleton.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JOINT_COLLIDERS_SSE 1
+#endif
+
+enum class JointColliderShape {
+    Capsule,  // along the longest side of the joint box
+    Box       // the joint box itself, oriented by the joint
+};
+
+struct JointCapsule {
+    glm::vec3 a, b;
+    float radius;
+};
+
+struct JointBox {
+    glm::vec3 center;
+    glm::vec3 axis[3];     // unit axes in world space
+    glm::vec3 halfExtent;  // along each axis, in world units
+};
+
+// Cheap character collision for cloth: one primitive per joint, built from
+// the joint's boxMin/boxMax and following its worldMatrix. A skeleton has tens
+// of primitives, so instead of a hierarchy every particle is tested against
+// every primitive in a batch pass that handles four particles per SSE lane
+// group; a scalar path with identical math is kept for other targets and for
+// cross-checking.
+class JointColliderSet : public ClothCollider {
+private:
+    Skeleton* skeleton;
+
+    // lanes holds the particles in SoA form, padded to a multiple of 4.
+    void collideRangeScalar(ColliderScratch& lanes, size_t begin, size_t end, float thickness) const;
+#ifdef JOINT_COLLIDERS_SSE
+    void collideRangeSSE(ColliderScratch& lanes, size_t begin, size_t end, float thickness) const;
+#endif
+
+public:
+    JointColliderShape shape = JointColliderShape::Capsule;
+    float inflate = 0.0f;   // added to every primitive
+    bool useSIMD = true;
+
+    // World-space primitives, rebuilt from the skeleton in update(). They can
+    // also be filled directly when no skeleton is attached.
+    std::vector<JointCapsule> capsules;
+    std::vector<JointBox> boxes;
+
+    explicit JointColliderSet(Skeleton* skeleton = nullptr) : skeleton(skeleton) {}
+
+    const char* getName() const override { return "Joint Primitives"; }
+    void update() override;
+    int collide(std::vector<Particle>& particles, float thickness, ColliderScratch& scratch) const override;
+
+    static JointCapsule capsuleFromJoint(const Joint& joint);
+    static JointBox boxFromJoint(const Joint& joint);
+};
@@ -0,0 +1,140 @@
+// JointPalette.cpp
+#include "JointPalette.h"
+#include <iostream>
+
+JointPalette::JointPalette()
+    : TBO(0), texture(0), capacity(0), used(0) {}
+
+JointPalette::~JointPalette() {
+    cleanup();
+}
+
+JointPalette& JointPalette::getInstance() {
+    static JointPalette instance;
+    return instance;
+}
+
+void JointPalette::initialize(size_t initialTexels) {
+    if (TBO) return;
+
+    GLint maxTexels = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+    if (maxTexels > 0 && initialTexels > (size_t)maxTexels) {
+        initialTexels = maxTexels;
+    }
+
+    glGenBuffers(1, &TBO);
+    glBindBuffer(GL_TEXTURE_BUFFER, TBO);
+    glBufferData(GL_TEXTURE_BUFFER, initialTexels * 4 * sizeof(GLfloat), nullptr, GL_DYNAMIC_DRAW);
+
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_BUFFER, texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, TBO);
+
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    capacity = initialTexels;
+    used = 0;
+    freeRanges.clear();
+}
+
+void JointPalette::cleanup() {
+    if (texture) {
+        glDeleteTextures(1, &texture);
+        texture = 0;
+    }
+    if (TBO) {
+        glDeleteBuffers(1, &TBO);
+        TBO = 0;
+    }
+    capacity = 0;
+    used = 0;
+    freeRanges.clear();
+}
+
+void JointPalette::grow(size_t minTexels) {
+    size_t newCapacity = capacity ? capacity : 1024;
+    while (newCapacity < minTexels) newCapacity *= 2;
+
+    GLint maxTexels = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+    if (maxTexels > 0 && newCapacity > (size_t)maxTexels) {
+        std::cerr << "WARNING: joint palette clamped to GL_MAX_TEXTURE_BUFFER_SIZE ("
+            << maxTexels << " texels)" << std::endl;
+        newCapacity = maxTexels;
+    }
+
+    // Copy the live ranges into the larger store so other meshes keep their data.
+    GLuint newTBO = 0;
+    glGenBuffers(1, &newTBO);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, newTBO);
+    glBufferData(GL_COPY_WRITE_BUFFER, newCapacity * 4 * sizeof(GLfloat), nullptr, GL_DYNAMIC_DRAW);
+    if (used > 0) {
+        glBindBuffer(GL_COPY_READ_BUFFER, TBO);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, used * 4 * sizeof(GLfloat));
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    glDeleteBuffers(1, &TBO);
+    TBO = newTBO;
+
+    glBindTexture(GL_TEXTURE_BUFFER, texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, TBO);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+    capacity = newCapacity;
+}
+
+int JointPalette::allocate(size_t texelCount) {
+    if (!TBO) initialize();
+
+    // First fit from previously released ranges.
+    for (size_t i = 0; i < freeRanges.size(); ++i) {
+        if (freeRanges[i].second >= texelCount) {
+            size_t offset = freeRanges[i].first;
+            freeRanges[i].first += texelCount;
+            freeRanges[i].second -= texelCount;
+            if (freeRanges[i].second == 0) {
+                freeRanges.erase(freeRanges.begin() + i);
+            }
+            return static_cast<int>(offset);
+        }
+    }
+
+    if (used + texelCount > capacity) {
+        grow(used + texelCount);
+        if (used + texelCount > capacity) {
+            std::cerr << "ERROR: joint palette is full, cannot allocate "
+                << texelCount << " texels" << std::endl;
+            return -1;
+        }
+    }
+
+    size_t offset = used;
+    used += texelCount;
+    return static_cast<int>(offset);
+}
+
+void JointPalette::release(int texelOffset, size_t texelCount) {
+    if (texelOffset < 0 || texelCount == 0) return;
+    freeRanges.emplace_back(static_cast<size_t>(texelOffset), texelCount);
+}
+
+void JointPalette::upload(int texelOffset, const float* data, size_t texelCount) {
+    if (!TBO || texelOffset < 0 || texelCount == 0) return;
+
+    glBindBuffer(GL_TEXTURE_BUFFER, TBO);
+    glBufferSubData(GL_TEXTURE_BUFFER,
+        texelOffset * 4 * sizeof(GLfloat),
+        texelCount * 4 * sizeof(GLfloat),
+        data);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void JointPalette::bind(GLuint shaderProgram, const char* samplerName, GLuint textureUnit) const {
+    glActiveTexture(GL_TEXTURE0 + textureUnit);
+    glBindTexture(GL_TEXTURE_BUFFER, texture);
+    glUniform1i(glGetUniformLocation(shaderProgram, samplerName), textureUnit);
+}
@@ -0,0 +1,46 @@
+// JointPalette.h
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <utility>
+
+// A single texture buffer object (RGBA32F) that holds the skinning palettes of
+// every skinned mesh. Each mesh reserves a contiguous range of texels once and
+// then uploads only its live joints every frame; the shader reads its range
+// through a samplerBuffer starting at a per-draw offset.
+class JointPalette {
+private:
+    GLuint TBO, texture;
+    size_t capacity;  // in texels
+    size_t used;      // high-water mark of allocated texels
+    std::vector<std::pair<size_t, size_t>> freeRanges; // (offset, count) of released ranges
+
+    void grow(size_t minTexels);
+
+public:
+    static const int TEXELS_PER_MATRIX = 4;
+
+    JointPalette();
+    ~JointPalette();
+
+    static JointPalette& getInstance();
+
+    // Create the buffer with room for the given number of texels.
+    void initialize(size_t initialTexels = 4096);
+    void cleanup();
+
+    // Reserve a range of texels and return the offset of its first texel.
+    int allocate(size_t texelCount);
+    void release(int texelOffset, size_t texelCount);
+
+    // Upload texelCount RGBA texels (4 floats each) at the given offset.
+    void upload(int texelOffset, const float* data, size_t texelCount);
+
+    // Bind the palette to a texture unit and point the sampler uniform at it.
+    void bind(GLuint shaderProgram, const char* samplerName, GLuint textureUnit = 0) const;
+
+    size_t getCapacity() const { return capacity; }
+    size_t getUsed() const { return used; }
+};
@@ -0,0 +1,214 @@
+// Retargeter.cpp
+#include "Retargeter.h"
+#include <glm/gtx/quaternion.hpp>
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <unordered_map>
+
+namespace {
+    // Parent index of every joint in a joint list (parents come first).
+    std::vector<int> parentIndices(const std::vector<std::shared_ptr<Joint>>& joints) {
+        std::unordered_map<const Joint*, int> index;
+        for (size_t i = 0; i < joints.size(); ++i) index[joints[i].get()] = (int)i;
+        std::vector<int> parents(joints.size(), -1);
+        for (size_t i = 0; i < joints.size(); ++i) {
+            auto found = index.find(joints[i]->parent);
+            if (found != index.end()) parents[i] = found->second;
+        }
+        return parents;
+    }
+
+    // Rest rotations, local and world, from the poses in the .skel file.
+    void restRotations(const std::vector<std::shared_ptr<Joint>>& joints, const std::vector<int>& parents,
+        std::vector<glm::quat>& local, std::vector<glm::quat>& world) {
+        local.resize(joints.size());
+        world.resize(joints.size());
+        for (size_t i = 0; i < joints.size(); ++i) {
+            local[i] = glm::quat(joints[i]->orginalPos);
+            world[i] = parents[i] < 0 ? local[i] : world[parents[i]] * local[i];
+        }
+    }
+
+    float totalBoneLength(const std::vector<std::shared_ptr<Joint>>& joints, const std::vector<int>& mapped) {
+        float length = 0.0f;
+        for (int i : mapped) {
+            if (i > 0) length += glm::length(joints[i]->originOffset);
+        }
+        return length;
+    }
+}
+
+std::string Retargeter::normalizeName(const std::string& name) {
+    // Split on separators, case changes and letter/digit boundaries.
+    std::vector<std::string> tokens;
+    std::string token;
+    auto flush = [&]() {
+        if (!token.empty()) tokens.push_back(token);
+        token.clear();
+    };
+    for (size_t i = 0; i < name.size(); ++i) {
+        unsigned char c = (unsigned char)name[i];
+        if (!std::isalnum(c)) {
+            flush();
+            continue;
+        }
+        if (!token.empty()) {
+            unsigned char previous = (unsigned char)name[i - 1];
+            bool caseChange = std::islower(previous) && std::isupper(c);
+            bool digitChange = (std::isdigit(previous) != 0) != (std::isdigit(c) != 0);
+            if (caseChange || digitChange) flush();
+        }
+        token += (char)std::tolower(c);
+    }
+    flush();
+
+    std::vector<std::string> kept;
+    for (std::string& t : tokens) {
+        if (t == "mixamorig" || t == "def" || t == "jnt") continue;
+        if (t == "left" || t == "lft") t = "l";
+        if (t == "right" || t == "rgt" || t == "rt") t = "r";
+        if (std::isdigit((unsigned char)t[0])) {
+            size_t digits = t.find_first_not_of('0');
+            t = digits == std::string::npos ? "0" : t.substr(digits);
+        }
+        kept.push_back(t);
+    }
+    std::sort(kept.begin(), kept.end());
+
+    std::string key;
+    for (const std::string& t : kept) {
+        if (!key.empty()) key += ' ';
+        key += t;
+    }
+    return key;
+}
+
+bool Retargeter::build(Skeleton& source, Skeleton& target) {
+    const auto& sourceJoints = source.getJointList();
+    const auto& targetJoints = target.getJointList();
+    sourceIndex.clear();
+    targetIndex.clear();
+    pre.clear();
+    post.clear();
+    mapping.assign(targetJoints.size(), -1);
+    sourceJointCount = sourceJoints.size();
+    if (sourceJoints.empty() || targetJoints.empty()) {
+        std::cerr << "Retargeting needs both joint lists built" << std::endl;
+        return false;
+    }
+
+    const std::vector<int> sourceParents = parentIndices(sourceJoints);
+    const std::vector<int> targetParents = parentIndices(targetJoints);
+
+    // Names first; a source joint is used at most once.
+    std::unordered_multimap<std::string, int> byName;
+    for (size_t i = 0; i < sourceJoints.size(); ++i) byName.emplace(normalizeName(sourceJoints[i]->name), (int)i);
+    std::vector<bool> used(sourceJoints.size(), false);
+    for (size_t t = 0; t < targetJoints.size(); ++t) {
+        auto range = byName.equal_range(normalizeName(targetJoints[t]->name));
+        for (auto it = range.first; it != range.second; ++it) {
+            if (used[it->second]) continue;
+            mapping[t] = it->second;
+            used[it->second] = true;
+            break;
+        }
+    }
+    // Then structure: the n-th child of a matched parent, and the roots.
+    if (mapping[0] < 0 && !used[0]) {
+        mapping[0] = 0;
+        used[0] = true;
+    }
+    for (size_t t = 1; t < targetJoints.size(); ++t) {
+        if (mapping[t] >= 0) continue;
+        int targetParent = targetParents[t];
+        int sourceParent = targetParent < 0 ? -1 : mapping[targetParent];
+        if (sourceParent < 0) continue;
+        const Joint* parentJoint = targetJoints[targetParent].get();
+        const Joint* sourceParentJoint = sourceJoints[sourceParent].get();
+        if (parentJoint->children.size() != sourceParentJoint->children.size()) continue;
+        size_t childSlot = 0;
+        while (parentJoint->children[childSlot].get() != targetJoints[t].get()) ++childSlot;
+        const Joint* candidate = sourceParentJoint->children[childSlot].get();
+        for (size_t s = 0; s < sourceJoints.size(); ++s) {
+            if (sourceJoints[s].get() != candidate) continue;
+            if (!used[s]) {
+                mapping[t] = (int)s;
+                used[s] = true;
+            }
+            break;
+        }
+    }
+
+    // Rest-pose corrections.
+    std::vector<glm::quat> sourceLocal, sourceWorld, targetLocal, targetWorld;
+    restRotations(sourceJoints, sourceParents, sourceLocal, sourceWorld);
+    restRotations(targetJoints, targetParents, targetLocal, targetWorld);
+
+    targetRest.resize(targetJoints.size());
+    std::vector<int> mappedSource, mappedTarget;
+    for (size_t t = 0; t < targetJoints.size(); ++t) {
+        targetRest[t] = targetJoints[t]->orginalPos;
+        int s = mapping[t];
+        if (s < 0) continue;
+        glm::quat align = glm::inverse(sourceWorld[s]) * targetWorld[t];
+        sourceIndex.push_back(s);
+        targetIndex.push_back((int)t);
+        pre.push_back(targetLocal[t] * glm::inverse(align) * glm::inverse(sourceLocal[s]));
+        post.push_back(align);
+        mappedSource.push_back(s);
+        mappedTarget.push_back((int)t);
+    }
+    if (sourceIndex.empty()) {
+        std::cerr << "Retargeting found no matching joints" << std::endl;
+        return false;
+    }
+
+    sourceRootRest = sourceJoints[0]->originOffset;
+    targetRootRest = targetJoints[0]->originOffset;
+    float sourceLength = totalBoneLength(sourceJoints, mappedSource);
+    float targetLength = totalBoneLength(targetJoints, mappedTarget);
+    rootScale = sourceLength > 0.0f ? targetLength / sourceLength : 1.0f;
+    return true;
+}
+
+bool Retargeter::retarget(const std::vector<glm::vec3>& sourcePose, const glm::vec3& sourceRootOffset,
+    std::vector<glm::vec3>& targetPose, glm::vec3& targetRootOffset) const {
+    if (sourceIndex.empty() || sourcePose.size() != sourceJointCount) return false;
+
+    // Unmapped joints go back to rest; the incoming poses of mapped joints
+    // only pick which Euler triple the new rotation is written as.
+    if (targetPose.size() != targetRest.size()) targetPose = targetRest;
+    size_t mapped = 0;
+    for (size_t t = 0; t < targetPose.size(); ++t) {
+        if (mapped < targetIndex.size() && targetIndex[mapped] == (int)t) {
+            ++mapped;
+            continue;
+        }
+        targetPose[t] = targetRest[t];
+    }
+    for (size_t k = 0; k < sourceIndex.size(); ++k) {
+        glm::quat rotation = pre[k] * glm::quat(sourcePose[sourceIndex[k]]) * post[k];
+        targetPose[targetIndex[k]] = nearestEuler(rotation, targetPose[targetIndex[k]]);
+    }
+    targetRootOffset = targetRootRest + (sourceRootOffset - sourceRootRest) * rootScale;
+    return true;
+}
+
+void Retargeter::apply(Skeleton& source, Skeleton& target) {
+    const auto& sourceJoints = source.getJointList();
+    auto& targetJoints = target.getJointList();
+    if (sourceJoints.size() != sourceJointCount || targetJoints.size() != mapping.size()) return;
+
+    sourceFrame.resize(sourceJoints.size());
+    targetFrame.resize(targetJoints.size());
+    for (size_t i = 0; i < sourceJoints.size(); ++i) sourceFrame[i] = sourceJoints[i]->pose;
+    for (size_t i = 0; i < targetJoints.size(); ++i) targetFrame[i] = targetJoints[i]->pose;
+    glm::vec3 rootOffset;
+    if (!retarget(sourceFrame, sourceJoints[0]->offset, targetFrame, rootOffset)) return;
+    for (size_t i = 0; i < targetJoints.size(); ++i) {
+        targetJoints[i]->pose = targetFrame[i];
+        targetJoints[i]->clampPose();
+    }
+    targetJoints[0]->offset = rootOffset;
+}
@@ -0,0 +1,61 @@
+// Retargeter.h
+#pragma once
+
+#include "Skeleton.h"
+#include <vector>
+#include <string>
+
+// Plays poses of one skeleton on another with different proportions or rest
+// poses. build() matches joints once and precomputes, per mapped joint, the
+// rotations that carry a pose from the source rest frame into the target
+// rest frame:
+//
+//     target = pre * source * post,  pre = Rt * A^-1 * Rs^-1,  post = A
+//
+// where Rs, Rt are the local rest rotations and A = Ws^-1 * Wt relates the
+// rest world frames of the two joints. A source joint's rotation away from
+// its rest pose then turns the target joint the same way in world space.
+// Retargeting a frame is one linear pass over the mapped joints.
+class Retargeter {
+private:
+    // Mapped joints, structure of arrays in target joint list order.
+    std::vector<int> sourceIndex, targetIndex;
+    std::vector<glm::quat> pre, post;
+
+    std::vector<glm::vec3> targetRest;  // poses of unmapped target joints
+    glm::vec3 sourceRootRest = glm::vec3(0.0f), targetRootRest = glm::vec3(0.0f);
+    float rootScale = 1.0f;  // target / source size, for root motion
+    std::vector<int> mapping;  // target joint -> source joint or -1
+    size_t sourceJointCount = 0;
+
+    // Per-frame poses of apply(), kept so playback does not allocate.
+    std::vector<glm::vec3> sourceFrame, targetFrame;
+
+public:
+    // Match target joints to source joints: by normalized name first (case,
+    // separators, "left"/"right" vs "l"/"r", zero padding and rig prefixes
+    // ignored), then by position among the children of an already matched
+    // parent. Rest poses are the poses read from the .skel files
+    // (Joint::orginalPos, Joint::originOffset). Both joint lists must be
+    // built. Returns false if nothing matched.
+    bool build(Skeleton& source, Skeleton& target);
+
+    // Retarget one frame. Poses hold Euler angles (as in Joint::pose) in joint
+    // list order; rootOffset is the root joint's offset, whose motion away from
+    // rest is scaled by the size ratio of the skeletons. targetPose comes in
+    // as the target's current pose (or empty): each mapped joint takes the
+    // Euler triple nearest it, see nearestEuler. Returns false, leaving the
+    // target untouched, if sourcePose does not match the source skeleton.
+    bool retarget(const std::vector<glm::vec3>& sourcePose, const glm::vec3& sourceRootOffset,
+        std::vector<glm::vec3>& targetPose, glm::vec3& targetRootOffset) const;
+
+    // Convenience: read the source joints and write the target joints. Does
+    // nothing if either skeleton no longer matches the one given to build().
+    void apply(Skeleton& source, Skeleton& target);
+
+    // Key used to match joint names, e.g. "L_Hip01" and "hip_1_left" both give "1 hip l".
+    static std::string normalizeName(const std::string& name);
+
+    size_t getMappedCount() const { return sourceIndex.size(); }
+    int getSourceJoint(size_t targetJoint) const { return mapping[targetJoint]; }
+};
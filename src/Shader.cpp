@@ -1,11 +1,13 @@
 #include "Shader.h"
+#include <filesystem>
+#include <sstream>
 
 enum ShaderType { 
 	vertex,
 	fragment 
 };
 
-GLuint LoadSingleShader(const char* shaderFilePath, ShaderType type) {
+GLuint LoadSingleShader(const char* shaderFilePath, ShaderType type, const std::string& defines) {
     // Create a shader id.
     GLuint shaderID = 0;
     if (type == vertex)
@@ -29,6 +31,14 @@ GLuint LoadSingleShader(const char* shaderFilePath, ShaderType type) {
         return 0;
     }
 
+    // Inject permutation defines after the #version line.
+    if (!defines.empty()) {
+        size_t versionPos = shaderCode.find("#version");
+        size_t insertPos = (versionPos == std::string::npos) ? 0 : shaderCode.find('\n', versionPos);
+        if (insertPos == std::string::npos) insertPos = shaderCode.size();
+        shaderCode.insert(insertPos, "\n" + defines);
+    }
+
     GLint Result = GL_FALSE;
     int InfoLogLength;
 
@@ -58,9 +68,13 @@ GLuint LoadSingleShader(const char* shaderFilePath, ShaderType type) {
 }
 
 GLuint LoadShaders(const char* vertexFilePath, const char* fragmentFilePath) {
+    return LoadShaders(vertexFilePath, fragmentFilePath, std::string());
+}
+
+GLuint LoadShaders(const char* vertexFilePath, const char* fragmentFilePath, const std::string& defines) {
     // Create the vertex shader and fragment shader.
-    GLuint vertexShaderID = LoadSingleShader(vertexFilePath, vertex);
-    GLuint fragmentShaderID = LoadSingleShader(fragmentFilePath, fragment);
+    GLuint vertexShaderID = LoadSingleShader(vertexFilePath, vertex, defines);
+    GLuint fragmentShaderID = LoadSingleShader(fragmentFilePath, fragment, defines);
 
     // Check both shaders.
     if (vertexShaderID == 0 || fragmentShaderID == 0) return 0;
@@ -73,6 +87,9 @@ GLuint LoadShaders(const char* vertexFilePath, const char* fragmentFilePath) {
     GLuint programID = glCreateProgram();
     glAttachShader(programID, vertexShaderID);
     glAttachShader(programID, fragmentShaderID);
+    if (GLEW_ARB_get_program_binary) {
+        glProgramParameteri(programID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
     glLinkProgram(programID);
 
     // Check the program.
@@ -97,3 +114,188 @@ GLuint LoadShaders(const char* vertexFilePath, const char* fragmentFilePath) {
 
     return programID;
 }
+
+unsigned int ShaderPermutation::key() const {
+    unsigned int k = 0;
+    if (skinning) k |= 1u << 0;
+    if (dualQuaternion) k |= 1u << 1;
+    if (rigidSkinning) k |= 1u << 2;
+    k |= (unsigned int)(std::clamp(maxInfluences, 1, 4) - 1) << 3;
+    k |= (unsigned int)std::clamp(pointLightCount, 0, 7) << 5;
+    if (instancedBones) k |= 1u << 8;
+    return k;
+}
+
+std::string ShaderPermutation::defines() const {
+    std::ostringstream out;
+    if (skinning) {
+        out << "#define GPU_SKINNING\n";
+        if (dualQuaternion) out << "#define DUAL_QUATERNION\n";
+        if (rigidSkinning) out << "#define RIGID_SKINNING\n";
+        out << "#define MAX_INFLUENCES " << std::clamp(maxInfluences, 1, 4) << "\n";
+    }
+    else if (instancedBones) {
+        out << "#define INSTANCED_BONES\n";
+    }
+    out << "#define POINT_LIGHT_COUNT " << std::clamp(pointLightCount, 0, 7) << "\n";
+    return out.str();
+}
+
+ShaderLibrary& ShaderLibrary::getInstance() {
+    static ShaderLibrary instance;
+    return instance;
+}
+
+void ShaderLibrary::initialize(const std::string& vertexPath, const std::string& fragmentPath,
+    const std::string& cacheDirectory) {
+    cleanup();
+    this->vertexPath = vertexPath;
+    this->fragmentPath = fragmentPath;
+    this->cacheDirectory = cacheDirectory;
+}
+
+GLuint ShaderLibrary::getProgram(const ShaderPermutation& permutation) {
+    const unsigned int key = permutation.key();
+    auto it = programs.find(key);
+    if (it != programs.end()) return it->second;
+
+    const std::string defines = permutation.defines();
+    const unsigned long long hash = sourceHash(defines);
+
+    GLuint program = loadBinary(key, hash);
+    if (program) {
+        binaryCacheHits++;
+        printf("Loaded cached program binary for permutation 0x%03x\n", key);
+    }
+    else {
+        program = LoadShaders(vertexPath.c_str(), fragmentPath.c_str(), defines);
+        if (!program) {
+            std::cerr << "Failed to build shader permutation 0x" << std::hex << key << std::dec << std::endl;
+            return 0;
+        }
+        saveBinary(key, hash, program);
+    }
+
+    programs[key] = program;
+    return program;
+}
+
+void ShaderLibrary::invalidate() {
+    for (auto& entry : programs) {
+        glDeleteProgram(entry.second);
+    }
+    programs.clear();
+}
+
+GLuint ShaderLibrary::reload() {
+    const ShaderPermutation base;
+    const std::string defines = base.defines();
+    GLuint program = LoadShaders(vertexPath.c_str(), fragmentPath.c_str(), defines);
+    if (!program) {
+        std::cerr << "Shader sources did not build, keeping the running programs" << std::endl;
+        return 0;
+    }
+    invalidate();
+    programs[base.key()] = program;
+    saveBinary(base.key(), sourceHash(defines), program);
+    return program;
+}
+
+void ShaderLibrary::cleanup() {
+    invalidate();
+    binaryCacheHits = 0;
+}
+
+bool ShaderLibrary::binarySupported() const {
+    if (!GLEW_ARB_get_program_binary) return false;
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+}
+
+// FNV-1a over the driver identity, the defines and both source files, so a
+// cached binary is only reused for exactly the program it was built from.
+unsigned long long ShaderLibrary::sourceHash(const std::string& defines) const {
+    unsigned long long hash = 1469598103934665603ull;
+    auto mix = [&hash](const std::string& text) {
+        for (unsigned char c : text) {
+            hash ^= c;
+            hash *= 1099511628211ull;
+        }
+    };
+
+    const GLubyte* renderer = glGetString(GL_RENDERER);
+    const GLubyte* version = glGetString(GL_VERSION);
+    if (renderer) mix(reinterpret_cast<const char*>(renderer));
+    if (version) mix(reinterpret_cast<const char*>(version));
+    mix(defines);
+
+    for (const std::string& path : { vertexPath, fragmentPath }) {
+        std::ifstream stream(path, std::ios::in | std::ios::binary);
+        std::stringstream buffer;
+        buffer << stream.rdbuf();
+        mix(buffer.str());
+    }
+    return hash;
+}
+
+std::string ShaderLibrary::binaryPath(unsigned int key) const {
+    char name[64];
+    snprintf(name, sizeof(name), "program_%03x.bin", key);
+    return (std::filesystem::path(cacheDirectory) / name).string();
+}
+
+GLuint ShaderLibrary::loadBinary(unsigned int key, unsigned long long hash) const {
+    if (cacheDirectory.empty() || !binarySupported()) return 0;
+
+    std::ifstream in(binaryPath(key), std::ios::in | std::ios::binary);
+    if (!in.is_open()) return 0;
+
+    unsigned long long storedHash = 0;
+    GLenum format = 0;
+    GLint length = 0;
+    in.read(reinterpret_cast<char*>(&storedHash), sizeof(storedHash));
+    in.read(reinterpret_cast<char*>(&format), sizeof(format));
+    in.read(reinterpret_cast<char*>(&length), sizeof(length));
+    if (!in || storedHash != hash || length <= 0) return 0;
+
+    std::vector<char> binary(length);
+    in.read(binary.data(), length);
+    if (!in) return 0;
+
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, format, binary.data(), length);
+
+    // Drivers reject binaries from other versions; fall back to compiling.
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (linked != GL_TRUE) {
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+void ShaderLibrary::saveBinary(unsigned int key, unsigned long long hash, GLuint program) const {
+    if (cacheDirectory.empty() || !binarySupported()) return;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glGetProgramBinary(program, length, nullptr, &format, binary.data());
+
+    std::error_code error;
+    std::filesystem::create_directories(cacheDirectory, error);
+    std::ofstream out(binaryPath(key), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Unable to write shader cache " << binaryPath(key) << std::endl;
+        return;
+    }
+    out.write(reinterpret_cast<const char*>(&hash), sizeof(hash));
+    out.write(reinterpret_cast<const char*>(&format), sizeof(format));
+    out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+    out.write(binary.data(), length);
+}
@@ -4,6 +4,8 @@
 #include <glm/gtx/quaternion.hpp>
 #include <queue>
 #include <algorithm>
+#include <cmath>
+#include <limits>
 
 // Joint class implementation
 Joint::Joint(const std::string& name)
@@ -16,19 +18,23 @@ Joint::Joint(const std::string& name)
     rotYLimit(0.0f),
     rotZLimit(0.0f),
     localMatrix(1.0f),
-    worldMatrix(1.0f) {}
+    worldMatrix(1.0f),
+    parent(nullptr) {}
 
 void Joint::addChild(const std::shared_ptr<Joint>& child) {
     children.push_back(child);
 }
 
-void Joint::computeLocalMatrix() {
-    glm::mat4 offsetMat = glm::translate(glm::mat4(1.0f), offset);
-    
+void Joint::clampPose() {
     pose.x = std::clamp(pose.x, rotXLimit.x, rotXLimit.y);
     pose.y = std::clamp(pose.y, rotYLimit.x, rotYLimit.y);
     pose.z = std::clamp(pose.z, rotZLimit.x, rotZLimit.y);
+}
 
+void Joint::computeLocalMatrix() {
+    glm::mat4 offsetMat = glm::translate(glm::mat4(1.0f), offset);
+    
+    clampPose();
 
     glm::quat orientation = glm::quat(pose);
     glm::mat4 rotationMat = glm::mat4_cast(orientation);
@@ -44,9 +50,45 @@ void Joint::update(const glm::mat4& parentTransform) {
     }
 }
 
+glm::vec3 nearestEuler(const glm::quat& rotation, const glm::vec3& reference) {
+    const float pi = glm::pi<float>();
+    const float turn = 2.0f * pi;
+    auto nearestTurn = [&](glm::vec3 angles) {
+        for (int i = 0; i < 3; ++i) angles[i] += turn * std::round((reference[i] - angles[i]) / turn);
+        return angles;
+    };
+    glm::vec3 a = nearestTurn(glm::eulerAngles(rotation));
+    glm::vec3 b = nearestTurn(glm::vec3(a.x + pi, pi - a.y, a.z + pi));
+    glm::vec3 da = a - reference, db = b - reference;
+    return glm::dot(da, da) <= glm::dot(db, db) ? a : b;
+}
+
+namespace {
+    // local = T(translation) * R(rotation) and world = parent * local, using
+    // only the affine 3x4 part of the parent: a 3x3 product and a 3x3 times
+    // vector in place of two 4x4 products.
+    void composeTransform(const glm::mat4& parent, const LocalTransform& local, glm::mat4& localMatrix, glm::mat4& worldMatrix) {
+        const glm::mat3 rotation = glm::mat3_cast(local.rotation);
+        const glm::mat3 parentRotation(parent);
+
+        localMatrix[0] = glm::vec4(rotation[0], 0.0f);
+        localMatrix[1] = glm::vec4(rotation[1], 0.0f);
+        localMatrix[2] = glm::vec4(rotation[2], 0.0f);
+        localMatrix[3] = glm::vec4(local.translation, 1.0f);
+
+        const glm::mat3 world = parentRotation * rotation;
+        worldMatrix[0] = glm::vec4(world[0], 0.0f);
+        worldMatrix[1] = glm::vec4(world[1], 0.0f);
+        worldMatrix[2] = glm::vec4(world[2], 0.0f);
+        worldMatrix[3] = glm::vec4(parentRotation * local.translation + glm::vec3(parent[3]), 1.0f);
+    }
+}
+
 // Skeleton class implementation
 Skeleton::Skeleton()
-    : worldMatrix(glm::identity<glm::mat4>()) {}
+    : position(0.0f),
+    rotation(1.0f, 0.0f, 0.0f, 0.0f),
+    worldMatrix(glm::identity<glm::mat4>()) {}
 
 Skeleton::Skeleton(const std::shared_ptr<Joint>& rootJoint, const glm::vec3 pos, const glm::quat rot)
     : root(rootJoint),
@@ -87,6 +129,7 @@ const std::shared_ptr<Joint>& Skeleton::getRoot() const {
 
 void Skeleton::setPosition(const glm::vec3& pos) {
     position = pos;
+    baseDirty = true;
     worldMatrix = glm::translate(glm::mat4(1.0f), position) * glm::mat4_cast(rotation);
 }
 
@@ -96,6 +139,7 @@ const glm::vec3& Skeleton::getPosition() const {
 
 void Skeleton::setRotation(const glm::quat& rot) {
     rotation = rot;
+    baseDirty = true;
     worldMatrix = glm::translate(glm::mat4(1.0f), position) * glm::mat4_cast(rotation);
 }
 
@@ -104,15 +148,60 @@ const glm::quat& Skeleton::getRotation() const {
 }
 
 void Skeleton::update() {
-    if (root) {
-        worldMatrix = glm::translate(glm::mat4(1.0f), position) * glm::mat4_cast(rotation);
+    recomputedCount = 0;
+    if (!root) return;
+    worldMatrix = glm::translate(glm::mat4(1.0f), position) * glm::mat4_cast(rotation);
+    if (jointList.empty()) {
         root->update(worldMatrix);
+        return;
+    }
+
+    for (size_t i = 0; i < jointList.size(); ++i) {
+        Joint& joint = *jointList[i];
+        const int p = parentIndex[i];
+        const bool dirty = (p < 0 ? baseDirty : recomputed[p] != 0) ||
+            joint.pose != composedPose[i] || joint.offset != composedOffset[i];
+        recomputed[i] = dirty;
+        if (!dirty) continue;
+
+        LocalTransform& local = localTransforms[i];
+        local.rotation = glm::quat(joint.pose);
+        local.translation = joint.offset;
+        const glm::mat4& parent = p < 0 ? worldMatrix : jointList[p]->worldMatrix;
+        composeTransform(parent, local, joint.localMatrix, joint.worldMatrix);
+        composedPose[i] = joint.pose;
+        composedOffset[i] = joint.offset;
+        ++recomputedCount;
     }
+    baseDirty = false;
+}
+
+void Skeleton::invalidate() {
+    baseDirty = true;
 }
 
 void Skeleton::buildJointList() {
     jointList.clear();
     buildJointListRecursive(root);
+
+    // Parents come first in the list, so a parent's index is always known.
+    parentIndex.assign(jointList.size(), -1);
+    for (size_t i = 1; i < jointList.size(); ++i) {
+        for (size_t p = i; p-- > 0;) {
+            if (jointList[p].get() == jointList[i]->parent) {
+                parentIndex[i] = (int)p;
+                break;
+            }
+        }
+    }
+    localTransforms.assign(jointList.size(), LocalTransform{ glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(0.0f) });
+
+    // NaN never compares equal, so the first update computes every joint.
+    const float unset = std::numeric_limits<float>::quiet_NaN();
+    composedPose.assign(jointList.size(), glm::vec3(unset));
+    composedOffset.assign(jointList.size(), glm::vec3(unset));
+    recomputed.assign(jointList.size(), 1);
+    baseDirty = true;
 }
 
 void Skeleton::buildJointListRecursive(const std::shared_ptr<Joint>& joint) {
@@ -8,6 +8,14 @@
 #include <functional>
 #include <stdexcept>
 
+// A joint's transform relative to its parent, rotation then translation:
+// 7 floats instead of a 4x4 matrix.
+struct LocalTransform {
+    glm::quat rotation;
+    glm::vec3 translation;
+};
+static_assert(sizeof(LocalTransform) == 7 * sizeof(float), "LocalTransform should pack to 7 floats");
+
 class Joint {
 public:
     std::string name;
@@ -29,16 +37,27 @@ public:
     Joint(const std::string& name = "");
 
     void addChild(const std::shared_ptr<Joint>& child);
+    // Clamp pose to rotXLimit/rotYLimit/rotZLimit. Whatever writes poses
+    // (clip evaluation, blending, retargeting) clamps; Skeleton::update does not.
+    void clampPose();
     void computeLocalMatrix();
     void update(const glm::mat4& parentTransform);
 };
 
+// Euler angles (as in Joint::pose) of a rotation, picked to lie nearest a
+// reference pose. A rotation has two Euler triples and each angle is only
+// defined up to whole turns; glm::eulerAngles returns one fixed choice, which
+// jumps across +-pi and lets the joint limits clamp to the wrong side. Pass
+// the joint's current pose so consecutive frames stay continuous.
+glm::vec3 nearestEuler(const glm::quat& rotation, const glm::vec3& reference);
+
 class Skeleton {
 private:
     std::shared_ptr<Joint> root;
     glm::vec3 position;
     glm::quat rotation;
     glm::mat4 worldMatrix;
+    bool rigidJoints = false; // joints carry only rotation and translation (no scale); set by the loader
     std::vector<std::shared_ptr<Joint>> jointList; // ĳԱڴ洢Joint
 
     void traverseJointsRecursive(const std::shared_ptr<Joint>& joint, 
@@ -50,6 +69,18 @@ private:
     }
     void buildJointListRecursive(const std::shared_ptr<Joint>& joint);
 
+    // Pose pipeline, in joint list order (parents before children).
+    std::vector<LocalTransform> localTransforms;
+    std::vector<int> parentIndex;  // -1 for the root
+
+    // Dirty tracking: the pose and offset each joint's matrices were last
+    // computed from. A joint is recomputed when either changed or its
+    // parent was recomputed, so whoever writes poses needs no extra call.
+    std::vector<glm::vec3> composedPose, composedOffset;
+    std::vector<unsigned char> recomputed;
+    bool baseDirty = true;  // position or rotation changed
+    size_t recomputedCount = 0;
+
 public:
     Skeleton();
     Skeleton(const std::shared_ptr<Joint>& rootJoint, const glm::vec3 pos = glm::vec3(0.f), const glm::quat rot = glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
@@ -67,7 +98,21 @@ public:
     void setRotation(const glm::quat& rot);
     const glm::quat& getRotation() const;
 
+    // Joint world matrices from the poses and offsets. With a joint list
+    // this is one pass over flat local transforms composed as affine 3x4
+    // products, skipping joints whose pose, offset and parent are unchanged;
+    // without one it falls back to the recursive Joint::update.
     void update();
+    // Recompute every joint on the next update (after matrices were written directly, say).
+    void invalidate();
+    // Joints recomputed by the last update.
+    size_t getRecomputedCount() const { return recomputedCount; }
+
+    const std::vector<LocalTransform>& getLocalTransforms() const { return localTransforms; }
+
+    // Lets skinning use mat3(skinMatrix) for normals instead of an inverse-transpose.
+    bool hasRigidJoints() const { return rigidJoints; }
+    void setRigidJoints(bool rigid) { rigidJoints = rigid; }
 
     glm::mat4 getJointWorldMatrix(size_t index) const {
         if (index >= jointList.size()) {
@@ -9,8 +9,7 @@ bool SkeletonManager::initializeSkeleton(const std::string& fileName) {
     }
     std::cout << "Skeleton file loaded!" << std::endl;
 
-    skeleton = parser.getSkeleton();
-    skeleton.buildJointList();
+    setSkeleton(parser.getSkeleton());
     //renderer.initialize(skeleton);
 
     return true;
@@ -18,32 +17,62 @@ bool SkeletonManager::initializeSkeleton(const std::string& fileName) {
 
 bool SkeletonManager::initializeSkin(const std::string& skinFileName) {
     std::string filePath = resourcePath + skinFileName;
-    skin = std::make_unique<Skin>();
+    auto loaded = std::make_unique<Skin>();
+    SkinParser skinParser;
 
-    if (!skin->loadFromFile(filePath)) {
+    if (!skinParser.parseSkinFile(filePath, *loaded)) {
         std::cerr << "Failed to load skin file: " << filePath << std::endl;
-        skin.reset(); // Reset to nullptr if loading fails
         return false;
     }
 
     std::cout << "Skin file loaded successfully!" << std::endl;
-    skin->computeNormals();
+    loaded->computeNormals();
+    setSkin(std::move(loaded));
     return true;
 }
 
 bool SkeletonManager::initializeAnim(const std::string& animFileName) {
     std::string filePath = resourcePath + animFileName;
-    clip = std::make_unique<AnimationClip>();
-    // Allocate a new Skin object
-    if (!clip->Load(filePath.c_str())) {
+    const std::string streamingExtension = ".sclip";
+    if (animFileName.size() > streamingExtension.size() &&
+        animFileName.compare(animFileName.size() - streamingExtension.size(), streamingExtension.size(), streamingExtension) == 0) {
+        streamingClip = std::make_unique<StreamingClip>();
+        if (!streamingClip->open(filePath)) {
+            std::cerr << "Failed to open streaming animation clip" << std::endl;
+            streamingClip.reset();
+            return false;
+        }
+        std::cout << "Streaming anim clip opened, " << streamingClip->getChunkCount() << " windows" << std::endl;
+        streamTime = streamingClip->getRangeStart();
+        lastTime = glfwGetTime();
+        return true;
+    }
+
+    auto loaded = std::make_unique<AnimationClip>();
+    if (!loaded->Load(filePath.c_str())) {
         std::cerr << "Failed to load animation clip" << std::endl;
         return false;
     }
 
     std::cout << "Anim clip file loaded successfully!" << std::endl;
+    setAnimation(std::move(loaded));
+    return true;
+}
 
+void SkeletonManager::setSkeleton(const Skeleton& parsed) {
+    skeleton = parsed;
+    skeleton.buildJointList();
+}
+
+void SkeletonManager::setSkin(std::unique_ptr<Skin> parsedSkin) {
+    skin = std::move(parsedSkin);
+}
+
+void SkeletonManager::setAnimation(std::unique_ptr<AnimationClip> parsedClip) {
+    clip = std::move(parsedClip);
+    blender.initialize(skeleton);
+    blender.getLayer(0).crossfade(clip.get(), 0.0f);
     lastTime = glfwGetTime();
-    return true;
 }
 
 bool SkeletonManager::initializeRenderer() {
@@ -51,6 +80,27 @@ bool SkeletonManager::initializeRenderer() {
     return true;
 }
 
+void SkeletonManager::reloadSkeleton(const Skeleton& parsed) {
+    setSkeleton(parsed);
+    if (clip) {
+        blender.initialize(skeleton);
+        blender.getLayer(0).crossfade(clip.get(), 0.0f);
+    }
+    renderer.initialize(skeleton, skin.get());
+}
+
+void SkeletonManager::reloadSkin(std::unique_ptr<Skin> parsedSkin) {
+    // The renderer lets go of the old skin before it is freed.
+    std::unique_ptr<Skin> previous = std::move(skin);
+    setSkin(std::move(parsedSkin));
+    renderer.initialize(skeleton, skin.get());
+}
+
+void SkeletonManager::reloadAnimation(std::unique_ptr<AnimationClip> parsedClip) {
+    streamingClip.reset();
+    setAnimation(std::move(parsedClip));
+}
+
 void SkeletonManager::storeCurrentSkeleton(const std::string& skelStoreFileName, const std::string& filename ) {
     parser.writeSkeletonFile(skeleton, filename);
 }
@@ -61,25 +111,18 @@ void SkeletonManager::Update() {
     double deltaTime = currentTime - lastTime; // Compute time difference
     lastTime = currentTime;
 
-    if (clip && playAnim)
-        currentAnimTime += deltaTime;
-    if (clip &&  currentAnimTime > clip->rangeEnd) {
-        float period = clip->rangeEnd - clip->rangeStart;
-        if (period > 0.0f) {
-            // Wrap the animation time within the clip's range.
-            currentAnimTime = clip->rangeStart + std::fmod(currentAnimTime - clip->rangeStart, period);
-        }
-        else {
-            currentAnimTime = clip->rangeStart;
-        }
+    // Advance the blend tree and write the blended pose into the joints.
+    if (clip && playAnim) {
+        blender.update((float)deltaTime);
+        blender.apply(skeleton.getJointList());
+    }
+    else if (streamingClip && playAnim) {
+        streamTime += (float)deltaTime;
+        if (streamTime > streamingClip->getRangeEnd()) streamTime = streamingClip->getRangeStart();
+        streamingClip->Evaluate(streamTime, skeleton.getJointList());
     }
 
-    // Evaluate the animation clip to update the skeleton's joint poses.
-    // We use the non-const accessor getJointList() we added to Skeleton.
-    if(clip && playAnim)
-        clip->Evaluate(currentAnimTime, skeleton.getJointList());
-
-    // Update the skeleton's transformation matrices.
+    // Update the transformation matrices of the joints that changed.
     skeleton.update();
 
     // Update the renderer if needed.
@@ -87,6 +130,7 @@ void SkeletonManager::Update() {
 }
 
 void SkeletonManager::draw(const glm::mat4& viewProjMatrix, GLuint shaderProgram) {
-    skeleton.update();
+    // Matrices are current from Update(); joints edited in the UI during this
+    // frame are picked up by the next Update().
     renderer.render(viewProjMatrix, shaderProgram, camera->GetWorldPos() );
 }
@@ -7,8 +7,11 @@
 #include "SkeletonRenderer.h"
 #include <iostream>
 #include "Skin.h"
+#include "SkinParser.h"
 #include "Camera.h"
 #include "AnimationClip.h"
+#include "AnimationBlender.h"
+#include "StreamingClip.h"
 
 const std::string resourcePath = "..\\resources\\skeletons\\";
 
@@ -20,10 +23,13 @@ private:
     std::unique_ptr<Skin> skin; // Use a smart pointer
 
     std::unique_ptr<AnimationClip> clip;
+    AnimationBlender blender;  // layer 0 plays 'clip'
 
-    Camera* camera;
+    // Long takes (.sclip) are streamed from disk instead of loaded.
+    std::unique_ptr<StreamingClip> streamingClip;
+    float streamTime = 0.0f;
 
-    float currentAnimTime;
+    Camera* camera;
 
     double lastTime;
  
@@ -34,8 +40,21 @@ public:
     bool initializeSkeleton(const std::string& skeletonFileName);
     bool initializeSkin(const std::string& skinFileName);
     bool initializeAnim(const std::string& animFileName);
+
+    // Take assets already parsed (by an AssetLoader, say); the initialize
+    // functions above parse on the calling thread and use these.
+    void setSkeleton(const Skeleton& parsed);
+    void setSkin(std::unique_ptr<Skin> parsedSkin);
+    void setAnimation(std::unique_ptr<AnimationClip> parsedClip);
     bool initializeRenderer();
 
+    // Hot reload: swap a re-parsed asset in between frames and rebuild what
+    // depends on it (renderer buffers, the blend layers). A reloaded skeleton
+    // takes its pose from the file.
+    void reloadSkeleton(const Skeleton& parsed);
+    void reloadSkin(std::unique_ptr<Skin> parsedSkin);
+    void reloadAnimation(std::unique_ptr<AnimationClip> parsedClip);
+
     void storeCurrentSkeleton(const std::string& skelStoreFileName, const std::string& filename);
 
     void Update();
@@ -59,6 +78,10 @@ public:
     }
 
     bool haveclip() {
-        return clip ? true : false;
+        return clip || streamingClip;
+    }
+
+    AnimationBlender* getBlender() {
+        return &blender;
     }
 };
@@ -109,6 +109,10 @@ bool SkeletonParser::parseSkeletonFile(const std::string& filename) {
         return false;
     }
 
+    // .skel joints are an offset and Euler angles, never a scale, so skinning
+    // can take the rigid normal path.
+    skeleton.setRigidJoints(true);
+
     tokenizer.Close();
     return true;
 }
@@ -1,6 +1,9 @@
 #include "SkeletonRenderer.h"
+#include "Shader.h"
 #include <iostream>
 #include <glm/gtc/type_ptr.hpp>
+#include <chrono>
+#include <cstring>
 
 SkeletonRenderer::SkeletonRenderer()
     : VAO(0), VBO(0), EBO(0), VBO_normals(0), skeleton(nullptr), 
@@ -19,6 +22,19 @@ void checkOpenGLError(const std::string& context) {
 }
 
 
+// Rotation + translation only: orthonormal upper 3x3 with positive determinant.
+static bool isRigidTransform(const glm::mat4& m, float tolerance = 1e-3f) {
+    glm::mat3 r(m);
+    glm::mat3 shouldBeIdentity = glm::transpose(r) * r;
+    for (int c = 0; c < 3; ++c) {
+        for (int row = 0; row < 3; ++row) {
+            float expected = (c == row) ? 1.0f : 0.0f;
+            if (std::abs(shouldBeIdentity[c][row] - expected) > tolerance) return false;
+        }
+    }
+    return glm::determinant(r) > 0.0f;
+}
+
 void SkeletonRenderer::cleanup() {
     if (VAO) {
         glDeleteVertexArrays(1, &VAO);
@@ -36,6 +52,20 @@ void SkeletonRenderer::cleanup() {
         glDeleteBuffers(1, &EBO);
         EBO = 0;
     }
+    if (boneVAO) {
+        glDeleteVertexArrays(1, &boneVAO);
+        boneVAO = 0;
+    }
+    GLuint boneBuffers[4] = { boneVBO, boneNormalVBO, boneEBO, instanceVBO };
+    for (GLuint buffer : boneBuffers) {
+        if (buffer) glDeleteBuffers(1, &buffer);
+    }
+    boneVBO = boneNormalVBO = boneEBO = instanceVBO = 0;
+    if (paletteOffset >= 0) {
+        JointPalette::getInstance().release(paletteOffset, paletteTexels);
+        paletteOffset = -1;
+        paletteTexels = 0;
+    }
 }
 void SkeletonRenderer::initialize(Skeleton& skel) {
     cleanup();
@@ -44,6 +74,7 @@ void SkeletonRenderer::initialize(Skeleton& skel) {
     renderMode = SkeletonRenderMode::Wireframe;
 
     setupCubeBuffers(); 
+    setupInstancedBoneBuffers();
 
 }
 
@@ -59,6 +90,26 @@ void SkeletonRenderer::initialize(Skeleton& skel, Skin* skin) {
 
     if (render_skin && skin) { 
         this->skin = skin;  
+
+        // Binding matrices never change, so invert them once instead of per frame.
+        inverseBindMats.resize(skin->bindingMats.size());
+        for (size_t i = 0; i < skin->bindingMats.size(); ++i) {
+            inverseBindMats[i] = glm::inverse(skin->bindingMats[i]);
+        }
+
+        maxInfluences = 1;
+        for (const auto& vertex : skin->vertices) {
+            maxInfluences = std::max(maxInfluences, std::min(4, (int)vertex.weights.size()));
+        }
+
+        rigidSkinning = skeleton->hasRigidJoints();
+        for (const auto& inverseBind : inverseBindMats) {
+            if (!isRigidTransform(inverseBind)) {
+                rigidSkinning = false;
+                break;
+            }
+        }
+
         if (!renderInGPU)
             setupSkinBuffersCPU();
         else
@@ -67,6 +118,7 @@ void SkeletonRenderer::initialize(Skeleton& skel, Skin* skin) {
     else {
         this->skin = nullptr; 
         setupCubeBuffers(); 
+        setupInstancedBoneBuffers();
     }
 }
 
@@ -133,6 +185,57 @@ void SkeletonRenderer::setupCubeBuffers() {
     glBindVertexArray(0);
 }
 
+void SkeletonRenderer::setupInstancedBoneBuffers() {
+    if (!skeleton) return;
+
+    // Unit cube in [0,1]^3; the shader stretches it to each joint's box.
+    auto cubeVertices = CubeHelper::generateCubeVertices(glm::vec3(0.0f), glm::vec3(1.0f));
+    auto cubeNormals = CubeHelper::generateCubeNormals();
+    auto cubeIndices = CubeHelper::generateCubeIndices(0);
+
+    glGenVertexArrays(1, &boneVAO);
+    glBindVertexArray(boneVAO);
+
+    glGenBuffers(1, &boneVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, boneVBO);
+    glBufferData(GL_ARRAY_BUFFER, cubeVertices.size() * sizeof(GLfloat), cubeVertices.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (void*)0);
+    glEnableVertexAttribArray(0);
+
+    glGenBuffers(1, &boneNormalVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, boneNormalVBO);
+    glBufferData(GL_ARRAY_BUFFER, cubeNormals.size() * sizeof(GLfloat), cubeNormals.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (void*)0);
+    glEnableVertexAttribArray(1);
+
+    // Instance buffer: boxMin (4), boxMax (5), world matrix columns (6-9).
+    glGenBuffers(1, &instanceVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, skeleton->getJointData().size() * sizeof(BoneInstance), nullptr, GL_STREAM_DRAW);
+
+    glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(BoneInstance), (void*)offsetof(BoneInstance, boxMin));
+    glEnableVertexAttribArray(4);
+    glVertexAttribDivisor(4, 1);
+    glVertexAttribPointer(5, 3, GL_FLOAT, GL_FALSE, sizeof(BoneInstance), (void*)offsetof(BoneInstance, boxMax));
+    glEnableVertexAttribArray(5);
+    glVertexAttribDivisor(5, 1);
+    for (int column = 0; column < 4; ++column) {
+        GLuint location = 6 + column;
+        glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(BoneInstance),
+            (void*)(offsetof(BoneInstance, world) + column * sizeof(glm::vec4)));
+        glEnableVertexAttribArray(location);
+        glVertexAttribDivisor(location, 1);
+    }
+    checkOpenGLError("Bone instance attributes");
+
+    glGenBuffers(1, &boneEBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, boneEBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, cubeIndices.size() * sizeof(GLuint), cubeIndices.data(), GL_STATIC_DRAW);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
 void SkeletonRenderer::setupSkinBuffersCPU() {
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
@@ -194,8 +297,8 @@ void SkeletonRenderer::setupSkinBuffersGPU() {
         (void*)offsetof(GPUSkinVertex, normal));
     glEnableVertexAttribArray(1);
 
-    // Joint indices (location 2) - ʹ
-    glVertexAttribIPointer(2, 4, GL_UNSIGNED_BYTE,
+    // Joint indices (location 2) - 16-bit integer attribute
+    glVertexAttribIPointer(2, 4, GL_UNSIGNED_SHORT,
         sizeof(GPUSkinVertex),
         (void*)offsetof(GPUSkinVertex, jointIndices));
     glEnableVertexAttribArray(2);
@@ -213,6 +316,12 @@ void SkeletonRenderer::setupSkinBuffersGPU() {
         GL_STATIC_DRAW);
 
     glBindVertexArray(0);
+
+    // Reserve this mesh's range in the shared palette, sized to the live joint count.
+    // The range fits a matrix palette so the skinning method can change at runtime.
+    paletteTexels = skeleton->getJointData().size() * JointPalette::TEXELS_PER_MATRIX;
+    paletteOffset = JointPalette::getInstance().allocate(paletteTexels);
+    paletteScratch.assign(paletteTexels * 4, 0.0f);
 }
 
 
@@ -224,64 +333,72 @@ void SkeletonRenderer::renderSkinCPU(const glm::mat4& viewProjMatrix, GLuint sha
     GLuint camPos = glGetUniformLocation(shaderProgram, "CameraPos");
 
     glm::mat4 modelMatrix = glm::mat4(1.0f);  // Modify if needed
+    glm::mat3 normalMatrix = computeNormalMatrix(modelMatrix);
     glUniformMatrix4fv(modelLoc, 1, GL_FALSE, &modelMatrix[0][0]);
+    glUniformMatrix3fv(glGetUniformLocation(shaderProgram, "normalMatrix"), 1, GL_FALSE, &normalMatrix[0][0]);
     glUniformMatrix4fv(vpLoc, 1, GL_FALSE, &viewProjMatrix[0][0]);
     glUniform3fv(camPos, 1, &cameraPos[0]);
 
     glBindVertexArray(VAO);
     glDrawElements(GL_TRIANGLES, skin->triangles.size()*3, GL_UNSIGNED_INT, 0);
+    FrameStats::getInstance().drawCalls++;
     glBindVertexArray(0);
 }
 
 void SkeletonRenderer::renderSkinGPU(const glm::mat4& viewProjMatrix,
     GLuint shaderProgram,
     const glm::vec3 cameraPos) {
+    if (paletteOffset < 0) {
+        std::cerr << "ERROR: no joint palette range allocated for this skin!" << std::endl;
+        return;
+    }
+
     glUseProgram(shaderProgram);
 
     GLuint vpLoc = glGetUniformLocation(shaderProgram, "viewProj");
     GLuint modelLoc = glGetUniformLocation(shaderProgram, "model");
-    GLuint jointsLoc = glGetUniformLocation(shaderProgram, "jointMatrices");
+    GLuint offsetLoc = glGetUniformLocation(shaderProgram, "paletteOffset");
+    GLuint countLoc = glGetUniformLocation(shaderProgram, "jointCount");
     GLuint camPos = glGetUniformLocation(shaderProgram, "CameraPos");
 
-    if (jointsLoc == -1) {
-        std::cerr << "ERROR: jointMatrices uniform not found!" << std::endl;
-        return;
-    }
-
     glm::mat4 modelMatrix(1.0f);
+    glm::mat3 normalMatrix = computeNormalMatrix(modelMatrix);
     glUniformMatrix4fv(modelLoc, 1, GL_FALSE, &modelMatrix[0][0]);
+    glUniformMatrix3fv(glGetUniformLocation(shaderProgram, "normalMatrix"), 1, GL_FALSE, &normalMatrix[0][0]);
     glUniformMatrix4fv(vpLoc, 1, GL_FALSE, &viewProjMatrix[0][0]);
     glUniform3fv(camPos, 1, &cameraPos[0]);
 
-    const auto& joints = skeleton->getJointData();
-    const auto& bindingMats = skin->bindingMats;
-    const int MAX_JOINTS = 150; 
-
-    std::vector<glm::mat4> jointMatrices(MAX_JOINTS, glm::mat4(1.0f));
-
-    for (int i = 0; i < std::min((int)joints.size(), MAX_JOINTS); ++i) {
-        if (i >= bindingMats.size()) {
-            std::cerr << "WARNING: Binding matrix missing for joint " << i
-                << ", using identity" << std::endl;
-            jointMatrices[i] = glm::mat4(1.0f);
-            continue;
+    // Only the live joints are uploaded, straight into this mesh's palette range.
+    // Matrices take 4 texels per joint, dual quaternions take 2.
+    const bool useDQ = skinningMethod == SkinningMethod::DualQuaternion;
+    computeSkinPalette(skinningMethod);
+
+    const size_t jointCount = skinMatrices.size();
+    size_t texelCount = 0;
+    if (useDQ) {
+        for (size_t i = 0; i < jointCount; ++i) {
+            std::memcpy(&paletteScratch[i * 8], &skinDualQuats[i].real[0], 4 * sizeof(float));
+            std::memcpy(&paletteScratch[i * 8 + 4], &skinDualQuats[i].dual[0], 4 * sizeof(float));
         }
-
-        glm::mat4 inverseBind = glm::inverse(bindingMats[i]); 
-        glm::mat4 worldMat = skeleton->getJointWorldMatrix(i);
-        jointMatrices[i] = worldMat * inverseBind;
+        texelCount = jointCount * 2;
+    }
+    else {
+        std::memcpy(paletteScratch.data(), glm::value_ptr(skinMatrices[0]), jointCount * 16 * sizeof(float));
+        texelCount = jointCount * JointPalette::TEXELS_PER_MATRIX;
     }
 
-    glUniformMatrix4fv(jointsLoc,
-        MAX_JOINTS, 
-        GL_FALSE,
-        glm::value_ptr(jointMatrices[0]));
+    JointPalette& palette = JointPalette::getInstance();
+    palette.upload(paletteOffset, paletteScratch.data(), texelCount);
+    palette.bind(shaderProgram, "jointPalette");
+    glUniform1i(offsetLoc, paletteOffset);
+    glUniform1i(countLoc, static_cast<GLint>(jointCount));
 
     glBindVertexArray(VAO);
     glDrawElements(GL_TRIANGLES,
         skin->triangles.size() * 3,
         GL_UNSIGNED_INT,
         0);
+    FrameStats::getInstance().drawCalls++;
     glBindVertexArray(0);
 }
 
@@ -291,16 +408,34 @@ void SkeletonRenderer::render(const glm::mat4& viewProjMatrix, GLuint shaderProg
 
     const auto& joints = skeleton->getJointData();
 
+    const bool drawSkin = render_skin && skin;
+    const bool drawInstanced = !drawSkin && instancedBones && boneVAO;
+
+    // GPU skinning and instanced bones use their own compiled permutations.
+    if (drawInstanced) {
+        ShaderPermutation permutation;
+        permutation.instancedBones = true;
+        GLuint instancedProgram = ShaderLibrary::getInstance().getProgram(permutation);
+        if (!instancedProgram) return;
+        shaderProgram = instancedProgram;
+    }
+    else if (drawSkin && renderInGPU) {
+        ShaderPermutation permutation;
+        permutation.skinning = true;
+        permutation.dualQuaternion = skinningMethod == SkinningMethod::DualQuaternion;
+        permutation.rigidSkinning = rigidSkinning;
+        permutation.maxInfluences = maxInfluences;
+        GLuint skinnedProgram = ShaderLibrary::getInstance().getProgram(permutation);
+        if (!skinnedProgram) return;
+        shaderProgram = skinnedProgram;
+    }
+
     // set uniforms for materials and lights
     material.SetUniforms(shaderProgram, "material");
     directLight.SetUniforms(shaderProgram, "dirLight");
-    pointLight.SetUniforms(shaderProgram, "pointLight");
-
-    // set the bool
-    GLuint skinModeLoc = glGetUniformLocation(shaderProgram, "useGPUSkinning");
-    glUniform1i(skinModeLoc, renderInGPU ? 1 : 0); 
+    pointLight.SetUniforms(shaderProgram, "pointLights[0]");
 
-    if (render_skin) {
+    if (drawSkin) {
         if(!renderInGPU)
             renderSkinCPU(viewProjMatrix, shaderProgram, cameraPos);
         else
@@ -311,6 +446,7 @@ void SkeletonRenderer::render(const glm::mat4& viewProjMatrix, GLuint shaderProg
 
         GLuint vpLoc = glGetUniformLocation(shaderProgram, "viewProj");
         GLuint modelLoc = glGetUniformLocation(shaderProgram, "model");
+        GLuint normalLoc = glGetUniformLocation(shaderProgram, "normalMatrix");
         GLuint camPos = glGetUniformLocation(shaderProgram, "CameraPos");
         glUniformMatrix4fv(vpLoc, 1, GL_FALSE, &viewProjMatrix[0][0]);
         glUniform3fv(camPos, 1, &cameraPos[0]);
@@ -325,13 +461,41 @@ void SkeletonRenderer::render(const glm::mat4& viewProjMatrix, GLuint shaderProg
             break;
         }
 
+        if (drawInstanced) {
+            // One draw for every bone: per-joint data comes from the instance buffer.
+            packBoneInstances(joints, boneInstances);
+
+            glm::mat4 identity(1.0f);
+            glm::mat3 normalIdentity(1.0f);
+            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(identity));
+            glUniformMatrix3fv(normalLoc, 1, GL_FALSE, glm::value_ptr(normalIdentity));
+
+            glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+            glBufferData(GL_ARRAY_BUFFER, boneInstances.size() * sizeof(BoneInstance), boneInstances.data(), GL_STREAM_DRAW);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+            glBindVertexArray(boneVAO);
+            glDrawElementsInstanced(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0, static_cast<GLsizei>(boneInstances.size()));
+            FrameStats::getInstance().drawCalls++;
+            FrameStats::getInstance().instancesDrawn += static_cast<int>(boneInstances.size());
+            glBindVertexArray(0);
+            glUseProgram(0);
+            glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+            return;
+        }
+
         glBindVertexArray(VAO);
 
         for (size_t i = 0; i < joints.size(); ++i) {
+            // Joint world matrices are rigid, so the rotation part is the normal matrix.
+            glm::mat3 normalMatrix = skeleton->hasRigidJoints() ?
+                glm::mat3(joints[i]->worldMatrix) : computeNormalMatrix(joints[i]->worldMatrix);
             glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(joints[i]->worldMatrix));
+            glUniformMatrix3fv(normalLoc, 1, GL_FALSE, glm::value_ptr(normalMatrix));
 
             glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT,
                 (void*)(i * 36 * sizeof(GLuint)));
+            FrameStats::getInstance().drawCalls++;
         }
 
         glBindVertexArray(0);
@@ -346,16 +510,44 @@ void SkeletonRenderer::render(const glm::mat4& viewProjMatrix, GLuint shaderProg
 void SkeletonRenderer::Update() {
     if(!renderInGPU)
         updateSkinVerticesCPU();
+    else if (cpuSkinRequests > 0 && render_skin && skin)
+        skinVerticesCPU(skinningMethod);
 }
 
-void SkeletonRenderer::updateSkinVerticesCPU() {
+void SkeletonRenderer::computeSkinPalette(SkinningMethod method) {
+    const size_t jointCount = skeleton->getJointData().size();
+    skinMatrices.resize(jointCount);
+    for (size_t i = 0; i < jointCount; ++i) {
+        if (i >= inverseBindMats.size()) {
+            skinMatrices[i] = glm::mat4(1.0f);
+            continue;
+        }
+        skinMatrices[i] = skeleton->getJointWorldMatrix(i) * inverseBindMats[i];
+    }
+
+    // Inverse-transpose palette, only needed when the rigid assumption does not hold.
+    if (method == SkinningMethod::Linear && !rigidSkinning) {
+        skinNormalMatrices.resize(jointCount);
+        for (size_t i = 0; i < jointCount; ++i) {
+            skinNormalMatrices[i] = glm::transpose(glm::inverse(glm::mat3(skinMatrices[i])));
+        }
+    }
 
-    if (!render_skin) return;
+    if (method == SkinningMethod::DualQuaternion) {
+        skinDualQuats.resize(jointCount);
+        for (size_t i = 0; i < jointCount; ++i) {
+            skinDualQuats[i] = DualQuat::fromMatrix(skinMatrices[i]);
+        }
+    }
+}
 
-    const auto& jointData = skeleton->getJointData();
-    const auto& bindingMats = skin->bindingMats;
+void SkeletonRenderer::skinVerticesCPU(SkinningMethod method) {
+    computeSkinPalette(method);
 
-    std::vector<SkinVertex> deformedVertices = skin->vertices;
+    const size_t jointCount = skinMatrices.size();
+    if (deformedVertices.size() != skin->vertices.size()) {
+        deformedVertices = skin->vertices;
+    }
 
     for (size_t i = 0; i < skin->vertices.size(); ++i) {
         glm::vec3 skinnedPos(0.0f);
@@ -363,28 +555,78 @@ void SkeletonRenderer::updateSkinVerticesCPU() {
 
         const auto& originalVertex = skin->vertices[i];
         for (const auto& weight : originalVertex.weights) {
-            if (weight.jointIndex >= jointData.size()) {
+            if (weight.jointIndex >= jointCount) {
                 std::cerr << "Invalid joint index: " << weight.jointIndex << std::endl;
                 exit(-3);
             }
+        }
 
-            glm::mat4 jointWorldMatrix = skeleton->getJointWorldMatrix(weight.jointIndex);
-            glm::mat4 bindingMatrix = bindingMats[weight.jointIndex];
-            glm::mat4 skinMatrix = jointWorldMatrix * glm::inverse(bindingMatrix);
+        if (method == SkinningMethod::DualQuaternion) {
+            if (originalVertex.weights.empty()) continue;
 
-            glm::vec4 transformedPos = skinMatrix * glm::vec4(originalVertex.position, 1.0f);
-            skinnedPos += glm::vec3(transformedPos) * weight.weight;
+            // Blend in the hemisphere of the first influence to avoid flips.
+            DualQuat blended(glm::quat(0.0f, 0.0f, 0.0f, 0.0f), glm::quat(0.0f, 0.0f, 0.0f, 0.0f));
+            const glm::quat& pivot = skinDualQuats[originalVertex.weights[0].jointIndex].real;
+            for (const auto& weight : originalVertex.weights) {
+                blended.blend(skinDualQuats[weight.jointIndex], weight.weight, pivot);
+            }
+            blended.normalize();
 
-            glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(skinMatrix)));
-            glm::vec3 transformedNormal = normalMatrix * originalVertex.normal;
-            skinnedNormal += transformedNormal * weight.weight;
+            skinnedPos = blended.transformPoint(originalVertex.position);
+            skinnedNormal = blended.transformVector(originalVertex.normal);
+        }
+        else {
+            for (const auto& weight : originalVertex.weights) {
+                const glm::mat4& skinMatrix = skinMatrices[weight.jointIndex];
+
+                glm::vec4 transformedPos = skinMatrix * glm::vec4(originalVertex.position, 1.0f);
+                skinnedPos += glm::vec3(transformedPos) * weight.weight;
+
+                glm::vec3 transformedNormal = rigidSkinning ?
+                    glm::mat3(skinMatrix) * originalVertex.normal :
+                    skinNormalMatrices[weight.jointIndex] * originalVertex.normal;
+                skinnedNormal += transformedNormal * weight.weight;
+            }
         }
 
         deformedVertices[i].position = skinnedPos;
         deformedVertices[i].normal = glm::normalize(skinnedNormal);
     }
+    ++skinVersion;
+}
+
+void SkeletonRenderer::updateSkinVerticesCPU() {
+
+    if (!render_skin || !skin) return;
+
+    skinVerticesCPU(skinningMethod);
 
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferSubData(GL_ARRAY_BUFFER, 0, deformedVertices.size() * sizeof(SkinVertex), deformedVertices.data());
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
+
+void SkeletonRenderer::runSkinningBenchmark(int iterations) {
+    if (!skeleton || !skin || skin->vertices.empty() || iterations <= 0) return;
+
+    const SkinningMethod methods[2] = { SkinningMethod::Linear, SkinningMethod::DualQuaternion };
+    const size_t jointCount = skeleton->getJointData().size();
+
+    for (SkinningMethod method : methods) {
+        SkinningBenchmark& result = skinningBenchmarks[static_cast<int>(method)];
+        result.floatsPerJoint = (method == SkinningMethod::Linear) ? 16 : 8;
+        result.paletteBytes = jointCount * result.floatsPerJoint * sizeof(float);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            skinVerticesCPU(method);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+
+        double ns = std::chrono::duration<double, std::nano>(end - start).count();
+        result.nsPerVertex = ns / (double(iterations) * skin->vertices.size());
+    }
+
+    // Leave the deformed vertices matching the active method.
+    skinVerticesCPU(skinningMethod);
+}
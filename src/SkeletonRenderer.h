@@ -10,12 +10,29 @@
 #include "Skin.h"
 #include "Material.h"
 #include "Lights.h"
+#include "JointPalette.h"
+#include "DualQuat.h"
+#include "FrameStats.h"
+#include "BoneInstance.h"
 
 enum class SkeletonRenderMode {
     Fill,
     Wireframe
 };
 
+enum class SkinningMethod {
+    Linear,         // linear blend of 4x4 matrices (16 floats per joint)
+    DualQuaternion  // blend of unit dual quaternions (8 floats per joint)
+};
+
+// Cost of one skinning method, measured on the CPU reference path which runs
+// the same per-vertex math as the shader.
+struct SkinningBenchmark {
+    int floatsPerJoint = 0;
+    size_t paletteBytes = 0;  // uploaded per frame for the current skeleton
+    double nsPerVertex = 0.0;
+};
+
 class SkeletonRenderer {
 private:
     GLuint VAO, VBO, EBO, VBO_normals;
@@ -28,7 +45,35 @@ private:
     SkeletonRenderMode renderMode = SkeletonRenderMode::Fill;
     bool render_skin = true;
     Skin* skin;
+
+    // Skinning palette range reserved in the shared JointPalette (in texels).
+    int paletteOffset = -1;
+    size_t paletteTexels = 0;
+    std::vector<glm::mat4> inverseBindMats;
+    std::vector<float> paletteScratch;
+
+    // True when every skin matrix is rotation + translation, so normals can be
+    // transformed by mat3(skinMatrix) without an inverse-transpose.
+    bool rigidSkinning = true;
+    int maxInfluences = 4;  // most joints any vertex reads, selects MAX_INFLUENCES
+
+    // Per-frame scratch for the CPU reference path.
+    std::vector<glm::mat4> skinMatrices;
+    std::vector<glm::mat3> skinNormalMatrices;
+    std::vector<DualQuat> skinDualQuats;
+    std::vector<SkinVertex> deformedVertices;
+    unsigned skinVersion = 0;     // bumped whenever deformedVertices is rewritten
+    int cpuSkinRequests = 0;      // consumers that need deformedVertices in GPU mode
+
+    void computeSkinPalette(SkinningMethod method);
+    void skinVerticesCPU(SkinningMethod method);
+
+    // Instanced bone boxes: one unit cube plus a per-joint instance buffer.
+    GLuint boneVAO = 0, boneVBO = 0, boneNormalVBO = 0, boneEBO = 0, instanceVBO = 0;
+    std::vector<BoneInstance> boneInstances;
+
     void setupCubeBuffers();
+    void setupInstancedBoneBuffers();
     void setupSkinBuffersCPU();
     void setupSkinBuffersGPU();
     Material material;
@@ -62,11 +107,31 @@ public:
 
     void updateSkinVerticesCPU();
 
+    // CPU-skinned pose for consumers such as cloth collision. Empty until the
+    // first CPU skinning pass; with GPU skinning it is only kept up to date
+    // while at least one consumer has called requestCPUSkin(true).
+    const Skin* getSkin() const { return skin; }
+    const std::vector<SkinVertex>& getDeformedVertices() const { return deformedVertices; }
+    unsigned getSkinVersion() const { return skinVersion; }
+    void requestCPUSkin(bool request) { cpuSkinRequests += request ? 1 : -1; }
+
     Material* getMaterial() { return &material; }
     DirectionalLight* getDirectLight() { return &directLight; }
     PointLight* getPointLight() { return &pointLight; }
 
+    // Time both skinning methods on the CPU reference path.
+    void runSkinningBenchmark(int iterations = 20);
+    const SkinningBenchmark& getSkinningBenchmark(SkinningMethod method) const {
+        return skinningBenchmarks[static_cast<int>(method)];
+    }
+
     glm::vec3 renderColor = glm::vec3(1.f);
     bool renderInGPU = false;
+    bool instancedBones = true;  // one instanced draw for all bone boxes
+    SkinningMethod skinningMethod = SkinningMethod::Linear;
+    bool isRigidSkinning() const { return rigidSkinning; }
+
+private:
+    SkinningBenchmark skinningBenchmarks[2];
 
 };
\ No newline at end of file
@@ -0,0 +1,94 @@
+// SkinMeshCollider.cpp
+#include "SkinMeshCollider.h"
+#include "SkeletonRenderer.h"
+#include "JobSystem.h"
+#include <atomic>
+#include <cfloat>
+
+SkinMeshCollider::SkinMeshCollider(SkeletonRenderer* renderer)
+    : renderer(renderer) {
+    // Keep the CPU pose up to date even when the renderer skins on the GPU.
+    if (renderer) renderer->requestCPUSkin(true);
+}
+
+SkinMeshCollider::~SkinMeshCollider() {
+    if (renderer) renderer->requestCPUSkin(false);
+}
+
+void SkinMeshCollider::update() {
+    const Skin* skin = renderer ? renderer->getSkin() : nullptr;
+    if (!skin) return;
+
+    const std::vector<SkinVertex>& deformed = renderer->getDeformedVertices();
+    const std::vector<SkinVertex>& source = deformed.size() == skin->vertices.size() ? deformed : skin->vertices;
+
+    if (skin != lastSkin || triangles.size() != skin->triangles.size() || positions.size() != source.size()) {
+        lastSkin = skin;
+        triangles.resize(skin->triangles.size());
+        for (size_t i = 0; i < skin->triangles.size(); ++i) {
+            const Triangle& t = skin->triangles[i];
+            triangles[i] = glm::ivec3(t.v0, t.v1, t.v2);
+        }
+        positions.resize(source.size());
+        for (size_t i = 0; i < source.size(); ++i) positions[i] = source[i].position;
+        bvh.build(positions, triangles);
+        lastSkinVersion = renderer->getSkinVersion();
+        return;
+    }
+
+    if (renderer->getSkinVersion() == lastSkinVersion) return;
+    lastSkinVersion = renderer->getSkinVersion();
+
+    for (size_t i = 0; i < source.size(); ++i) positions[i] = source[i].position;
+    bvh.refit(positions);
+}
+
+int SkinMeshCollider::collide(std::vector<Particle>& particles, float thickness, ColliderScratch&) const {
+    if (bvh.empty()) return 0;
+
+    std::atomic<int> contacts(0);
+    JobSystem::getInstance().parallelFor(particles.size(), 256, [&](size_t begin, size_t end) {
+        int localContacts = 0;
+        for (size_t i = begin; i < end; ++i) {
+            Particle& p = particles[i];
+            if (p.fixed) continue;
+
+            // Closest triangle within the thickness.
+            float bestDist2 = thickness * thickness;
+            int bestTriangle = -1;
+            glm::vec3 bestPoint(0.0f);
+            bvh.query(p.position - glm::vec3(thickness), p.position + glm::vec3(thickness), [&](int t) {
+                const glm::ivec3& tri = triangles[t];
+                const glm::vec3& a = positions[tri.x];
+                const glm::vec3& b = positions[tri.y];
+                const glm::vec3& c = positions[tri.z];
+                glm::vec3 bary = closestPointBarycentric(p.position, a, b, c);
+                glm::vec3 q = bary.x * a + bary.y * b + bary.z * c;
+                glm::vec3 d = p.position - q;
+                float dist2 = glm::dot(d, d);
+                if (dist2 < bestDist2) {
+                    bestDist2 = dist2;
+                    bestTriangle = t;
+                    bestPoint = q;
+                }
+            });
+            if (bestTriangle < 0) continue;
+
+            const glm::ivec3& tri = triangles[bestTriangle];
+            glm::vec3 n = glm::cross(positions[tri.y] - positions[tri.x], positions[tri.z] - positions[tri.x]);
+            float nLen = glm::length(n);
+            if (nLen < 1e-12f) continue;
+            n /= nLen;
+
+            float dist = glm::dot(p.position - bestPoint, n);
+            if (dist >= thickness) continue;
+
+            p.position += n * (thickness - dist);
+            float vn = glm::dot(p.velocity, n);
+            if (vn < 0.0f) p.velocity -= n * vn;
+            ++localContacts;
+        }
+        contacts += localContacts;
+    });
+    return contacts.load();
+}
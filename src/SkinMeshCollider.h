@@ -0,0 +1,33 @@
+// SkinMeshCollider.h
+#pragma once
+
+#include "ClothCollider.h"
+#include "BVH.h"
+
+class SkeletonRenderer;
+class Skin;
+
+// Collides cloth against the CPU-skinned mesh of a SkeletonRenderer. The BVH
+// is built from the bind pose on first use and refitted whenever the renderer
+// produces a new deformed pose. Particles are pushed to the front side of the
+// closest triangle within the thickness, so the mesh should be closed and
+// wound counter-clockwise seen from outside.
+class SkinMeshCollider : public ClothCollider {
+private:
+    SkeletonRenderer* renderer;
+    DynamicBVH bvh;
+    std::vector<glm::vec3> positions;
+    std::vector<glm::ivec3> triangles;
+    unsigned lastSkinVersion = 0;
+    const Skin* lastSkin = nullptr;  // rebuilt when the renderer's skin is swapped
+
+public:
+    explicit SkinMeshCollider(SkeletonRenderer* renderer);
+    ~SkinMeshCollider() override;
+
+    const char* getName() const override { return "Skinned Mesh"; }
+    void update() override;
+    int collide(std::vector<Particle>& particles, float thickness, ColliderScratch& scratch) const override;
+
+    const DynamicBVH& getBVH() const { return bvh; }
+};
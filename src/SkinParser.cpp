@@ -0,0 +1,317 @@
+// SkinParser.cpp
+#include "SkinParser.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace {
+    // Target chunk size; smaller sections are parsed as one chunk.
+    const size_t CHUNK_BYTES = 256 * 1024;
+
+    inline bool isSpace(char c) {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    // Whitespace-separated tokens and numbers from [p, end), read as the
+    // Tokenizer reads them. Floats go through double like its atof, so the
+    // values are bit for bit the same.
+    struct Cursor {
+        const char* p;
+        const char* end;
+
+        bool atEnd() {
+            while (p < end && isSpace(*p)) ++p;
+            return p == end;
+        }
+
+        std::string_view token() {
+            if (atEnd()) return {};
+            const char* begin = p;
+            while (p < end && !isSpace(*p)) ++p;
+            return std::string_view(begin, p - begin);
+        }
+
+        bool getInt(int& value) {
+            if (atEnd()) return false;
+            auto result = std::from_chars(p, end, value);
+            if (result.ec != std::errc()) return false;
+            p = result.ptr;
+            return true;
+        }
+
+        bool getFloat(float& value) {
+            if (atEnd()) return false;
+            double parsed;
+            auto result = std::from_chars(p, end, parsed);
+            if (result.ec != std::errc()) return false;
+            value = float(parsed);
+            p = result.ptr;
+            return true;
+        }
+
+        void skipLine() {
+            const void* newline = memchr(p, '\n', end - p);
+            p = newline ? (const char*)newline + 1 : end;
+        }
+    };
+
+    // Chunk boundaries over [begin, end), each one just past a newline.
+    std::vector<const char*> splitLines(const char* begin, const char* end) {
+        const size_t size = end - begin;
+        const size_t count = std::max<size_t>(1, size / CHUNK_BYTES);
+        std::vector<const char*> bounds{ begin };
+        for (size_t i = 1; i < count; ++i) {
+            const char* p = std::max(begin + size * i / count, bounds.back());
+            const void* newline = memchr(p, '\n', end - p);
+            bounds.push_back(newline ? (const char*)newline + 1 : end);
+        }
+        bounds.push_back(end);
+        return bounds;
+    }
+
+    size_t countTokens(const char* p, const char* end) {
+        size_t count = 0;
+        bool inToken = false;
+        for (; p < end; ++p) {
+            const bool space = isSpace(*p);
+            count += (!space && !inToken);
+            inToken = !space;
+        }
+        return count;
+    }
+
+    // 'count' items of three numbers each. Counting the numbers of every chunk
+    // first gives each chunk the index of its first number, so chunks need not
+    // start on an item; store(item, component, value) writes one number.
+    template <typename T, typename Store>
+    bool parseTriples(const char* begin, const char* end, size_t count, size_t& chunks, const Store& store) {
+        const std::vector<const char*> bounds = splitLines(begin, end);
+        const size_t chunkCount = bounds.size() - 1;
+        std::vector<size_t> first(chunkCount + 1, 0);
+        JobSystem& jobs = JobSystem::getInstance();
+        jobs.parallelFor(chunkCount, 1, [&](size_t b, size_t e) {
+            for (size_t c = b; c < e; ++c) first[c + 1] = countTokens(bounds[c], bounds[c + 1]);
+        });
+        for (size_t c = 0; c < chunkCount; ++c) first[c + 1] += first[c];
+        if (first[chunkCount] != count * 3) return false;
+
+        std::atomic<bool> ok{ true };
+        jobs.parallelFor(chunkCount, 1, [&](size_t b, size_t e) {
+            for (size_t c = b; c < e; ++c) {
+                Cursor cursor{ bounds[c], bounds[c + 1] };
+                for (size_t n = first[c]; n < first[c + 1]; ++n) {
+                    T value;
+                    bool parsed;
+                    if constexpr (std::is_same_v<T, float>) parsed = cursor.getFloat(value);
+                    else parsed = cursor.getInt(value);
+                    // A number must end at whitespace, or its tail would have
+                    // been counted as one more token.
+                    if (!parsed || (cursor.p != cursor.end && !isSpace(*cursor.p))) {
+                        ok = false;
+                        return;
+                    }
+                    store(n / 3, int(n % 3), value);
+                }
+            }
+        });
+        chunks += chunkCount;
+        return ok;
+    }
+
+    // skinweights records ("count (joint weight) * count") vary in length, so
+    // each chunk parses into its own arrays and the records are handed to the
+    // vertices once the chunks are counted. A chunk has to hold whole records:
+    // if a record spans a chunk boundary the section is parsed as one chunk.
+    struct WeightChunk {
+        std::vector<int> counts;
+        std::vector<VertexWeight> weights;
+        bool complete = true;
+    };
+
+    bool parseWeightChunk(const char* begin, const char* end, WeightChunk& chunk) {
+        chunk.counts.clear();
+        chunk.weights.clear();
+        Cursor cursor{ begin, end };
+        while (!cursor.atEnd()) {
+            int count;
+            if (!cursor.getInt(count) || count < 0) return false;
+            chunk.counts.push_back(count);
+            for (int j = 0; j < count; ++j) {
+                int joint;
+                float weight;
+                if (!cursor.getInt(joint) || !cursor.getFloat(weight)) return false;
+                chunk.weights.emplace_back(joint, weight);
+            }
+        }
+        return true;
+    }
+
+    bool parseWeights(const char* begin, const char* end, size_t count, std::vector<SkinVertex>& vertices, size_t& chunks) {
+        std::vector<const char*> bounds = splitLines(begin, end);
+        std::vector<WeightChunk> parsed(bounds.size() - 1);
+        JobSystem& jobs = JobSystem::getInstance();
+        jobs.parallelFor(parsed.size(), 1, [&](size_t b, size_t e) {
+            for (size_t c = b; c < e; ++c) parsed[c].complete = parseWeightChunk(bounds[c], bounds[c + 1], parsed[c]);
+        });
+        if (std::any_of(parsed.begin(), parsed.end(), [](const WeightChunk& chunk) { return !chunk.complete; })) {
+            bounds = { begin, end };
+            parsed.assign(1, WeightChunk());
+            if (!parseWeightChunk(begin, end, parsed[0])) return false;
+        }
+
+        std::vector<size_t> firstVertex(parsed.size() + 1, 0);
+        for (size_t c = 0; c < parsed.size(); ++c) firstVertex[c + 1] = firstVertex[c] + parsed[c].counts.size();
+        if (firstVertex.back() != count || count > vertices.size()) return false;
+
+        jobs.parallelFor(parsed.size(), 1, [&](size_t b, size_t e) {
+            for (size_t c = b; c < e; ++c) {
+                const VertexWeight* weight = parsed[c].weights.data();
+                for (size_t r = 0; r < parsed[c].counts.size(); ++r) {
+                    std::vector<VertexWeight>& target = vertices[firstVertex[c] + r].weights;
+                    target.insert(target.end(), weight, weight + parsed[c].counts[r]);
+                    weight += parsed[c].counts[r];
+                }
+            }
+        });
+        chunks += parsed.size();
+        return true;
+    }
+
+    bool parseBindings(Cursor& cursor, int count, std::vector<glm::mat4>& bindingMats) {
+        for (int i = 0; i < count; ++i) {
+            if (cursor.token() != "matrix" || cursor.token() != "{") return false;
+            glm::mat4 matrix = glm::identity<glm::mat4>();
+            for (int row = 0; row < 4; ++row) {
+                for (int column = 0; column < 3; ++column) {
+                    if (!cursor.getFloat(matrix[row][column])) return false;
+                }
+            }
+            if (cursor.token() != "}") return false;
+            bindingMats.push_back(matrix);
+        }
+        return cursor.token() == "}";
+    }
+}
+
+bool SkinParser::parseSkinFile(const std::string& filename, Skin& skin) {
+    auto begin = std::chrono::steady_clock::now();
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file) {
+        std::cerr << "Error opening skin file: " << filename << std::endl;
+        return false;
+    }
+    std::vector<char> data((size_t)file.tellg());
+    file.seekg(0);
+    if (!file.read(data.data(), data.size())) {
+        std::cerr << "Error reading skin file: " << filename << std::endl;
+        return false;
+    }
+    const double readMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+    const bool parsed = parseSkinBuffer(data.data(), data.size(), skin, filename);
+    stats.readMilliseconds = readMilliseconds;
+    return parsed;
+}
+
+bool SkinParser::parseSkinBuffer(const char* data, size_t size, Skin& skin, const std::string& name) {
+    auto begin = std::chrono::steady_clock::now();
+    stats = Stats();
+    stats.bytes = size;
+    skin.vertices.clear();
+    skin.triangles.clear();
+    skin.bindingMats.clear();
+
+    enum class Kind { Positions, Normals, SkinWeights, Triangles };
+    struct Section {
+        Kind kind;
+        std::string_view keyword;
+        size_t count;
+        const char* begin;
+        const char* end;
+    };
+
+    // Pass 1: section boundaries. The numeric sections hold no braces, so a
+    // section ends at the first '}' after its '{'.
+    std::vector<Section> sections;
+    Cursor cursor{ data, data + size };
+    while (!cursor.atEnd()) {
+        std::string_view keyword = cursor.token();
+        Kind kind;
+        if (keyword == "positions") kind = Kind::Positions;
+        else if (keyword == "normals") kind = Kind::Normals;
+        else if (keyword == "skinweights") kind = Kind::SkinWeights;
+        else if (keyword == "triangles") kind = Kind::Triangles;
+        else if (keyword == "bindings") {
+            int count;
+            if (!cursor.getInt(count) || cursor.token() != "{" || !parseBindings(cursor, count, skin.bindingMats)) {
+                std::cerr << "Error in skin file: " << name << " malformed bindings" << std::endl;
+                return false;
+            }
+            continue;
+        }
+        else {
+            cursor.skipLine();
+            continue;
+        }
+
+        int count;
+        if (!cursor.getInt(count) || count < 0 || cursor.token() != "{") {
+            std::cerr << "Error in skin file: " << name << " " << keyword << " dont have a count and '{'" << std::endl;
+            return false;
+        }
+        const char* close = (const char*)memchr(cursor.p, '}', cursor.end - cursor.p);
+        if (!close) {
+            std::cerr << "Error in skin file: " << name << " " << keyword << " dont have '}'" << std::endl;
+            return false;
+        }
+        sections.push_back(Section{ kind, keyword, (size_t)count, cursor.p, close });
+        cursor.p = close + 1;
+    }
+
+    // Pass 2: each section split across the job system, in file order since
+    // positions sizes the vertex array the others write into.
+    for (const Section& section : sections) {
+        bool parsed = false;
+        std::vector<SkinVertex>& vertices = skin.vertices;
+        switch (section.kind) {
+        case Kind::Positions:
+            vertices.resize(section.count);
+            parsed = parseTriples<float>(section.begin, section.end, section.count, stats.chunks,
+                [&](size_t i, int axis, float value) { vertices[i].position[axis] = value; });
+            break;
+        case Kind::Normals:
+            parsed = section.count <= vertices.size() &&
+                parseTriples<float>(section.begin, section.end, section.count, stats.chunks,
+                    [&](size_t i, int axis, float value) { vertices[i].normal[axis] = value; });
+            break;
+        case Kind::SkinWeights:
+            parsed = parseWeights(section.begin, section.end, section.count, vertices, stats.chunks);
+            break;
+        case Kind::Triangles: {
+            const size_t first = skin.triangles.size();
+            skin.triangles.resize(first + section.count, Triangle(0, 0, 0));
+            Triangle* triangles = skin.triangles.data() + first;
+            parsed = parseTriples<int>(section.begin, section.end, section.count, stats.chunks,
+                [&](size_t i, int corner, int value) {
+                    (corner == 0 ? triangles[i].v0 : corner == 1 ? triangles[i].v1 : triangles[i].v2) = value;
+                });
+            break;
+        }
+        }
+        if (!parsed) {
+            std::cerr << "Error in skin file: " << name << " " << section.keyword << " " << section.count
+                << " is malformed or has the wrong number of values" << std::endl;
+            return false;
+        }
+    }
+
+    stats.parseMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    return true;
+}
@@ -0,0 +1,32 @@
+// SkinParser.h
+#pragma once
+
+#include "Skin.h"
+#include <string>
+
+// Loads .skin files with the same result as Skin::loadFromFile, but reads the
+// whole file into memory, scans it for section boundaries first and then
+// parses the large numeric sections (positions, normals, skinweights,
+// triangles) in parallel: each section is split into chunks at line
+// boundaries and the JobSystem parses the chunks straight into the skin's
+// preallocated arrays. bindings are a handful of matrices and parsed in order.
+class SkinParser {
+public:
+    struct Stats {
+        size_t bytes = 0;
+        size_t chunks = 0;              // parsed in parallel, over all sections
+        double readMilliseconds = 0.0;  // file into memory
+        double parseMilliseconds = 0.0;
+    };
+
+    // Replaces the contents of 'skin'. Returns false, having said why on
+    // stderr, if the file cannot be read or a section is malformed.
+    bool parseSkinFile(const std::string& filename, Skin& skin);
+    // 'data' need not be null-terminated; 'name' is used in error messages.
+    bool parseSkinBuffer(const char* data, size_t size, Skin& skin, const std::string& name);
+
+    const Stats& getStats() const { return stats; }
+
+private:
+    Stats stats;
+};
@@ -0,0 +1,68 @@
+// SpatialHashGrid.cpp
+#include "SpatialHashGrid.h"
+#include "JobSystem.h"
+#include <algorithm>
+
+void SpatialHashGrid::build(const std::vector<glm::vec3>& positions, float newCellSize) {
+    cellSize = newCellSize > 0.0f ? newCellSize : 1.0f;
+    invCellSize = 1.0f / cellSize;
+
+    uint32_t tableSize = 1;
+    while (tableSize < 2 * positions.size()) tableSize <<= 1;
+    tableMask = tableSize - 1;
+
+    const size_t count = positions.size();
+    pointCell.resize(count);
+    entries.resize(count);
+    cellStart.assign(tableSize + 1, 0);
+
+    // Hashing is independent per point.
+    JobSystem::getInstance().parallelFor(count, 4096, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            pointCell[i] = hashCell(cellCoord(positions[i]));
+        }
+    });
+
+    // Counting sort: histogram, exclusive prefix sum, scatter.
+    for (size_t i = 0; i < count; ++i) {
+        cellStart[pointCell[i] + 1]++;
+    }
+    for (uint32_t h = 0; h < tableSize; ++h) {
+        cellStart[h + 1] += cellStart[h];
+    }
+    for (size_t i = 0; i < count; ++i) {
+        entries[cellStart[pointCell[i]]++] = static_cast<uint32_t>(i);
+    }
+    // The scatter advanced each start to the next bucket's start; shift back.
+    for (uint32_t h = tableSize; h > 0; --h) {
+        cellStart[h] = cellStart[h - 1];
+    }
+    cellStart[0] = 0;
+}
+
+void SpatialHashGrid::query(const glm::vec3& boxMin, const glm::vec3& boxMax, std::vector<uint32_t>& out) const {
+    if (cellStart.empty()) return;
+
+    glm::ivec3 lo = cellCoord(boxMin);
+    glm::ivec3 hi = cellCoord(boxMax);
+
+    // Each point lives in exactly one bucket, so visiting every distinct bucket
+    // once is enough to report each point at most once.
+    thread_local std::vector<uint32_t> buckets;
+    buckets.clear();
+    for (int z = lo.z; z <= hi.z; ++z) {
+        for (int y = lo.y; y <= hi.y; ++y) {
+            for (int x = lo.x; x <= hi.x; ++x) {
+                buckets.push_back(hashCell(glm::ivec3(x, y, z)));
+            }
+        }
+    }
+    std::sort(buckets.begin(), buckets.end());
+    buckets.erase(std::unique(buckets.begin(), buckets.end()), buckets.end());
+
+    for (uint32_t h : buckets) {
+        for (uint32_t k = cellStart[h]; k < cellStart[h + 1]; ++k) {
+            out.push_back(entries[k]);
+        }
+    }
+}
@@ -0,0 +1,46 @@
+// SpatialHashGrid.h
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+
+// Uniform grid over an unbounded domain, hashed into a fixed-size table.
+// build() inserts points with a counting sort so each cell's points end up
+// contiguous in 'entries'; cellStart[h]..cellStart[h + 1] is the range for
+// hash bucket h. Everything lives in flat arrays reused between builds, so a
+// rebuild is O(N) with no per-step allocation once the arrays have grown.
+class SpatialHashGrid {
+private:
+    float cellSize;
+    float invCellSize;
+    uint32_t tableMask;
+
+    std::vector<uint32_t> cellStart;  // tableSize + 1 prefix sums
+    std::vector<uint32_t> entries;    // point indices sorted by bucket
+    std::vector<uint32_t> pointCell;  // bucket of each point
+
+public:
+    SpatialHashGrid() : cellSize(1.0f), invCellSize(1.0f), tableMask(0) {}
+
+    // Rebuild from the given positions. The table holds at least 2 * count buckets.
+    void build(const std::vector<glm::vec3>& positions, float newCellSize);
+
+    glm::ivec3 cellCoord(const glm::vec3& p) const {
+        return glm::ivec3(glm::floor(p * invCellSize));
+    }
+
+    uint32_t hashCell(const glm::ivec3& c) const {
+        // Multiplied as unsigned: the products wrap instead of overflowing int.
+        uint32_t h = (uint32_t)c.x * 92837111u ^ (uint32_t)c.y * 689287499u ^ (uint32_t)c.z * 283923481u;
+        return h & tableMask;
+    }
+
+    // Append the indices of all points in cells overlapping [boxMin, boxMax],
+    // each at most once. Other cells can share those buckets, so callers still
+    // need to test candidates against the exact geometry.
+    void query(const glm::vec3& boxMin, const glm::vec3& boxMax, std::vector<uint32_t>& out) const;
+
+    float getCellSize() const { return cellSize; }
+    size_t getTableSize() const { return cellStart.empty() ? 0 : cellStart.size() - 1; }
+};
@@ -0,0 +1,459 @@
+// StreamingClip.cpp
+#include "StreamingClip.h"
+#include "AnimationClip.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+    const char MAGIC[4] = { 'S', 'C', 'L', 'P' };
+    const uint32_t VERSION = 1;
+    const size_t HEADER_SIZE = 4 + 4 + 4 + 4 + 4 + 4 + 8;
+    const size_t INDEX_ENTRY_SIZE = 4 + 4 + 8 + 4 + 4;
+
+    template <typename T>
+    void writeValue(std::ofstream& file, const T& value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    bool readValue(std::ifstream& file, T& value) {
+        return (bool)file.read(reinterpret_cast<char*>(&value), sizeof(T));
+    }
+
+    // The channel's keys over [lo, hi], with cycle and cycle_offset
+    // extrapolation unrolled into repeated keys, as Channel::Evaluate would
+    // wrap the time. Constant extrapolation needs no extra keys.
+    std::vector<StreamKey> unrollKeys(const Channel& channel, float lo, float hi) {
+        std::vector<StreamKey> keys;
+        if (channel.keys.empty()) return keys;
+        const Key& first = channel.keys.front();
+        const Key& last = channel.keys.back();
+        const float period = last.time - first.time;
+        auto cycles = [](const std::string& mode) { return mode == "cycle" || mode == "cycle_offset"; };
+
+        long long firstCycle = 0, lastCycle = 0;
+        if (period > 0.0f && cycles(channel.extrapolateIn) && lo < first.time) {
+            firstCycle = (long long)std::floor((lo - first.time) / period);
+        }
+        if (period > 0.0f && cycles(channel.extrapolateOut) && hi > last.time) {
+            lastCycle = (long long)std::floor((hi - first.time) / period);
+        }
+
+        keys.reserve(channel.keys.size() * (size_t)(lastCycle - firstCycle + 1));
+        for (long long n = firstCycle; n <= lastCycle; ++n) {
+            const std::string& mode = n < 0 ? channel.extrapolateIn : channel.extrapolateOut;
+            float valueOffset = mode == "cycle_offset" ? n * (last.value - first.value) : 0.0f;
+            for (const Key& key : channel.keys) {
+                keys.push_back({ key.time + n * period, key.value + valueOffset, key.inTangent, key.outTangent });
+            }
+            // Channel::Evaluate only wraps times past the last key, so exactly
+            // at the end of the first cycle it holds the last key: the second
+            // cycle starts one ulp later. At later seams the new cycle wins.
+            if (n == 1) keys[keys.size() - channel.keys.size()].time = std::nextafter(last.time, last.time + period);
+        }
+        return keys;
+    }
+
+    // The keys of every segment overlapping [start, end]: from the last key
+    // at or before start to the first key at or after end, including every
+    // key sharing that time (cycle seams repeat a time; the later key wins).
+    void windowKeys(const std::vector<StreamKey>& keys, float start, float end, std::vector<StreamKey>& out) {
+        out.clear();
+        if (keys.empty()) return;
+        auto after = [](float time, const StreamKey& key) { return time < key.time; };
+        auto begin = std::upper_bound(keys.begin(), keys.end(), start, after);
+        if (begin != keys.begin()) --begin;
+        auto finish = std::lower_bound(keys.begin(), keys.end(), end,
+            [](const StreamKey& key, float time) { return key.time < time; });
+        if (finish != keys.end()) finish = std::upper_bound(finish, keys.end(), finish->time, after);
+        out.assign(begin, finish);
+    }
+}
+
+bool StreamingClipWriter::open(const std::string& filePath, size_t channels, float start, float end) {
+    path = filePath;
+    channelCount = (uint32_t)channels;
+    rangeStart = start;
+    rangeEnd = end;
+    entries.clear();
+    channelBegin.assign(channels + 1, 0);
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        fprintf(stderr, "StreamingClipWriter::open - Unable to create file: %s\n", path.c_str());
+        return false;
+    }
+    // Placeholder header; finish() fills in the chunk count and index offset.
+    file.write(std::string(HEADER_SIZE, '\0').data(), HEADER_SIZE);
+    return (bool)file;
+}
+
+bool StreamingClipWriter::addWindow(float start, float end, const std::vector<std::vector<StreamKey>>& channelKeys) {
+    if (channelKeys.size() != channelCount || end <= start || (!entries.empty() && start < entries.back().end)) {
+        fprintf(stderr, "StreamingClipWriter::addWindow - Windows must cover every channel, in time order\n");
+        return false;
+    }
+    ChunkEntry entry;
+    entry.start = start;
+    entry.end = end;
+    entry.offset = (uint64_t)file.tellp();
+    uint32_t keyCount = 0;
+    for (uint32_t c = 0; c < channelCount; ++c) {
+        channelBegin[c] = keyCount;
+        keyCount += (uint32_t)channelKeys[c].size();
+    }
+    channelBegin[channelCount] = keyCount;
+    entry.keyCount = keyCount;
+
+    file.write(reinterpret_cast<const char*>(channelBegin.data()), channelBegin.size() * sizeof(uint32_t));
+    for (const auto& keys : channelKeys) {
+        file.write(reinterpret_cast<const char*>(keys.data()), keys.size() * sizeof(StreamKey));
+    }
+    entries.push_back(entry);
+    return (bool)file;
+}
+
+bool StreamingClipWriter::finish() {
+    uint64_t indexOffset = (uint64_t)file.tellp();
+    const uint32_t reserved = 0;
+    for (const ChunkEntry& entry : entries) {
+        writeValue(file, entry.start);
+        writeValue(file, entry.end);
+        writeValue(file, entry.offset);
+        writeValue(file, entry.keyCount);
+        writeValue(file, reserved);
+    }
+
+    file.seekp(0);
+    file.write(MAGIC, 4);
+    writeValue(file, VERSION);
+    writeValue(file, channelCount);
+    writeValue(file, (uint32_t)entries.size());
+    writeValue(file, rangeStart);
+    writeValue(file, rangeEnd);
+    writeValue(file, indexOffset);
+    file.close();
+    if (!file) {
+        fprintf(stderr, "StreamingClipWriter::finish - Failed writing %s\n", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+StreamingClip::StreamingClip() {}
+
+StreamingClip::~StreamingClip() {
+    close();
+}
+
+bool StreamingClip::open(const std::string& path) {
+    close();
+    file.open(path, std::ios::binary);
+    if (!file) {
+        fprintf(stderr, "StreamingClip::open - Unable to open file: %s\n", path.c_str());
+        return false;
+    }
+
+    char magic[4];
+    uint32_t version = 0;
+    bool ok = (bool)file.read(magic, 4) && readValue(file, version) && readValue(file, channelCount) &&
+        readValue(file, chunkCount) && readValue(file, rangeStart) && readValue(file, rangeEnd) && readValue(file, indexOffset);
+    if (!ok || std::memcmp(magic, MAGIC, 4) != 0 || version != VERSION || chunkCount == 0) {
+        fprintf(stderr, "StreamingClip::open - Not a streaming clip: %s\n", path.c_str());
+        file.close();
+        return false;
+    }
+
+    float end;
+    uint64_t offset;
+    uint32_t keyCount;
+    size_t reads = 0;
+    if (!readIndexEntry(0, spanStart, end, offset, keyCount, reads) ||
+        !readIndexEntry(chunkCount - 1, end, spanEnd, offset, keyCount, reads)) {
+        fprintf(stderr, "StreamingClip::open - Truncated index in %s\n", path.c_str());
+        file.close();
+        return false;
+    }
+
+    stats = Stats();
+    stopping = false;
+    for (Window& window : windows) {
+        window.state = WindowState::Empty;
+        window.chunk = -1;
+        window.channelBegin.assign(channelCount + 1, 0);
+    }
+    ioThread = std::thread(&StreamingClip::ioLoop, this);
+    return true;
+}
+
+void StreamingClip::close() {
+    if (ioThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        changed.notify_all();
+        ioThread.join();
+    }
+    if (file.is_open()) file.close();
+    for (Window& window : windows) {
+        window.state = WindowState::Empty;
+        window.chunk = -1;
+    }
+}
+
+bool StreamingClip::readIndexEntry(uint32_t chunk, float& start, float& end, uint64_t& offset, uint32_t& keyCount, size_t& reads) {
+    ++reads;
+    uint32_t reserved;
+    file.clear();
+    file.seekg((std::streamoff)(indexOffset + (uint64_t)chunk * INDEX_ENTRY_SIZE));
+    return readValue(file, start) && readValue(file, end) && readValue(file, offset) &&
+        readValue(file, keyCount) && readValue(file, reserved);
+}
+
+int StreamingClip::findChunk(float time, size_t& reads) {
+    // Last chunk starting at or before 'time'.
+    uint32_t lo = 0, hi = chunkCount - 1;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo + 1) / 2;
+        float start, end;
+        uint64_t offset;
+        uint32_t keyCount;
+        if (!readIndexEntry(mid, start, end, offset, keyCount, reads)) return -1;
+        if (start <= time) lo = mid;
+        else hi = mid - 1;
+    }
+    return (int)lo;
+}
+
+bool StreamingClip::readChunk(int chunk, Window& window, size_t& reads, size_t& bytes) {
+    uint64_t offset;
+    uint32_t keyCount;
+    if (!readIndexEntry((uint32_t)chunk, window.start, window.end, offset, keyCount, reads)) return false;
+
+    // Buffers only grow to the largest window read, so steady playback does
+    // not allocate.
+    window.keys.resize(keyCount);
+    file.clear();
+    file.seekg((std::streamoff)offset);
+    if (!file.read(reinterpret_cast<char*>(window.channelBegin.data()), window.channelBegin.size() * sizeof(uint32_t)) ||
+        !file.read(reinterpret_cast<char*>(window.keys.data()), (std::streamsize)keyCount * sizeof(StreamKey))) {
+        return false;
+    }
+    for (uint32_t c = 0; c < channelCount; ++c) {
+        if (window.channelBegin[c] > window.channelBegin[c + 1]) return false;
+    }
+    bytes += window.channelBegin.size() * sizeof(uint32_t) + keyCount * sizeof(StreamKey);
+    return window.channelBegin[channelCount] == keyCount;
+}
+
+void StreamingClip::ioLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        Window* next = nullptr;
+        changed.wait(lock, [&]() {
+            if (stopping) return true;
+            for (Window& window : windows) {
+                if (window.state == WindowState::Requested) {
+                    next = &window;
+                    return true;
+                }
+            }
+            return false;
+        });
+        if (stopping) return;
+
+        next->state = WindowState::Loading;
+        int chunk = next->chunk;
+        float time = next->requestTime;
+        lock.unlock();
+
+        auto begin = std::chrono::steady_clock::now();
+        size_t reads = 0, bytes = 0;
+        if (chunk < 0) chunk = findChunk(time, reads);
+        bool ok = chunk >= 0 && readChunk(chunk, *next, reads, bytes);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        lock.lock();
+        next->chunk = chunk;
+        next->state = ok ? WindowState::Ready : WindowState::Failed;
+        ++stats.chunksLoaded;
+        stats.indexReads += reads;
+        stats.bytesRead += bytes;
+        stats.loadSeconds += seconds;
+        changed.notify_all();
+    }
+}
+
+int StreamingClip::findResident(float time) const {
+    for (int i = 0; i < WINDOW_COUNT; ++i) {
+        const Window& window = windows[i];
+        if (window.state != WindowState::Ready) continue;
+        bool lastChunk = window.chunk == (int)chunkCount - 1;
+        if (time >= window.start && (time < window.end || (lastChunk && time <= window.end))) return i;
+    }
+    return -1;
+}
+
+bool StreamingClip::isInFlight(const Window& window) const {
+    return window.state == WindowState::Requested || window.state == WindowState::Loading;
+}
+
+bool StreamingClip::hasChunk(int chunk) const {
+    for (const Window& window : windows) {
+        if (window.chunk == chunk && (isInFlight(window) || window.state == WindowState::Ready)) return true;
+    }
+    return false;
+}
+
+int StreamingClip::pickVictim(int keep) const {
+    // An unused window first, then the loaded window furthest from the one playing.
+    int victim = -1;
+    int distance = -1;
+    for (int i = 0; i < WINDOW_COUNT; ++i) {
+        const Window& window = windows[i];
+        if (i == keep || isInFlight(window)) continue;
+        if (window.state != WindowState::Ready) return i;
+        int d = keep < 0 ? 0 : std::abs(window.chunk - windows[keep].chunk);
+        if (d > distance) {
+            distance = d;
+            victim = i;
+        }
+    }
+    return victim;
+}
+
+void StreamingClip::request(int window, int chunk, float time) {
+    windows[window].state = WindowState::Requested;
+    windows[window].chunk = chunk;
+    windows[window].requestTime = time;
+    changed.notify_all();
+}
+
+const StreamingClip::Window* StreamingClip::acquireWindow(float time) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!ioThread.joinable()) return nullptr;
+
+    int found = findResident(time);
+    if (found < 0) {
+        // Let loads in flight land (the next window may be one of them), then seek.
+        ++stats.stalls;
+        changed.wait(lock, [&]() {
+            for (const Window& window : windows) {
+                if (isInFlight(window)) return false;
+            }
+            return true;
+        });
+        found = findResident(time);
+        if (found < 0) {
+            int victim = pickVictim(-1);
+            request(victim, -1, time);
+            changed.wait(lock, [&]() { return !isInFlight(windows[victim]); });
+            found = findResident(time);
+            if (found < 0) return nullptr;
+        }
+    }
+
+    // Prefetch the window after this one while it plays.
+    int nextChunk = windows[found].chunk + 1;
+    if (nextChunk < (int)chunkCount && !hasChunk(nextChunk)) {
+        int victim = pickVictim(found);
+        if (victim >= 0) request(victim, nextChunk, 0.0f);
+    }
+    return &windows[found];
+}
+
+float StreamingClip::sampleChannel(const Window& window, size_t channel, float time) {
+    const StreamKey* first = window.keys.data() + window.channelBegin[channel];
+    const StreamKey* last = window.keys.data() + window.channelBegin[channel + 1];
+    if (first == last) return 0.0f;
+    const StreamKey* next = std::upper_bound(first, last, time,
+        [](float t, const StreamKey& key) { return t < key.time; });
+    if (next == first) return first->value;
+    if (next == last) return (last - 1)->value;
+
+    // Cubic Hermite, as in Channel::Evaluate.
+    const StreamKey& k0 = *(next - 1);
+    const StreamKey& k1 = *next;
+    float dt = k1.time - k0.time;
+    if (dt <= 0.0f) return k0.value;
+    float s = (time - k0.time) / dt;
+    float h00 = 2 * s * s * s - 3 * s * s + 1;
+    float h10 = s * s * s - 2 * s * s + s;
+    float h01 = -2 * s * s * s + 3 * s * s;
+    float h11 = s * s * s - s * s;
+    return h00 * k0.value + h10 * dt * k0.outTangent + h01 * k1.value + h11 * dt * k1.inTangent;
+}
+
+bool StreamingClip::Evaluate(float time, AnimationPose& pose) {
+    const size_t channelsPerJoint = 3;
+    if (channelCount != (pose.rotations.size() + 1) * channelsPerJoint) return false;
+    time = std::clamp(time * 2, spanStart, spanEnd);
+    const Window* window = acquireWindow(time);
+    if (!window) return false;
+
+    pose.rootTranslation = glm::vec3(sampleChannel(*window, 0, time), sampleChannel(*window, 1, time), sampleChannel(*window, 2, time));
+    for (size_t j = 0; j < pose.rotations.size(); j++) {
+        size_t baseChannel = (j + 1) * channelsPerJoint;
+        glm::vec3 angles(sampleChannel(*window, baseChannel, time), sampleChannel(*window, baseChannel + 1, time),
+            sampleChannel(*window, baseChannel + 2, time));
+        pose.rotations[j] = glm::quat(angles);
+    }
+    return true;
+}
+
+bool StreamingClip::Evaluate(float time, std::vector<std::shared_ptr<Joint>>& joints) {
+    const size_t channelsPerJoint = 3;
+    if (joints.empty() || channelCount != (joints.size() + 1) * channelsPerJoint) return false;
+    time = std::clamp(time * 2, spanStart, spanEnd);
+    const Window* window = acquireWindow(time);
+    if (!window) return false;
+
+    joints[0]->offset = joints[0]->originOffset +
+        glm::vec3(sampleChannel(*window, 0, time), sampleChannel(*window, 1, time), sampleChannel(*window, 2, time));
+    for (size_t j = 0; j < joints.size(); j++) {
+        size_t baseChannel = (j + 1) * channelsPerJoint;
+        joints[j]->pose = glm::vec3(sampleChannel(*window, baseChannel, time), sampleChannel(*window, baseChannel + 1, time),
+            sampleChannel(*window, baseChannel + 2, time));
+        joints[j]->clampPose();
+    }
+    return true;
+}
+
+StreamingClip::Stats StreamingClip::getStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+size_t StreamingClip::getResidentBytes() {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t bytes = 0;
+    for (const Window& window : windows) {
+        bytes += window.keys.capacity() * sizeof(StreamKey) + window.channelBegin.capacity() * sizeof(uint32_t);
+    }
+    return bytes;
+}
+
+bool StreamingClip::convert(const AnimationClip& clip, const std::string& path, float windowSeconds) {
+    if (clip.channels.empty() || windowSeconds <= 0.0f) return false;
+    // Channel time runs at twice clip time (see AnimationClip::Evaluate).
+    const float lo = clip.rangeStart * 2, hi = clip.rangeEnd * 2;
+    const float window = windowSeconds * 2;
+
+    std::vector<std::vector<StreamKey>> channelKeys(clip.channels.size());
+    for (size_t c = 0; c < clip.channels.size(); ++c) channelKeys[c] = unrollKeys(clip.channels[c], lo, hi);
+
+    StreamingClipWriter writer;
+    if (!writer.open(path, clip.channels.size(), clip.rangeStart, clip.rangeEnd)) return false;
+    std::vector<std::vector<StreamKey>> windowChannelKeys(clip.channels.size());
+    const int windowCount = std::max(1, (int)std::ceil((hi - lo) / window));
+    for (int w = 0; w < windowCount; ++w) {
+        float start = lo + w * window;
+        float end = w + 1 == windowCount ? std::max(hi, start + window) : lo + (w + 1) * window;
+        for (size_t c = 0; c < clip.channels.size(); ++c) windowKeys(channelKeys[c], start, end, windowChannelKeys[c]);
+        if (!writer.addWindow(start, end, windowChannelKeys)) return false;
+    }
+    return writer.finish();
+}
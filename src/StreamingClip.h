@@ -0,0 +1,140 @@
+// StreamingClip.h
+#pragma once
+
+#include "AnimationPose.h"
+#include "Skeleton.h"
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class AnimationClip;
+
+// A key as stored in a streaming clip, tangents already computed.
+struct StreamKey {
+    float time;
+    float value;
+    float inTangent;
+    float outTangent;
+};
+
+// Seekable binary clip layout (.sclip), native (little) endian:
+//
+//   header   "SCLP", version, channel count, chunk count, range start and
+//            end (clip time, as AnimationClip::rangeStart/rangeEnd), index offset
+//   chunks   per chunk: the first key of every channel plus the end (uint32),
+//            then the keys
+//   index    per chunk: window start and end (channel time), file offset and
+//            key count; fixed size and sorted, so it is binary searched on disk
+//
+// A chunk covers a window of time and holds, for every channel, the keys of
+// each segment overlapping the window, so it can be evaluated on its own.
+// Written front to back: only the index entries are kept until finish().
+class StreamingClipWriter {
+private:
+    struct ChunkEntry {
+        float start, end;
+        uint64_t offset;
+        uint32_t keyCount;
+    };
+
+    std::ofstream file;
+    std::string path;
+    uint32_t channelCount = 0;
+    float rangeStart = 0.0f, rangeEnd = 0.0f;
+    std::vector<ChunkEntry> entries;
+    std::vector<uint32_t> channelBegin;
+
+public:
+    bool open(const std::string& path, size_t channelCount, float rangeStart, float rangeEnd);
+    // Windows are added in time order; channelKeys[c] are the keys of
+    // channel c overlapping [start, end), sorted by time.
+    bool addWindow(float start, float end, const std::vector<std::vector<StreamKey>>& channelKeys);
+    bool finish();
+};
+
+// Plays a .sclip clip without loading it: a background I/O thread reads the
+// window after the one playing, and only WINDOW_COUNT windows are ever
+// resident, so memory depends on the window length and key density, not on
+// the length of the clip. Jumping elsewhere (a seek) finds the window by
+// binary search over the on-disk index, O(log chunks) reads, and waits for
+// it to load. Channels outside their keys hold the first or last value;
+// cycles are unrolled into the file by convert(). One thread plays a clip.
+class StreamingClip {
+public:
+    static const int WINDOW_COUNT = 3;  // playing, prefetched, and one for seeks
+
+    struct Stats {
+        size_t chunksLoaded = 0;
+        size_t stalls = 0;      // evaluations that waited for a window
+        size_t indexReads = 0;  // index entries read to find windows
+        size_t bytesRead = 0;
+        double loadSeconds = 0.0;  // I/O thread time spent loading chunks
+    };
+
+    StreamingClip();
+    ~StreamingClip();
+
+    bool open(const std::string& path);
+    void close();
+
+    // Same sampling and time convention as AnimationClip::Evaluate. Time is
+    // clamped to the clip range. Returns false if the window could not be read.
+    bool Evaluate(float time, AnimationPose& pose);
+    bool Evaluate(float time, std::vector<std::shared_ptr<Joint>>& joints);
+
+    float getRangeStart() const { return rangeStart; }
+    float getRangeEnd() const { return rangeEnd; }
+    size_t getChannelCount() const { return channelCount; }
+    size_t getChunkCount() const { return chunkCount; }
+    Stats getStats();
+    // Bytes held by the window buffers.
+    size_t getResidentBytes();
+
+    // Write 'clip' as a streaming clip with windows of 'windowSeconds' of clip time.
+    static bool convert(const AnimationClip& clip, const std::string& path, float windowSeconds = 1.0f);
+
+private:
+    enum class WindowState { Empty, Requested, Loading, Ready, Failed };
+
+    struct Window {
+        WindowState state = WindowState::Empty;
+        int chunk = -1;              // -1 while a seek is finding it
+        float requestTime = 0.0f;    // for seeks
+        float start = 0.0f, end = 0.0f;
+        std::vector<uint32_t> channelBegin;
+        std::vector<StreamKey> keys;
+    };
+
+    std::ifstream file;  // read by the I/O thread once open() returns
+    uint32_t channelCount = 0;
+    uint32_t chunkCount = 0;
+    uint64_t indexOffset = 0;
+    float rangeStart = 0.0f, rangeEnd = 0.0f;
+    float spanStart = 0.0f, spanEnd = 0.0f;  // channel time covered by the chunks
+
+    Window windows[WINDOW_COUNT];
+    Stats stats;
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::thread ioThread;
+    bool stopping = false;
+
+    void ioLoop();
+    bool readIndexEntry(uint32_t chunk, float& start, float& end, uint64_t& offset, uint32_t& keyCount, size_t& reads);
+    int findChunk(float time, size_t& reads);
+    bool readChunk(int chunk, Window& window, size_t& reads, size_t& bytes);
+
+    // Called with the mutex held.
+    int findResident(float time) const;
+    bool isInFlight(const Window& window) const;
+    bool hasChunk(int chunk) const;
+    int pickVictim(int keep) const;
+    void request(int window, int chunk, float time);
+
+    const Window* acquireWindow(float time);
+    static float sampleChannel(const Window& window, size_t channel, float time);
+};
@@ -32,7 +32,7 @@ public:
 struct GPUSkinVertex {
     glm::vec3 position;
     glm::vec3 normal;
-    uint8_t jointIndices[4]; // 4ؽ0-150
+    uint16_t jointIndices[4]; // 16-bit joint indices, 0xFFFF marks an unused slot
     uint8_t weights[3];      // 3Ȩأ0-150Ӧ0.0-1.0
     uint8_t validWeights;    // ʵЧȨ
 
@@ -41,14 +41,14 @@ struct GPUSkinVertex {
         normal = src.normal;
         validWeights = 0;
 
-        std::fill_n(jointIndices, 4, 0xFF); // 0xFFʾЧ
+        std::fill_n(jointIndices, 4, 0xFFFF);
         std::fill_n(weights, 3, 0);
 
         const int maxWeights = std::min(4, (int)src.weights.size());
         validWeights = maxWeights;
 
         for (int i = 0; i < maxWeights; ++i) {
-            jointIndices[i] = static_cast<uint8_t>(src.weights[i].jointIndex);
+            jointIndices[i] = static_cast<uint16_t>(src.weights[i].jointIndex);
             if (i < 3) { 
                 weights[i] = static_cast<uint8_t>(src.weights[i].weight * 255.0f);
             }
@@ -11,6 +11,20 @@ std::unique_ptr<Cube> Window::cube = nullptr;
 std::unique_ptr<SkeletonManager> Window::skeletonManager = nullptr;
 std::unique_ptr<ClothManager> Window::clothManager = nullptr;
 
+std::unique_ptr<AssetLoader> Window::assetLoader = nullptr;
+std::future<std::unique_ptr<Skeleton>> Window::pendingSkeleton;
+std::future<std::unique_ptr<Skin>> Window::pendingSkin;
+std::future<std::unique_ptr<AnimationClip>> Window::pendingAnim;
+
+std::unique_ptr<HotReloader> Window::hotReloader = nullptr;
+
+namespace {
+    void watchForReload(const std::string& path, HotReloader::AssetType type) {
+        if (!Window::hotReloader) Window::hotReloader = std::make_unique<HotReloader>();
+        Window::hotReloader->watch(path, type);
+    }
+}
+
 
 // Camera Properties
 Camera* Cam;
@@ -25,7 +39,9 @@ GLuint Window::shaderProgram;
 // Constructors and desctructors
 bool Window::initializeProgram() {
     // Create a shader program with a vertex shader and a fragment shader.
-    shaderProgram = LoadShaders("shaders/shader.vert", "shaders/shader.frag");
+    // Variants are compiled lazily; only the base permutation is built here.
+    ShaderLibrary::getInstance().initialize("shaders/shader.vert", "shaders/shader.frag");
+    shaderProgram = ShaderLibrary::getInstance().getProgram(ShaderPermutation());
 
     // Check the shader program.
     if (!shaderProgram) {
@@ -51,75 +67,146 @@ bool Window::initializeImGui(GLFWwindow* window) {
     return true;
 }
 
-bool Window::initializeSkeletonSystem(std::string skel_file) {
-    skeletonManager = std::make_unique<SkeletonManager>();
-    if (!skeletonManager.get()->initializeSkeleton(skel_file)) {
-        return false;
+void Window::beginLoadingAssets(const std::string& skel_file, const std::string& skin_file, const std::string& anim_file) {
+    assetLoader = std::make_unique<AssetLoader>();
+    pendingSkeleton = assetLoader->loadSkeleton(resourcePath + skel_file);
+    if (!skin_file.empty()) pendingSkin = assetLoader->loadSkin(resourcePath + skin_file);
+    // Streaming clips are opened, not parsed; SkeletonManager does that.
+    if (!anim_file.empty() && anim_file.find(".sclip") == std::string::npos) {
+        pendingAnim = assetLoader->loadAnimation(resourcePath + anim_file);
     }
-    if (skeletonManager) {
-        ImGuiController::getInstance().bindSkeletonManager(skeletonManager.get());
-        std::cout << "Bind skeletonManager to Imgui success!" << std::endl;
-    }
-    skeletonManager.get()->bindCamera(Cam);
-    skeletonManager->initializeRenderer();
+}
 
-    return true;
+bool Window::initializeSkeletonSystem(std::string skel_file) {
+    return initializeSkeletonSystem(skel_file, "", "");
 }
 
 bool Window::initializeSkeletonSystem(std::string skel_file, std::string skin_file, std::string anim_file) {
+    if (!assetLoader) beginLoadingAssets(skel_file, skin_file, anim_file);
+
     skeletonManager = std::make_unique<SkeletonManager>();
-    if (!skeletonManager.get()->initializeSkeleton(skel_file)) {
+    std::unique_ptr<Skeleton> skeleton = pendingSkeleton.get();
+    if (!skeleton) {
+        std::cerr << "Failed to parse skeleton file: " << skel_file << std::endl;
         return false;
     }
-    if (!skin_file.empty()) {
-        if (!skeletonManager->initializeSkin(skin_file)) {
+    skeletonManager->setSkeleton(*skeleton);
+    watchForReload(resourcePath + skel_file, HotReloader::AssetType::Skeleton);
+
+    if (pendingSkin.valid()) {
+        std::unique_ptr<Skin> skin = pendingSkin.get();
+        if (!skin) {
+            std::cerr << "Failed to load skin file: " << skin_file << std::endl;
             return false;
         }
+        skeletonManager->setSkin(std::move(skin));
+        watchForReload(resourcePath + skin_file, HotReloader::AssetType::Skin);
     }
     else {
         std::cout << "Not providing skin file, skip skin file loading." << std::endl;
     }
 
-    if (!anim_file.empty()) {
+    if (pendingAnim.valid()) {
+        std::unique_ptr<AnimationClip> clip = pendingAnim.get();
+        if (clip) skeletonManager->setAnimation(std::move(clip));
+        else std::cerr << "Failed to load animation clip" << std::endl;
+        watchForReload(resourcePath + anim_file, HotReloader::AssetType::Animation);
+    }
+    else if (!anim_file.empty()) {
         skeletonManager->initializeAnim(anim_file);
-
     }
 
+    std::cout << "Skeleton assets:" << std::endl;
+    assetLoader->printReport();
+    assetLoader.reset();
 
     if (skeletonManager) {
         ImGuiController::getInstance().bindSkeletonManager(skeletonManager.get());
         std::cout << "Bind skeletonManager to Imgui success!" << std::endl;
     }
+    // GL objects are created here, on the main thread.
     skeletonManager.get()->bindCamera(Cam);
     skeletonManager->initializeRenderer();
     return true;
 }
 
-bool Window::initializeClothSystem() {
+bool Window::initializeClothSystem(const std::string& meshFile, const std::vector<int>& pinned) {
     clothManager = std::make_unique<ClothManager>();
+    clothManager->meshFile = meshFile;
+    clothManager->meshPinned = pinned;
     if (!clothManager->initializeCloth()) {
         std::cerr << "Failed to initialize ClothManager!" << std::endl;
         return false;
     }
+    if (!meshFile.empty()) watchForReload(meshFile, HotReloader::AssetType::ClothMesh);
     if (clothManager) {
         if( ImGuiController::getInstance().bindClothManager(clothManager.get()) ) 
             std::cout << "Bind clothManager to Imgui success!" << std::endl;
         clothManager->bindCamera(Cam);
         std::cout << "ClothManager initialized successfully." << std::endl;
     }
+    if (skeletonManager) {
+        clothManager->attachJointColliders(skeletonManager->getSkeleton());
+        std::cout << "Cloth collides with the joint primitives." << std::endl;
+    }
+    if (skeletonManager && skeletonManager->getRenderer()->getSkin()) {
+        clothManager->attachSkinCollider(skeletonManager->getRenderer());
+        std::cout << "Cloth collides with the skinned mesh." << std::endl;
+    }
     return true;
 }
 
 void Window::cleanUp() {
+    hotReloader.reset();
+
     // Deallcoate the objects.
     if(skeletonManager)
         skeletonManager->cleanUp();
+    JointPalette::getInstance().cleanup();
 
-    // Delete the shader program.
-    glDeleteProgram(shaderProgram);
+    // Delete the shader programs.
+    ShaderLibrary::getInstance().cleanup();
 
 }
 
+bool Window::startHotReload() {
+    watchForReload("shaders/shader.vert", HotReloader::AssetType::Shader);
+    watchForReload("shaders/shader.frag", HotReloader::AssetType::Shader);
+    if (!hotReloader->start()) return false;
+    std::cout << "Hot reload: watching assets and shaders ("
+        << (hotReloader->isUsingInotify() ? "inotify" : "polling") << ")" << std::endl;
+    return true;
+}
+
+void Window::applyHotReloads() {
+    if (!hotReloader) return;
+
+    // Parsing happened in the background; only the swap and the GL work
+    // (renderer buffers, shader compiles) happen here, between frames.
+    for (HotReloader::Reload& reload : hotReloader->poll()) {
+        auto begin = std::chrono::steady_clock::now();
+        switch (reload.type) {
+        case HotReloader::AssetType::Skeleton:
+            if (skeletonManager) skeletonManager->reloadSkeleton(*reload.skeleton);
+            break;
+        case HotReloader::AssetType::Skin:
+            if (skeletonManager) skeletonManager->reloadSkin(std::move(reload.skin));
+            break;
+        case HotReloader::AssetType::Animation:
+            if (skeletonManager) skeletonManager->reloadAnimation(std::move(reload.clip));
+            break;
+        case HotReloader::AssetType::ClothMesh:
+            if (clothManager) clothManager->reloadMesh(reload.path, *reload.skin);
+            break;
+        case HotReloader::AssetType::Shader:
+            if (GLuint program = ShaderLibrary::getInstance().reload()) shaderProgram = program;
+            break;
+        }
+        printf("Reloaded %s (parsed in %.1f ms, swapped in %.1f ms)\n", reload.path.c_str(), reload.milliseconds,
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count());
+    }
+}
+
 // for the Window
 GLFWwindow* Window::createWindow(int width, int height) {
     // Initialize GLFW.
@@ -180,6 +267,9 @@ void Window::idleCallback() {
     // Perform any updates as necessary.
     Cam->Update();
 
+    // Swap in assets and shaders edited on disk.
+    applyHotReloads();
+
     if (skeletonManager) {
         skeletonManager->Update();
     }
@@ -188,6 +278,7 @@ void Window::idleCallback() {
 void Window::displayCallback(GLFWwindow* window) {
     // Clear the color and depth buffers.
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    FrameStats::getInstance().beginFrame();
 
     ImGuiController::getInstance().beginFrame();
     //ImGuiController::getInstance().renderSkeletonRendererUI();
@@ -211,10 +302,10 @@ void Window::displayCallback(GLFWwindow* window) {
 
 }
 
-// Fixed update for physical engine;
+// Physics update, once per frame with the frame time.
 void Window::fixedCallback(float dt) {
     if (clothManager) {
-        clothManager->Update(dt); // Now Update() accepts dt
+        clothManager->Update(dt); // substeps chosen by the cloth step controller
     }
 }
 